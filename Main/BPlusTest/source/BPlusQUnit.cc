@@ -6,15 +6,21 @@
 #include "MyDB_BufferManager.h"
 #include "MyDB_Catalog.h"  
 #include "MyDB_Page.h"
+#include "MyDB_PageLayout.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_Record.h"
 #include "MyDB_Table.h"
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_BPlusTreeReaderWriter.h"
+#include "MyDB_KeyArrayNode.h"
 #include "MyDB_Schema.h"
 #include "QUnit.h"
 #include "Sorting.h"
+#include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <random>
+#include <thread>
 
 #define FALLTHROUGH_INTENDED do {} while (0)
 
@@ -364,6 +370,778 @@ int main (int argc, char *argv[]) {
 			cout << "\tTEST FAILED\n";
 		QUNIT_IS_TRUE (allOK);
 	}
+	FALLTHROUGH_INTENDED;
+	case 11:
+	{
+		cout << "TEST 11... bulk loading a tree on suppkey from sorted runs " << flush;
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+		MyDB_TablePtr unsortedTable = make_shared <MyDB_Table> ("supplierUnsorted", "supplierUnsorted.bin", mySchema);
+		MyDB_TableReaderWriter loadMe (unsortedTable, myMgr);
+		loadMe.loadFromTextFile ("supplier.tbl");
+
+		// build one tree a record at a time (splitting pages in half, even though the records are
+		// sorted), and one in bulk
+		MyDB_BPlusTreeReaderWriter appendedTree ("suppkey", myTable, myMgr);
+		appendedTree.setFillFactor (0.5);
+		appendedTree.loadFromTextFile ("supplier.tbl");
+		MyDB_TablePtr bulkTable = make_shared <MyDB_Table> ("supplierBulk", "supplierBulk.bin", mySchema);
+		MyDB_BPlusTreeReaderWriter bulkTree ("suppkey", bulkTable, myMgr);
+		MyDB_SortKeyPtr sortKey = make_shared <MyDB_SortKey> (mySchema, vector <string> {"suppkey"});
+		bulkTree.bulkLoad (buildItertorOverSortedRuns (16, loadMe, sortKey));
+		bool res = (bulkTree.getNumPages () < appendedTree.getNumPages () * 3 / 4);
+
+		// all of the records come back in order
+		MyDB_RecordPtr temp = bulkTree.getEmptyRecord ();
+		MyDB_IntAttValPtr low = make_shared <MyDB_IntAttVal> ();
+		low->set (1);
+		MyDB_IntAttValPtr high = make_shared <MyDB_IntAttVal> ();
+		high->set (10000);
+		MyDB_RecordIteratorAltPtr myIter = bulkTree.getSortedRangeIteratorAlt (low, high);
+		int counter = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			if (++counter != temp->getAtt (0)->toInt ())
+				res = false;
+		}
+		res = res && (counter == 10000);
+
+		// with room left on each page, records can still be appended
+		bulkTree.bulkLoad (buildItertorOverSortedRuns (16, loadMe, sortKey), 0.7);
+		for (int i = 10001; i <= 10500; i++) {
+			temp->fromString (to_string (i) + "|Supplier#" + to_string (i) + "|addr|3|phone|1.5|comment|");
+			bulkTree.append (temp);
+		}
+		for (int i = 1; i < 101; i++) {
+			low->set (i * 105);
+			high->set (i * 105);
+			myIter = bulkTree.getSortedRangeIteratorAlt (low, high);
+			counter = 0;
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				if (temp->getAtt (0)->toInt () != i * 105)
+					res = false;
+				counter++;
+			}
+			if (counter != 1)
+				res = false;
+		}
+		if (res)
+			cout << "\tTEST PASSED\n";
+		else
+			cout << "\tTEST FAILED\n";
+		QUNIT_IS_TRUE (res);
+	}
+	FALLTHROUGH_INTENDED;
+	case 12:
+	{
+		cout << "TEST 12... appending in random order, checking that every node stays sorted " << flush;
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+		MyDB_BPlusTreeReaderWriter supplierTable ("suppkey", myTable, myMgr);
+		supplierTable.clear ();
+		vector <int> keys;
+		for (int i = 1; i <= 5000; i++)
+			keys.push_back (i);
+		srand48 (12);
+		for (int i = keys.size () - 1; i > 0; i--)
+			swap (keys[i], keys[lrand48 () % (i + 1)]);
+		MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+		for (int key : keys) {
+			temp->fromString (to_string (key) + "|Supplier#" + to_string (key) + "|addr|3|phone|1.5|comment|");
+			supplierTable.append (temp);
+		}
+
+		// the keys on each page are in order, on the leaves and on the internal nodes (which, for an int
+		// key, are arrays of keys)
+		bool res = true;
+		for (int i = 0; i < supplierTable.getNumPages (); i++) {
+			MyDB_PageReaderWriter page = supplierTable[i];
+			int lastKey = INT_MIN;
+			for (size_t j = 0; j < page.getNumRecords (); j++) {
+				int key;
+				if (page.getType () == MyDB_PageType :: DirectoryPage) {
+					key = getNodeKeys <int> (page.getBytes ())[j];
+				} else {
+					page.getRecord (j, temp);
+					key = temp->getAtt (0)->toInt ();
+				}
+				if (key < lastKey)
+					res = false;
+				lastKey = key;
+			}
+		}
+
+		// and range queries come back in order
+		MyDB_IntAttValPtr low = make_shared <MyDB_IntAttVal> ();
+		low->set (1000);
+		MyDB_IntAttValPtr high = make_shared <MyDB_IntAttVal> ();
+		high->set (3999);
+		MyDB_RecordIteratorAltPtr myIter = supplierTable.getSortedRangeIteratorAlt (low, high);
+		int counter = 1000;
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			if (temp->getAtt (0)->toInt () != counter++)
+				res = false;
+		}
+		res = res && (counter == 4000);
+		if (res)
+			cout << "\tTEST PASSED\n";
+		else
+			cout << "\tTEST FAILED\n";
+		QUNIT_IS_TRUE (res);
+	}
+	FALLTHROUGH_INTENDED;
+	case 13:
+	{
+		cout << "TEST 13... walking the linked leaves of a tree, and streaming range queries over them " << flush;
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+		MyDB_BPlusTreeReaderWriter supplierTable ("suppkey", myTable, myMgr);
+		supplierTable.clear ();
+
+		// a range query over an empty tree has nothing in it
+		MyDB_IntAttValPtr low = make_shared <MyDB_IntAttVal> ();
+		MyDB_IntAttValPtr high = make_shared <MyDB_IntAttVal> ();
+		low->set (1);
+		high->set (100);
+		bool res = !supplierTable.getRangeIteratorAlt (low, high)->advance ();
+
+		vector <int> keys;
+		for (int i = 1; i <= 4000; i++)
+			keys.push_back (i);
+		srand48 (13);
+		for (int i = keys.size () - 1; i > 0; i--)
+			swap (keys[i], keys[lrand48 () % (i + 1)]);
+		MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+		for (int key : keys) {
+			temp->fromString (to_string (key) + "|Supplier#" + to_string (key) + "|addr|3|phone|1.5|comment|");
+			supplierTable.append (temp);
+		}
+
+		// find the leftmost leaf by going down the first entry of each internal node, and walk the leaves
+		// from there; every record should be seen, in order, and each leaf's previous link should point
+		// back to the leaf before it
+		int leftmost = supplierTable.getTable ()->getRootLocation ();
+		while (supplierTable[leftmost].getType () == MyDB_PageType :: DirectoryPage)
+			leftmost = getNodeChildren <int> (supplierTable[leftmost].getBytes (), 1024)[0];
+		int counter = 1, prev = -1;
+		for (int i = leftmost; i != -1; i = supplierTable[i].getNextPage ()) {
+			MyDB_PageReaderWriter page = supplierTable[i];
+			if (page.getPrevPage () != prev)
+				res = false;
+			for (size_t j = 0; j < page.getNumRecords (); j++) {
+				page.getRecord (j, temp);
+				if (temp->getAtt (0)->toInt () != counter++)
+					res = false;
+			}
+			prev = i;
+		}
+		res = res && (counter == 4001);
+
+		// ranges that start and end in the middle of leaves, that go past the ends of the data, and
+		// that have nothing in them
+		int ranges[][3] = {{1, 4000, 4000}, {-10, 10, 10}, {1234, 2345, 1112}, {3990, 5000, 11}, {700, 700, 1},
+			{4001, 5000, 0}, {-10, 0, 0}, {20, 10, 0}};
+		for (auto &range : ranges) {
+			low->set (range[0]);
+			high->set (range[1]);
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getRangeIteratorAlt (low, high);
+			int count = 0;
+			int expected = max (range[0], 1);
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				if (temp->getAtt (0)->toInt () != expected++)
+					res = false;
+				count++;
+			}
+			res = res && (count == range[2]) && !myIter->advance ();
+		}
+		if (res)
+			cout << "\tTEST PASSED\n";
+		else
+			cout << "\tTEST FAILED\n";
+		QUNIT_IS_TRUE (res);
+	}
+	FALLTHROUGH_INTENDED;
+	case 14:
+	{
+		cout << "TEST 14... point lookups, with every key there three times " << flush;
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+		MyDB_BPlusTreeReaderWriter supplierTable ("suppkey", myTable, myMgr);
+		supplierTable.clear ();
+
+		// nothing is in an empty tree
+		MyDB_IntAttValPtr key = make_shared <MyDB_IntAttVal> ();
+		key->set (10);
+		bool res = !supplierTable.contains (key);
+
+		// the even keys from 2 to 4000; the copies of a key go to different leaves as the tree grows
+		vector <int> keys;
+		for (int i = 1; i <= 2000; i++)
+			for (int j = 0; j < 3; j++)
+				keys.push_back (i * 2);
+		srand48 (14);
+		for (int i = keys.size () - 1; i > 0; i--)
+			swap (keys[i], keys[lrand48 () % (i + 1)]);
+		MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+		for (int k : keys) {
+			temp->fromString (to_string (k) + "|Supplier#" + to_string (k) + "|addr|3|phone|1.5|comment|");
+			supplierTable.append (temp);
+		}
+
+		for (int i = -5; i <= 4005; i++) {
+			key->set (i);
+			bool there = (i >= 2 && i <= 4000 && i % 2 == 0);
+			if (supplierTable.contains (key) != there)
+				res = false;
+			if (there && (!supplierTable.lookup (key, temp) || temp->getAtt (0)->toInt () != i ||
+				temp->getAtt (1)->toString () != "Supplier#" + to_string (i)))
+				res = false;
+		}
+
+		// and all of the copies of a key can be found with a range query
+		for (int i = 2; i <= 4000; i += 398) {
+			key->set (i);
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getRangeIteratorAlt (key, key);
+			int count = 0;
+			while (myIter->advance ())
+				count++;
+			res = res && (count == 3);
+		}
+		if (res)
+			cout << "\tTEST PASSED\n";
+		else
+			cout << "\tTEST FAILED\n";
+		QUNIT_IS_TRUE (res);
+	}
+	FALLTHROUGH_INTENDED;
+	case 15:
+	{
+		cout << "TEST 15... re-opening a tree from the catalog without re-loading it " << flush;
+		MyDB_TablePtr treeTable = make_shared <MyDB_Table> ("supplierTree", "supplierTree.bin", mySchema, "bplustree", "suppkey");
+		int height;
+		{
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+			MyDB_BPlusTreeReaderWriter supplierTable ("suppkey", treeTable, myMgr);
+			supplierTable.loadFromTextFile ("supplier.tbl");
+			height = supplierTable.getHeight ();
+			treeTable->putInCatalog (myCatalog);
+		}
+
+		// the tree comes back from the file just as it was
+		MyDB_TablePtr reopened = make_shared <MyDB_Table> ();
+		bool res = reopened->fromCatalog ("supplierTree", myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+		{
+			MyDB_BPlusTreeReaderWriter supplierTable ("suppkey", reopened, myMgr);
+			res = res && (supplierTable.getNumEntries () == 10000) && (supplierTable.getHeight () == height) && height > 2;
+			MyDB_IntAttValPtr key = make_shared <MyDB_IntAttVal> ();
+			for (int i = 1; i <= 10000; i += 7) {
+				key->set (i);
+				res = res && supplierTable.contains (key);
+			}
+
+			// and can be added to
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+			temp->fromString ("10001|Supplier#10001|addr|3|phone|1.5|comment|");
+			supplierTable.append (temp);
+			key->set (10001);
+			res = res && supplierTable.contains (key) && (supplierTable.getNumEntries () == 10001);
+		}
+
+		// a tree on some other attribute can't use the file, and starts out empty
+		MyDB_BPlusTreeReaderWriter nationTable ("nationkey", reopened, myMgr);
+		res = res && (nationTable.getNumEntries () == 0) && (nationTable.getHeight () == 0);
+		if (res)
+			cout << "\tTEST PASSED\n";
+		else
+			cout << "\tTEST FAILED\n";
+		QUNIT_IS_TRUE (res);
+	}
+	FALLTHROUGH_INTENDED;
+	case 16:
+	{
+		cout << "TEST 16... appending from four threads while two others look up and scan " << flush;
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+		MyDB_BPlusTreeReaderWriter supplierTable ("suppkey", myTable, myMgr);
+		supplierTable.clear ();
+
+		// start with the even keys up to 4000
+		MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+		for (int i = 2; i <= 4000; i += 2) {
+			temp->fromString (to_string (i) + "|Supplier#" + to_string (i) + "|addr|3|phone|1.5|comment|");
+			supplierTable.append (temp);
+		}
+
+		// the writers add the odd keys up to 7999, each in its own random order
+		atomic <int> writersLeft (4);
+		atomic <bool> readersOK (true);
+		vector <thread> threads;
+		for (int t = 0; t < 4; t++) {
+			threads.push_back (thread ([&supplierTable, &writersLeft, t] {
+				vector <int> keys;
+				for (int i = 1 + 2 * t; i < 8000; i += 8)
+					keys.push_back (i);
+				shuffle (keys.begin (), keys.end (), mt19937 (16 + t));
+				MyDB_RecordPtr rec = supplierTable.getEmptyRecord ();
+				for (int key : keys) {
+					rec->fromString (to_string (key) + "|Supplier#" + to_string (key) + "|addr|3|phone|1.5|comment|");
+					supplierTable.append (rec);
+				}
+				writersLeft--;
+			}));
+		}
+
+		// the readers should always find all of the even keys, in order
+		for (int t = 0; t < 2; t++) {
+			threads.push_back (thread ([&supplierTable, &writersLeft, &readersOK, t] {
+				MyDB_RecordPtr rec = supplierTable.getEmptyRecord ();
+				MyDB_IntAttValPtr low = make_shared <MyDB_IntAttVal> ();
+				MyDB_IntAttValPtr high = make_shared <MyDB_IntAttVal> ();
+				for (int round = 0; writersLeft > 0 || round < 10; round++) {
+					for (int i = 2 + 2 * t; i <= 4000; i += 46) {
+						low->set (i);
+						if (!supplierTable.lookup (low, rec) || rec->getAtt (0)->toInt () != i)
+							readersOK = false;
+					}
+					low->set (1000 + round % 1000);
+					high->set (3000 + round % 1000);
+					MyDB_RecordIteratorAltPtr myIter = supplierTable.getRangeIteratorAlt (low, high);
+					int last = 0, numEven = 0;
+					while (myIter->advance ()) {
+						myIter->getCurrent (rec);
+						int key = rec->getAtt (0)->toInt ();
+						if (key <= last || key < low->toInt () || key > high->toInt ())
+							readersOK = false;
+						numEven += (key % 2 == 0 && key <= 4000);
+						last = key;
+					}
+					if (numEven != (min (4000, high->toInt ()) - low->toInt ()) / 2 + 1 - (low->toInt () % 2))
+						readersOK = false;
+				}
+			}));
+		}
+		for (thread &t : threads)
+			t.join ();
+
+		// and in the end, every key is there once
+		bool res = readersOK && (supplierTable.getNumEntries () == 6000);
+		MyDB_IntAttValPtr low = make_shared <MyDB_IntAttVal> ();
+		MyDB_IntAttValPtr high = make_shared <MyDB_IntAttVal> ();
+		low->set (0);
+		high->set (10000);
+		MyDB_RecordIteratorAltPtr myIter = supplierTable.getRangeIteratorAlt (low, high);
+		int counter = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			int expected = (counter < 4000) ? counter + 1 : 2 * counter - 3999;
+			if (temp->getAtt (0)->toInt () != expected)
+				res = false;
+			counter++;
+		}
+		res = res && (counter == 6000);
+		if (res)
+			cout << "\tTEST PASSED\n";
+		else
+			cout << "\tTEST FAILED\n";
+		QUNIT_IS_TRUE (res);
+	}
+	FALLTHROUGH_INTENDED;
+	case 17:
+	{
+		cout << "TEST 17... removing records, with merges and free pages " << flush;
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+		MyDB_BPlusTreeReaderWriter supplierTable ("suppkey", myTable, myMgr);
+		supplierTable.clear ();
+
+		// every even key from 2 to 6000, twice, with different names
+		vector <int> keys;
+		for (int i = 1; i <= 3000; i++) {
+			keys.push_back (i * 2);
+			keys.push_back (-i * 2);
+		}
+		srand48 (17);
+		for (int i = keys.size () - 1; i > 0; i--)
+			swap (keys[i], keys[lrand48 () % (i + 1)]);
+		MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+		auto makeRec = [&] (int k) {
+			int key = (k < 0) ? -k : k;
+			temp->fromString (to_string (key) + "|Supplier#" + to_string (k) + "|addr|3|phone|1.5|comment|");
+		};
+		for (int k : keys) {
+			makeRec (k);
+			supplierTable.append (temp);
+		}
+		int fullHeight = supplierTable.getHeight ();
+		int numPages = supplierTable.getNumPages ();
+
+		// take out one copy of every key that is a multiple of 3; only an exact match goes
+		bool res = fullHeight > 2;
+		for (int i = 6; i <= 6000; i += 6) {
+			makeRec (-i);
+			res = res && supplierTable.remove (temp);
+			res = res && !supplierTable.remove (temp);
+		}
+		makeRec (7);
+		res = res && !supplierTable.remove (temp);
+
+		// and then both copies of every multiple of 4
+		MyDB_IntAttValPtr key = make_shared <MyDB_IntAttVal> ();
+		for (int i = 4; i <= 6000; i += 4) {
+			key->set (i);
+			res = res && (supplierTable.remove (key) == (i % 3 == 0 ? 1 : 2));
+			res = res && !supplierTable.contains (key);
+		}
+
+		// what is left is in order, and the counts agree
+		size_t expected = 0;
+		for (int i = 2; i <= 6000; i += 2)
+			expected += (i % 4 == 0) ? 0 : (i % 3 == 0 ? 1 : 2);
+		MyDB_IntAttValPtr low = make_shared <MyDB_IntAttVal> ();
+		MyDB_IntAttValPtr high = make_shared <MyDB_IntAttVal> ();
+		low->set (0);
+		high->set (10000);
+		MyDB_RecordIteratorAltPtr myIter = supplierTable.getRangeIteratorAlt (low, high);
+		size_t counter = 0;
+		int last = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			int k = temp->getAtt (0)->toInt ();
+			if (k < last || k % 4 == 0 || (k % 3 == 0 && temp->getAtt (1)->toString () != "Supplier#" + to_string (k)))
+				res = false;
+			last = k;
+			counter++;
+		}
+		res = res && (counter == expected) && (supplierTable.getNumEntries () == expected);
+
+		// a scan that is part of the way through when records are removed picks up where it left off
+		myIter = supplierTable.getRangeIteratorAlt (low, high);
+		for (int i = 0; i < 100 && myIter->advance (); i++);
+		for (int i = 2; i <= 6000; i += 4) {
+			key->set (i);
+			if (i > 2000)
+				supplierTable.remove (key);
+		}
+		last = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			int k = temp->getAtt (0)->toInt ();
+			if (k < last || k > 2000)
+				res = false;
+			last = k;
+		}
+
+		// take out the rest; the tree shrinks back to a root and one empty leaf
+		for (int i = 2; i <= 6000; i += 2) {
+			key->set (i);
+			supplierTable.remove (key);
+		}
+		myIter = supplierTable.getRangeIteratorAlt (low, high);
+		res = res && !myIter->advance () && supplierTable.getNumEntries () == 0 && supplierTable.getHeight () == 2;
+
+		// and putting the records back uses the pages that were freed, rather than new ones
+		for (int k : keys) {
+			makeRec (k);
+			supplierTable.append (temp);
+		}
+		res = res && (supplierTable.getNumEntries () == 6000) && (supplierTable.getNumPages () == numPages);
+		for (int i = 2; i <= 6000; i += 598) {
+			key->set (i);
+			res = res && supplierTable.contains (key);
+		}
+		if (res)
+			cout << "\tTEST PASSED\n";
+		else
+			cout << "\tTEST FAILED\n";
+		QUNIT_IS_TRUE (res);
+	}
+	FALLTHROUGH_INTENDED;
+	case 18:
+	{
+		cout << "TEST 18... appending keys in increasing order packs the leaves " << flush;
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+		MyDB_BPlusTreeReaderWriter supplierTable ("suppkey", myTable, myMgr);
+
+		// with each fill factor, every leaf but the last should be about that full
+		bool res = true;
+		MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+		for (double fill : {0.9, 1.0, 0.6}) {
+			supplierTable.clear ();
+			supplierTable.setFillFactor (fill);
+			res = res && (supplierTable.getFillFactor () == fill);
+			for (int i = 1; i <= 5000; i++) {
+				temp->fromString (to_string (i) + "|Supplier#" + to_string (i) + "|addr|3|phone|1.5|comment|");
+				supplierTable.append (temp);
+			}
+
+			int leftmost = supplierTable.getTable ()->getRootLocation ();
+			while (supplierTable[leftmost].getType () == MyDB_PageType :: DirectoryPage)
+				leftmost = getNodeChildren <int> (supplierTable[leftmost].getBytes (), 1024)[0];
+			int counter = 1;
+			for (int i = leftmost; i != -1; i = supplierTable[i].getNextPage ()) {
+				MyDB_PageReaderWriter page = supplierTable[i];
+				for (size_t j = 0; j < page.getNumRecords (); j++) {
+					page.getRecord (j, temp);
+					res = res && (temp->getAtt (0)->toInt () == counter++);
+				}
+
+				// a record and its slot take less than 100 bytes
+				size_t used = getPageBytesUsed (page.getBytes ());
+				if (page.getNextPage () != -1 && (used + 100 < fill * 1024 || used > fill * 1024))
+					res = false;
+			}
+			res = res && (counter == 5001);
+		}
+		if (res)
+			cout << "\tTEST PASSED\n";
+		else
+			cout << "\tTEST FAILED\n";
+		QUNIT_IS_TRUE (res);
+	}
+	FALLTHROUGH_INTENDED;
+	case 19:
+	{
+		cout << "TEST 19... short separators in trees on comment " << flush;
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+		MyDB_TablePtr unsortedTable = make_shared <MyDB_Table> ("supplierUnsorted", "supplierUnsorted.bin", mySchema);
+		MyDB_TableReaderWriter loadMe (unsortedTable, myMgr);
+		loadMe.loadFromTextFile ("supplier.tbl");
+		MyDB_BPlusTreeReaderWriter appendedTree ("comment", myTable, myMgr);
+		appendedTree.loadFromTextFile ("supplier.tbl");
+		MyDB_TablePtr bulkTable = make_shared <MyDB_Table> ("supplierBulk", "supplierBulk.bin", mySchema);
+		MyDB_BPlusTreeReaderWriter bulkTree ("comment", bulkTable, myMgr);
+		MyDB_SortKeyPtr sortKey = make_shared <MyDB_SortKey> (mySchema, vector <string> {"comment"});
+		bulkTree.bulkLoad (buildItertorOverSortedRuns (16, loadMe, sortKey));
+
+		bool res = true;
+		for (MyDB_BPlusTreeReaderWriter *tree : {&appendedTree, &bulkTree}) {
+
+			// the keys in the internal nodes (other than the largest possible key) should be less than
+			// half as long as the comments, on average
+			MyDB_INRecordPtr inRec = make_shared <MyDB_INRecord> (make_shared <MyDB_StringAttVal> ());
+			vector <int> toVisit {tree->getTable ()->getRootLocation ()};
+			size_t sepLen = 0, numSeps = 0;
+			while (!toVisit.empty ()) {
+				MyDB_PageReaderWriter page = (*tree)[toVisit.back ()];
+				toVisit.pop_back ();
+				if (page.getType () != MyDB_PageType :: DirectoryPage)
+					continue;
+				for (size_t i = 0; i < page.getNumRecords (); i++) {
+					page.getRecord (i, inRec);
+					toVisit.push_back (inRec->getPtr ());
+					if (inRec->getAtt (0)->toString () != "~~~~~~~~~") {
+						sepLen += inRec->getAtt (0)->toString ().size ();
+						numSeps++;
+					}
+				}
+			}
+
+			// all of the records are still found, in order
+			MyDB_RecordPtr temp = tree->getEmptyRecord ();
+			MyDB_StringAttValPtr low = make_shared <MyDB_StringAttVal> ();
+			MyDB_StringAttValPtr high = make_shared <MyDB_StringAttVal> ();
+			low->set ("");
+			high->set ("~");
+			MyDB_RecordIteratorAltPtr myIter = tree->getRangeIteratorAlt (low, high);
+			int counter = 0;
+			size_t commentLen = 0;
+			string last;
+			vector <string> comments;
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				string comment = temp->getAtt (6)->toString ();
+				if (comment < last)
+					res = false;
+				if (counter++ % 37 == 0)
+					comments.push_back (comment);
+				commentLen += comment.size ();
+				last = comment;
+			}
+			res = res && (counter == 10000) && (numSeps > 0) && (sepLen * 10000 * 2 < commentLen * numSeps);
+			for (string &comment : comments) {
+				low->set (comment);
+				res = res && tree->lookup (low, temp) && (temp->getAtt (6)->toString () == comment);
+			}
+		}
+		if (res)
+			cout << "\tTEST PASSED\n";
+		else
+			cout << "\tTEST FAILED\n";
+		QUNIT_IS_TRUE (res);
+	}
+	FALLTHROUGH_INTENDED;
+	case 20:
+	{
+		cout << "TEST 20... searching the key arrays of internal nodes, in a tree on acctbal " << flush;
+
+		// searching a node gives the same answers as lower_bound and upper_bound, with runs of equal keys,
+		// and with both more and fewer keys than the binary search narrows down to
+		bool res = true;
+		vector <char> node (1024);
+		int *intKeys = getNodeKeys <int> (node.data ());
+		for (size_t n : vector <size_t> {0, 1, 5, 33, 100, getNodeCapacity <int> (1024)}) {
+			for (size_t i = 0; i < n; i++)
+				intKeys[i] = (i / 3) * 2;
+			getPageNumSlots (node.data ()) = n;
+			for (int key = -1; key <= (int) n; key++) {
+				size_t lower = lower_bound (intKeys, intKeys + n, key) - intKeys;
+				size_t upper = upper_bound (intKeys, intKeys + n, key) - intKeys;
+				res = res && (searchNode <int> (node.data (), key, false) == lower);
+				res = res && (searchNode <int> (node.data (), key, true) == upper);
+			}
+		}
+		double *doubleKeys = getNodeKeys <double> (node.data ());
+		for (size_t n : vector <size_t> {0, 1, 5, 33, getNodeCapacity <double> (1024)}) {
+			for (size_t i = 0; i < n; i++)
+				doubleKeys[i] = (i / 3) * 0.5 - 3;
+			getPageNumSlots (node.data ()) = n;
+			for (double key = -3.25; key <= n * 0.25; key += 0.25) {
+				size_t lower = lower_bound (doubleKeys, doubleKeys + n, key) - doubleKeys;
+				size_t upper = upper_bound (doubleKeys, doubleKeys + n, key) - doubleKeys;
+				res = res && (searchNode <double> (node.data (), key, false) == lower);
+				res = res && (searchNode <double> (node.data (), key, true) == upper);
+			}
+		}
+
+		// a tree on a double has all of the records, in order, and we can take out the negative balances
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+		MyDB_TablePtr acctTable = make_shared <MyDB_Table> ("supplierAcct", "supplierAcct.bin", mySchema);
+		MyDB_BPlusTreeReaderWriter acctTree ("acctbal", acctTable, myMgr);
+		acctTree.loadFromTextFile ("supplier.tbl");
+		MyDB_RecordPtr temp = acctTree.getEmptyRecord ();
+		MyDB_DoubleAttValPtr low = make_shared <MyDB_DoubleAttVal> ();
+		MyDB_DoubleAttValPtr high = make_shared <MyDB_DoubleAttVal> ();
+		low->set (-1e10);
+		high->set (1e10);
+		vector <double> negatives;
+		double last = -1e10;
+		int counter = 0;
+		MyDB_RecordIteratorAltPtr myIter = acctTree.getRangeIteratorAlt (low, high);
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			double bal = temp->getAtt (5)->toDouble ();
+			res = res && (bal >= last);
+			if (bal < 0 && bal != last)
+				negatives.push_back (bal);
+			last = bal;
+			counter++;
+		}
+		res = res && (counter == 10000) && (acctTree.getHeight () > 2);
+
+		size_t removed = 0;
+		for (double bal : negatives) {
+			low->set (bal);
+			removed += acctTree.remove (low);
+		}
+		low->set (-1e10);
+		myIter = acctTree.getRangeIteratorAlt (low, high);
+		counter = 0;
+		last = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			double bal = temp->getAtt (5)->toDouble ();
+			res = res && (bal >= last);
+			last = bal;
+			counter++;
+		}
+		res = res && (removed == 886) && (counter == 10000 - 886) && (acctTree.getNumEntries () == 10000 - 886);
+		if (res)
+			cout << "\tTEST PASSED\n";
+		else
+			cout << "\tTEST FAILED\n";
+		QUNIT_IS_TRUE (res);
+	}
+	FALLTHROUGH_INTENDED;
+	case 21:
+	{
+		cout << "TEST 21... loading a tree on suppkey with several threads " << flush;
+
+		// the parsed records go through append, so they can all be found in the tree
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+		MyDB_BPlusTreeReaderWriter supplierTable ("suppkey", myTable, myMgr);
+		pair <vector <size_t>, size_t> loaded = supplierTable.loadFromTextFile ("supplier.tbl", 4);
+		bool res = (loaded.second == 10000) && (supplierTable.getNumEntries () == 10000) && (supplierTable.getHeight () > 1);
+
+		MyDB_IntAttValPtr key = make_shared <MyDB_IntAttVal> ();
+		for (int i = 1; i <= 10000; i += 37) {
+			key->set (i);
+			res = res && supplierTable.contains (key);
+		}
+		key->set (10001);
+		res = res && !supplierTable.contains (key);
+
+		MyDB_IntAttValPtr low = make_shared <MyDB_IntAttVal> ();
+		MyDB_IntAttValPtr high = make_shared <MyDB_IntAttVal> ();
+		low->set (1);
+		high->set (100);
+		MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+		MyDB_RecordIteratorAltPtr myIter = supplierTable.getRangeIteratorAlt (low, high);
+		int counter = 0;
+		while (myIter->advance ()) {
+			myIter->getCurrent (temp);
+			counter++;
+			res = res && (temp->getAtt (0)->toInt () == counter);
+		}
+		res = res && (counter == 100);
+		if (res)
+			cout << "\tTEST PASSED\n";
+		else
+			cout << "\tTEST FAILED\n";
+		QUNIT_IS_TRUE (res);
+	}
+	FALLTHROUGH_INTENDED;
+	case 22:
+	{
+		cout << "TEST 22... a tree on a dictionary-encoded string " << flush;
+
+		// the codes are given out as the values come in, so the tree has to order the records by value
+		MyDB_SchemaPtr dictSchema = make_shared <MyDB_Schema> ();
+		dictSchema->appendAtt (make_pair ("key", make_shared <MyDB_IntAttType> ()));
+		dictSchema->appendAtt (make_pair ("name", make_shared <MyDB_DictAttType> (false)));
+		MyDB_TablePtr dictTable = make_shared <MyDB_Table> ("dictTree", "dictTree.bin", dictSchema);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (1024, 128, "tempFile");
+		MyDB_BPlusTreeReaderWriter dictTree ("name", dictTable, myMgr);
+		MyDB_RecordPtr temp = dictTree.getEmptyRecord ();
+		vector <string> names = {"m", "c", "x", "a", "q"};
+		for (int i = 0; i < 3000; i++)
+			names.push_back ("z" + to_string (10000 + (i * 7919) % 3000));
+		for (size_t i = 0; i < names.size (); i++) {
+			temp->fromString (to_string (i) + "|" + names[i] + "|");
+			dictTree.append (temp);
+		}
+		bool res = (dictTree.getHeight () > 1);
+
+		// keys can be plain strings, or values of the attribute
+		auto scan = [&] (MyDB_AttValPtr low, MyDB_AttValPtr high) {
+			vector <string> found;
+			MyDB_RecordIteratorAltPtr myIter = dictTree.getRangeIteratorAlt (low, high);
+			while (myIter->advance ()) {
+				myIter->getCurrent (temp);
+				found.push_back (temp->getAtt (1)->toString ());
+			}
+			return found;
+		};
+		MyDB_StringAttValPtr low = make_shared <MyDB_StringAttVal> ();
+		MyDB_StringAttValPtr high = make_shared <MyDB_StringAttVal> ();
+		low->set ("b");
+		high->set ("p");
+		res = res && (scan (low, high) == vector <string> {"c", "m"});
+		MyDB_AttValPtr dictLow = dictSchema->getAtts ()[1].second->createAtt ();
+		MyDB_AttValPtr dictHigh = dictSchema->getAtts ()[1].second->createAtt ();
+		string a = "a", x = "x";
+		dictLow->fromString (a);
+		dictHigh->fromString (x);
+		res = res && (scan (dictLow, dictHigh) == vector <string> {"a", "c", "m", "q", "x"});
+		res = res && dictTree.contains (dictHigh) && !dictTree.contains (high);
+
+		low->set ("");
+		high->set ("~");
+		vector <string> all = scan (low, high);
+		res = res && (all.size () == names.size ()) && is_sorted (all.begin (), all.end ());
+		if (res)
+			cout << "\tTEST PASSED\n";
+		else
+			cout << "\tTEST FAILED\n";
+		QUNIT_IS_TRUE (res);
+	}
 	}
 }
 
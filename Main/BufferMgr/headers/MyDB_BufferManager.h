@@ -16,6 +16,8 @@
 #include "CheckLRU.h"
 #include <map>
 #include <memory>
+#include <mutex>
+#include "MyDB_CompressedFile.h"
 #include "MyDB_Page.h"
 #include "MyDB_PageHandle.h"
 #include "MyDB_Table.h"
@@ -29,6 +31,10 @@ using namespace std;
 class MyDB_BufferManager;
 typedef shared_ptr <MyDB_BufferManager> MyDB_BufferManagerPtr;
 
+// The buffer manager can be used by several threads at once: all of its state (and the reference counts
+// of its pages) is protected by one lock.  Note that an unpinned page can be swapped out by another
+// thread at any time, so a thread that is working with a page's bytes while other threads are using
+// the buffer manager should have the page pinned
 class MyDB_BufferManager {
 
 public:
@@ -70,6 +76,11 @@ public:
 
 	// returns the page size
 	size_t getPageSize ();
+
+	// the number of bytes read from and written to the tables' files since the buffer manager was
+	// created; for a compressed table (see MyDB_Table.setCompressed), these are the compressed bytes
+	size_t getBytesRead ();
+	size_t getBytesWritten ();
 	
 private:
 
@@ -82,6 +93,13 @@ private:
 	// lists the FDs for all of the files
 	map <MyDB_TablePtr, int, TableCompare> fds;
 
+	// and for the tables whose pages are compressed, where each page is in the file
+	map <MyDB_TablePtr, MyDB_CompressedFilePtr, TableCompare> compressedFiles;
+
+	// the number of bytes read and written
+	size_t bytesRead;
+	size_t bytesWritten;
+
 	// all of the chunks of RAM that are currently not allocated
 	vector <void *> availableRam;
 
@@ -103,6 +121,10 @@ private:
 	// the number of buffer pages
 	size_t numPages;
 
+	// held by everything that looks at or changes the buffer manager's state; it is recursive, since
+	// (for example) a page can be killed while another page is being read in
+	recursive_mutex bufferMutex;
+
 	// so that the page can access these private methods
 	friend class MyDB_Page;
 	friend class SortMergeJoin;
@@ -110,6 +132,14 @@ private:
 	// kick out the LRU page
 	void kickOutPage ();
 
+	// opens the file for the table, if it is not open
+	void openFile (MyDB_TablePtr whichTable);
+
+	// reads the page's bytes from its file, or writes them back, decompressing or compressing them
+	// if the page's table is compressed
+	void readPage (MyDB_PagePtr readMe);
+	void writePage (MyDB_PagePtr writeMe);
+
 	// process an access to the given page
 	void access (MyDB_PagePtr updateMe);
 
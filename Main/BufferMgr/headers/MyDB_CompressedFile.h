@@ -0,0 +1,80 @@
+
+#ifndef COMPRESSED_FILE_H
+#define COMPRESSED_FILE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// create a smart pointer for compressed files
+class MyDB_CompressedFile;
+typedef shared_ptr <MyDB_CompressedFile> MyDB_CompressedFilePtr;
+
+// This is the file for a table whose pages are compressed (see MyDB_Table.setCompressed).  Each page
+// is compressed with compressPage (see MyDB_PageCompressor.h) when it is written, so it takes up less
+// room in the file than it does in RAM, and so the file is no longer just an array of pages.  Instead,
+// each page is stored in an "extent" (a run of bytes somewhere in the file) that may be a bit bigger
+// than the compressed page, to leave room for it to grow.  If a page outgrows its extent, it gets a
+// new one, and the old one is re-used for some other page later on.  A page that does not compress
+// at all is written as-is.  The list of extents is kept in a side file, which is read when the
+// compressed file is opened.  Each page's extent has a fixed spot in the side file, and it is written
+// there every time the page is, so the side file always matches what is in the file (even if the
+// compressed file is never closed, or the same file is opened again somewhere else)
+class MyDB_CompressedFile {
+
+public:
+
+	// sets up the compressed file for the given (open) file, where the list of extents is in the given
+	// side file; the pages are pageSize bytes long
+	MyDB_CompressedFile (int fd, string mapFile, size_t pageSize);
+
+	// closes the side file
+	~MyDB_CompressedFile ();
+
+	// reads the given page into the given bytes; a page that has never been written comes back all
+	// zeros.  Returns the number of bytes that were read from the file
+	size_t readPage (size_t whichPage, void *bytes);
+
+	// compresses the given bytes, and writes them to the file as the given page; returns the number
+	// of bytes that were written to the file
+	size_t writePage (size_t whichPage, void *bytes);
+
+	// makes sure that the list of extents in the side file is on disk
+	void toFile ();
+
+private:
+
+	// where a page is in the file; length is zero if it has never been written, and equal to the page
+	// size if the page could not be compressed
+	struct Extent {
+		size_t offset;
+		uint32_t capacity;
+		uint32_t length;
+	};
+
+	vector <Extent> extents;
+
+	// the extents that are not used by any page, by capacity; these are the gaps between the extents
+	// that are used, so they don't need to be in the side file
+	multimap <uint32_t, size_t> freeExtents;
+
+	// the end of the last extent in the file
+	size_t fileEnd;
+
+	// writes the given page's extent to its spot in the side file
+	void writeExtent (size_t whichPage);
+
+	int fd;
+	int mapFd;
+	string mapFile;
+	size_t pageSize;
+
+	// the compressed bytes go here
+	vector <char> buffer;
+};
+
+#endif
@@ -48,17 +48,10 @@ public:
 	void setBytes (void *bytes, size_t numBytes);
 
 	// decrements the ref count
-	inline void decRefCount (MyDB_PagePtr me) {
-		refCount--;
-		if (refCount == 0) {
-			killpage (me);
-		}
-	}
+	void decRefCount (MyDB_PagePtr me);
 
 	// increments the ref count
-	inline void incRefCount () {
-		refCount++;
-	}
+	void incRefCount ();
 
 	// get the parent
 	MyDB_BufferManager& getParent ();
@@ -0,0 +1,25 @@
+
+#ifndef PAGE_COMPRESSOR_H
+#define PAGE_COMPRESSOR_H
+
+#include <cstddef>
+
+// A small, fast LZ77-style codec for pages, in the spirit of LZ4.  The compressed bytes are a list
+// of sequences, each of which is a run of literal bytes followed by a copy of bytes that appeared
+// earlier (at most 64KB earlier) on the page.  Each sequence starts with a token byte: the high four
+// bits are the number of literals, and the low four are the length of the copy minus four; if either
+// is 15, more length bytes follow (each 255 means "keep going").  Then come the literals, and then
+// the two-byte distance back to the bytes to copy.  The last sequence is just literals.
+//
+// Records on a page share a lot of bytes (the attribute lengths, the prefixes of keys, the words in
+// the text attributes) so they compress well, even without a separate dictionary
+
+// compresses len bytes from src into dest, which has room for destCap bytes; returns the size of the
+// compressed bytes, or zero if they would not fit into dest
+size_t compressPage (const void *src, size_t len, void *dest, size_t destCap);
+
+// decompresses len bytes from src into dest, which must come out to exactly destLen bytes; returns
+// false if the compressed bytes are bad
+bool decompressPage (const void *src, size_t len, void *dest, size_t destLen);
+
+#endif
@@ -28,13 +28,58 @@ size_t MyDB_BufferManager :: getPageSize () {
 	return pageSize;
 }
 
+size_t MyDB_BufferManager :: getBytesRead () {
+	lock_guard <recursive_mutex> lock (bufferMutex);
+	return bytesRead;
+}
+
+size_t MyDB_BufferManager :: getBytesWritten () {
+	lock_guard <recursive_mutex> lock (bufferMutex);
+	return bytesWritten;
+}
+
+void MyDB_BufferManager :: openFile (MyDB_TablePtr whichTable) {
+
+	if (fds.count (whichTable) != 0 || whichTable == nullptr)
+		return;
+
+	int fd = open (whichTable->getStorageLoc ().c_str (), O_CREAT | O_RDWR, 0666);
+	fds[whichTable] = fd;
+	if (whichTable->isCompressed ())
+		compressedFiles[whichTable] = make_shared <MyDB_CompressedFile> (fd, whichTable->getStorageLoc () + ".pagemap", pageSize);
+}
+
+void MyDB_BufferManager :: readPage (MyDB_PagePtr readMe) {
+
+	if (readMe->myTable != nullptr && readMe->myTable->isCompressed ()) {
+		bytesRead += compressedFiles[readMe->myTable]->readPage (readMe->pos, readMe->bytes);
+		return;
+	}
+
+	lseek (fds[readMe->myTable], readMe->pos * pageSize, SEEK_SET);
+	read (fds[readMe->myTable], readMe->bytes, pageSize);
+	if (readMe->myTable != nullptr)
+		bytesRead += pageSize;
+}
+
+void MyDB_BufferManager :: writePage (MyDB_PagePtr writeMe) {
+
+	if (writeMe->myTable != nullptr && writeMe->myTable->isCompressed ()) {
+		bytesWritten += compressedFiles[writeMe->myTable]->writePage (writeMe->pos, writeMe->bytes);
+		return;
+	}
+
+	lseek (fds[writeMe->myTable], writeMe->pos * pageSize, SEEK_SET);
+	write (fds[writeMe->myTable], writeMe->bytes, pageSize);
+	if (writeMe->myTable != nullptr)
+		bytesWritten += pageSize;
+}
+
 MyDB_PageHandle MyDB_BufferManager :: getPage (MyDB_TablePtr whichTable, long i) {
+	lock_guard <recursive_mutex> lock (bufferMutex);
 		
 	// open the file, if it is not open
-	if (fds.count (whichTable) == 0) {
-		int fd = open (whichTable->getStorageLoc ().c_str (), O_CREAT | O_RDWR, 0666);
-		fds[whichTable] = fd;
-	}
+	openFile (whichTable);
 
 	// make sure we don't have a null table
 	if (whichTable == nullptr) {
@@ -57,6 +102,7 @@ MyDB_PageHandle MyDB_BufferManager :: getPage (MyDB_TablePtr whichTable, long i)
 }
 
 MyDB_PageHandle MyDB_BufferManager :: getPage () {
+	lock_guard <recursive_mutex> lock (bufferMutex);
 
 	// open the file, if it is not open
 	if (fds.count (nullptr) == 0) {
@@ -94,8 +140,7 @@ void MyDB_BufferManager :: kickOutPage () {
 
 	// write it back if necessary
 	if (page->isDirty) {
-		lseek (fds[page->myTable], page->pos * pageSize, SEEK_SET);
-		write (fds[page->myTable], page->bytes, pageSize);
+		writePage (page);
 		page->isDirty = false;
 	}
 
@@ -112,6 +157,7 @@ void MyDB_BufferManager :: kickOutPage () {
 }
 
 void MyDB_BufferManager :: killPage (MyDB_PagePtr killMe) {
+	lock_guard <recursive_mutex> lock (bufferMutex);
 	
 
 	// if this is an anon page...
@@ -142,6 +188,7 @@ void MyDB_BufferManager :: killPage (MyDB_PagePtr killMe) {
 }
 
 void MyDB_BufferManager :: access (MyDB_PagePtr updateMe) {
+	lock_guard <recursive_mutex> lock (bufferMutex);
 	
 	// if this page was just accessed, get outta here
 	if (updateMe->timeTick > lastTimeTick - (numPages / 2) && updateMe->bytes != nullptr) {
@@ -175,8 +222,7 @@ void MyDB_BufferManager :: access (MyDB_PagePtr updateMe) {
 		availableRam.pop_back ();
 
 		// and read it
-		lseek (fds[updateMe->myTable], updateMe->pos * pageSize, SEEK_SET);
-		read (fds[updateMe->myTable], updateMe->bytes, pageSize);
+		readPage (updateMe);
 
 		updateMe->timeTick = ++lastTimeTick;
 		lastUsed.insert (updateMe);
@@ -184,12 +230,10 @@ void MyDB_BufferManager :: access (MyDB_PagePtr updateMe) {
 }
 
 MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, long i) {
+	lock_guard <recursive_mutex> lock (bufferMutex);
 
 	// open the file, if it is not open
-	if (fds.count (whichTable) == 0) {
-		int fd = open (whichTable->getStorageLoc ().c_str (), O_CREAT | O_RDWR, 0666);
-		fds[whichTable] = fd;
-	}
+	openFile (whichTable);
 
 	// make sure we don't have a null table
 	if (whichTable == nullptr) {
@@ -236,8 +280,7 @@ MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, l
 		availableRam.pop_back ();
 
 		// and read it
-		lseek (fds[returnVal->myTable], returnVal->pos * pageSize, SEEK_SET);
-		read (fds[returnVal->myTable], returnVal->bytes, pageSize);
+		readPage (returnVal);
 
 	}	
 
@@ -246,6 +289,7 @@ MyDB_PageHandle MyDB_BufferManager :: getPinnedPage (MyDB_TablePtr whichTable, l
 }
 
 MyDB_PageHandle MyDB_BufferManager :: getPinnedPage () {
+	lock_guard <recursive_mutex> lock (bufferMutex);
 
 	// see if there is space to make a pinned page
 	if (availableRam.size () == 0)
@@ -266,6 +310,7 @@ MyDB_PageHandle MyDB_BufferManager :: getPinnedPage () {
 }
 
 void MyDB_BufferManager :: unpin (MyDB_PagePtr unpinMe) {
+	lock_guard <recursive_mutex> lock (bufferMutex);
 	unpinMe->timeTick = ++lastTimeTick;
 	lastUsed.insert (unpinMe);
 }
@@ -284,6 +329,10 @@ MyDB_BufferManager :: MyDB_BufferManager (size_t pageSizeIn, size_t numPagesIn,
 	// position in temp file
 	lastTempPos = 0;
 
+	// nothing read or written yet
+	bytesRead = 0;
+	bytesWritten = 0;
+
 	// the number of pages
 	numPages = numPagesIn;
 
@@ -301,8 +350,7 @@ MyDB_BufferManager :: ~MyDB_BufferManager () {
 
 			// write it back if necessary
 			if (page.second->isDirty) {
-				lseek (fds[page.second->myTable], page.second->pos * pageSize, SEEK_SET);
-				write (fds[page.second->myTable], page.second->bytes, pageSize);
+				writePage (page.second);
 			}
 
 			free (page.second->bytes);
@@ -315,6 +363,11 @@ MyDB_BufferManager :: ~MyDB_BufferManager () {
 		free (ram);
 	}
 
+	// remember where the compressed pages are
+	for (auto file : compressedFiles) {
+		file.second->toFile ();
+	}
+
 	// finally, close the files
 	for (auto fd : fds) {
 		close (fd.second);
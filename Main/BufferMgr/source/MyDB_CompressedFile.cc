@@ -0,0 +1,157 @@
+
+#ifndef COMPRESSED_FILE_C
+#define COMPRESSED_FILE_C
+
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include "MyDB_CompressedFile.h"
+#include "MyDB_PageCompressor.h"
+#include <unistd.h>
+
+using namespace std;
+
+// extents are a multiple of this many bytes, so that a page can grow a bit without having to move
+#define EXTENT_ROUND 64
+
+// the side file starts with this and then the page size, followed by an extent for each page (as an
+// 8-byte offset, a 4-byte capacity, and a 4-byte length)
+#define MAP_MAGIC 0x4d59444250474d31ULL
+#define MAP_HEADER_SIZE (2 * sizeof (uint64_t))
+#define MAP_EXTENT_SIZE (sizeof (uint64_t) + 2 * sizeof (uint32_t))
+
+MyDB_CompressedFile :: MyDB_CompressedFile (int fdIn, string mapFileIn, size_t pageSizeIn) {
+
+	fd = fdIn;
+	mapFile = mapFileIn;
+	pageSize = pageSizeIn;
+	fileEnd = 0;
+	buffer.resize (pageSize);
+
+	// a new side file just gets its header
+	mapFd = open (mapFile.c_str (), O_CREAT | O_RDWR, 0666);
+	uint64_t header[2];
+	ssize_t headerBytes = pread (mapFd, header, MAP_HEADER_SIZE, 0);
+	if (headerBytes == 0) {
+		header[0] = MAP_MAGIC;
+		header[1] = pageSize;
+		pwrite (mapFd, header, MAP_HEADER_SIZE, 0);
+		return;
+	}
+	if (headerBytes != (ssize_t) MAP_HEADER_SIZE || header[0] != MAP_MAGIC) {
+		cout << "The file " << mapFile << " is not a list of compressed pages.\n";
+		exit (1);
+	}
+	if (header[1] != pageSize) {
+		cout << "The compressed file " << mapFile << " has pages of " << header[1] << " bytes, not " << pageSize << ".\n";
+		exit (1);
+	}
+
+	// read all of the extents; a page that was never written has an empty one
+	off_t mapSize = lseek (mapFd, 0, SEEK_END);
+	vector <char> bytes (mapSize - MAP_HEADER_SIZE);
+	if (pread (mapFd, bytes.data (), bytes.size (), MAP_HEADER_SIZE) != (ssize_t) bytes.size ()) {
+		cout << "The compressed file " << mapFile << " is cut off.\n";
+		exit (1);
+	}
+	extents.resize (bytes.size () / MAP_EXTENT_SIZE);
+	for (size_t i = 0; i < extents.size (); i++) {
+		char *loc = bytes.data () + i * MAP_EXTENT_SIZE;
+		uint64_t offset;
+		memcpy (&offset, loc, sizeof (uint64_t));
+		memcpy (&extents[i].capacity, loc + sizeof (uint64_t), sizeof (uint32_t));
+		memcpy (&extents[i].length, loc + sizeof (uint64_t) + sizeof (uint32_t), sizeof (uint32_t));
+		extents[i].offset = offset;
+	}
+
+	// the free extents are the gaps between the used ones
+	vector <pair <size_t, uint32_t>> used;
+	for (Extent &ext : extents)
+		if (ext.capacity != 0)
+			used.push_back (make_pair (ext.offset, ext.capacity));
+	sort (used.begin (), used.end ());
+	for (auto &ext : used) {
+		if (ext.first > fileEnd)
+			freeExtents.insert (make_pair ((uint32_t) (ext.first - fileEnd), fileEnd));
+		fileEnd = ext.first + ext.second;
+	}
+}
+
+MyDB_CompressedFile :: ~MyDB_CompressedFile () {
+	close (mapFd);
+}
+
+void MyDB_CompressedFile :: writeExtent (size_t whichPage) {
+	char bytes[MAP_EXTENT_SIZE];
+	uint64_t offset = extents[whichPage].offset;
+	memcpy (bytes, &offset, sizeof (uint64_t));
+	memcpy (bytes + sizeof (uint64_t), &extents[whichPage].capacity, sizeof (uint32_t));
+	memcpy (bytes + sizeof (uint64_t) + sizeof (uint32_t), &extents[whichPage].length, sizeof (uint32_t));
+	pwrite (mapFd, bytes, MAP_EXTENT_SIZE, MAP_HEADER_SIZE + whichPage * MAP_EXTENT_SIZE);
+}
+
+size_t MyDB_CompressedFile :: readPage (size_t whichPage, void *bytes) {
+
+	if (whichPage >= extents.size () || extents[whichPage].length == 0) {
+		memset (bytes, 0, pageSize);
+		return 0;
+	}
+
+	// an uncompressed page can go right in
+	Extent &ext = extents[whichPage];
+	char *readInto = (ext.length == pageSize) ? (char *) bytes : buffer.data ();
+	lseek (fd, ext.offset, SEEK_SET);
+	if (read (fd, readInto, ext.length) != (ssize_t) ext.length ||
+		(ext.length != pageSize && !decompressPage (buffer.data (), ext.length, bytes, pageSize))) {
+		cout << "Could not read page " << whichPage << " of the compressed file " << mapFile << ".\n";
+		exit (1);
+	}
+	return ext.length;
+}
+
+size_t MyDB_CompressedFile :: writePage (size_t whichPage, void *bytes) {
+
+	// if the page does not compress, write it as-is
+	char *writeFrom = buffer.data ();
+	size_t length = compressPage (bytes, pageSize, buffer.data (), pageSize - 1);
+	if (length == 0) {
+		writeFrom = (char *) bytes;
+		length = pageSize;
+	}
+
+	if (whichPage >= extents.size ())
+		extents.resize (whichPage + 1, Extent {0, 0, 0});
+	Extent &ext = extents[whichPage];
+
+	// if it does not fit where it was, find it a new extent
+	if (length > ext.capacity) {
+		if (ext.capacity != 0)
+			freeExtents.insert (make_pair (ext.capacity, ext.offset));
+		uint32_t capacity = (length + EXTENT_ROUND - 1) / EXTENT_ROUND * EXTENT_ROUND;
+		auto it = freeExtents.lower_bound (capacity);
+		if (it != freeExtents.end ()) {
+			ext.capacity = it->first;
+			ext.offset = it->second;
+			freeExtents.erase (it);
+		} else {
+			ext.capacity = capacity;
+			ext.offset = fileEnd;
+			fileEnd += capacity;
+		}
+	}
+
+	// the page is written before its extent, so until the side file says otherwise, the old extent
+	// (which can't have been re-used yet) still has the old version of the page
+	ext.length = length;
+	lseek (fd, ext.offset, SEEK_SET);
+	write (fd, writeFrom, length);
+	writeExtent (whichPage);
+	return length;
+}
+
+void MyDB_CompressedFile :: toFile () {
+	fsync (mapFd);
+}
+
+#endif
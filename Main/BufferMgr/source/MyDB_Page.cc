@@ -35,6 +35,19 @@ MyDB_Page :: MyDB_Page (MyDB_TablePtr myTableIn, size_t iin, MyDB_BufferManager
 	timeTick = -1;
 }
 
+void MyDB_Page :: decRefCount (MyDB_PagePtr me) {
+	lock_guard <recursive_mutex> lock (parent.bufferMutex);
+	refCount--;
+	if (refCount == 0) {
+		killpage (me);
+	}
+}
+
+void MyDB_Page :: incRefCount () {
+	lock_guard <recursive_mutex> lock (parent.bufferMutex);
+	refCount++;
+}
+
 void MyDB_Page :: killpage (MyDB_PagePtr me) {
 	parent.killPage (me);
 }
@@ -0,0 +1,166 @@
+
+#ifndef PAGE_COMPRESSOR_C
+#define PAGE_COMPRESSOR_C
+
+#include <cstdint>
+#include <cstring>
+#include "MyDB_PageCompressor.h"
+
+using namespace std;
+
+// a copy is at least this long, and can go back at most this far
+#define MIN_MATCH 4
+#define MAX_DISTANCE 65535
+
+// the last few bytes are always written as literals, so that finding a copy never reads past the end
+#define LAST_LITERALS 8
+
+// the number of bits in the hash of four bytes
+#define HASH_BITS 12
+
+static inline uint32_t read32 (const char *from) {
+	uint32_t val;
+	memcpy (&val, from, sizeof (uint32_t));
+	return val;
+}
+
+static inline uint32_t hash4 (const char *from) {
+	return (read32 (from) * 2654435761U) >> (32 - HASH_BITS);
+}
+
+// writes the extra bytes for a length of 15 or more; returns false if there is no room
+static inline bool writeLength (char *&out, char *outEnd, size_t len) {
+	for (len -= 15; len >= 255; len -= 255) {
+		if (out == outEnd)
+			return false;
+		*(out++) = (char) 255;
+	}
+	if (out == outEnd)
+		return false;
+	*(out++) = (char) len;
+	return true;
+}
+
+// reads the extra bytes for a length; returns false if the input ends first
+static inline bool readLength (const unsigned char *&in, const unsigned char *inEnd, size_t &len) {
+	unsigned char next;
+	do {
+		if (in == inEnd)
+			return false;
+		next = *(in++);
+		len += next;
+	} while (next == 255);
+	return true;
+}
+
+// writes one sequence: the literals, and then the copy (if matchLen is not zero)
+static bool writeSequence (char *&out, char *outEnd, const char *literals, size_t numLiterals,
+	size_t distance, size_t matchLen) {
+
+	if (out == outEnd)
+		return false;
+	char *token = out++;
+	size_t matchCode = (matchLen == 0) ? 0 : matchLen - MIN_MATCH;
+	*token = (char) (((numLiterals < 15 ? numLiterals : 15) << 4) | (matchCode < 15 ? matchCode : 15));
+
+	if (numLiterals >= 15 && !writeLength (out, outEnd, numLiterals))
+		return false;
+	if ((size_t) (outEnd - out) < numLiterals)
+		return false;
+	memcpy (out, literals, numLiterals);
+	out += numLiterals;
+
+	if (matchLen == 0)
+		return true;
+	if (outEnd - out < 2)
+		return false;
+	*(out++) = (char) (distance & 0xff);
+	*(out++) = (char) (distance >> 8);
+	return matchCode < 15 || writeLength (out, outEnd, matchCode);
+}
+
+size_t compressPage (const void *srcIn, size_t len, void *destIn, size_t destCap) {
+
+	const char *src = (const char *) srcIn;
+	char *out = (char *) destIn;
+	char *outEnd = out + destCap;
+
+	// where we last saw each hash of four bytes, plus one (so that zero means never)
+	uint32_t lastSeen[1 << HASH_BITS];
+	memset (lastSeen, 0, sizeof (lastSeen));
+
+	size_t pos = 0, anchor = 0;
+	size_t limit = (len > LAST_LITERALS + MIN_MATCH) ? len - LAST_LITERALS - MIN_MATCH : 0;
+	while (pos < limit) {
+
+		uint32_t h = hash4 (src + pos);
+		size_t ref = lastSeen[h];
+		lastSeen[h] = (uint32_t) (pos + 1);
+
+		// no copy here, so move on; the longer we go without a copy, the faster we skip ahead
+		if (ref == 0 || pos - (ref - 1) > MAX_DISTANCE || read32 (src + ref - 1) != read32 (src + pos)) {
+			pos += 1 + ((pos - anchor) >> 6);
+			continue;
+		}
+
+		// see how far the copy goes
+		ref--;
+		size_t matchLen = MIN_MATCH;
+		while (pos + matchLen < len - LAST_LITERALS && src[ref + matchLen] == src[pos + matchLen])
+			matchLen++;
+
+		if (!writeSequence (out, outEnd, src + anchor, pos - anchor, pos - ref, matchLen))
+			return 0;
+		pos += matchLen;
+		anchor = pos;
+	}
+
+	// and the rest are literals
+	if (!writeSequence (out, outEnd, src + anchor, len - anchor, 0, 0))
+		return 0;
+	return out - (char *) destIn;
+}
+
+bool decompressPage (const void *srcIn, size_t len, void *destIn, size_t destLen) {
+
+	const unsigned char *in = (const unsigned char *) srcIn;
+	const unsigned char *inEnd = in + len;
+	char *dest = (char *) destIn;
+	size_t pos = 0;
+
+	while (in < inEnd) {
+
+		// get the literals
+		unsigned char token = *(in++);
+		size_t numLiterals = token >> 4;
+		if (numLiterals == 15 && !readLength (in, inEnd, numLiterals))
+			return false;
+		if ((size_t) (inEnd - in) < numLiterals || destLen - pos < numLiterals)
+			return false;
+		memcpy (dest + pos, in, numLiterals);
+		in += numLiterals;
+		pos += numLiterals;
+
+		// the last sequence has no copy
+		if (in == inEnd)
+			break;
+
+		// and do the copy; it may overlap the bytes that it is writing, so go a byte at a time
+		if (inEnd - in < 2)
+			return false;
+		size_t distance = in[0] | (in[1] << 8);
+		in += 2;
+		size_t matchLen = token & 15;
+		if (matchLen == 15 && !readLength (in, inEnd, matchLen))
+			return false;
+		matchLen += MIN_MATCH;
+		if (distance == 0 || distance > pos || destLen - pos < matchLen)
+			return false;
+		for (size_t i = 0; i < matchLen; i++, pos++)
+			dest[pos] = dest[pos - distance];
+	}
+
+	return pos == destLen;
+}
+
+#endif
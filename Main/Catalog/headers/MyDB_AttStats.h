@@ -0,0 +1,101 @@
+
+#ifndef ATT_STATS_H
+#define ATT_STATS_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include "MyDB_Value.h"
+
+using namespace std;
+
+// A MyDB_AttStats holds the statistics for one attribute of a table that are used to estimate the
+// selectivity of predicates over the attribute: the smallest and largest values, an equi-depth
+// histogram (a list of bucket boundaries, with the same number of tuples in between each pair of
+// boundaries), and a list of the most common values along with the fraction of the tuples that
+// have each of them.  All of the values are stored as strings; for a numeric attribute (int, double,
+// or bool, where false is 0 and true is 1), they are compared as numbers.  A MyDB_AttStats is built
+// using a MyDB_AttStatsBuilder (below)
+class MyDB_AttStats {
+
+public:
+
+	// creates empty statistics; until they are built, every estimate is 1.0
+	MyDB_AttStats ();
+
+	// true if there is anything here
+	bool isEmpty ();
+
+	// access the statistics
+	string &getMin ();
+	string &getMax ();
+	vector <string> &getBounds ();
+	vector <pair <string, double>> &getMostCommon ();
+
+	// estimates the fraction of the tuples where the attribute is less than val
+	double estimateLessThan (string val);
+
+	// estimates the fraction of the tuples where the attribute equals val; distinctVals is the
+	// number of distinct values of the attribute (see MyDB_Table.getDistinctValues)
+	double estimateEquals (string val, size_t distinctVals);
+
+	// estimates the fraction of the tuples where the attribute is in [low, high]
+	double estimateRange (string low, string high, size_t distinctVals);
+
+	// write the statistics to a string, so that they can be stored in the catalog, and read them back
+	string toString ();
+	void fromString (string &fromMe);
+
+private:
+
+	friend class MyDB_AttStatsBuilder;
+
+	// three-way comparison of two values, as numbers or as strings
+	int compare (const string &lhs, const string &rhs);
+
+	bool isNumeric;
+	string minVal;
+	string maxVal;
+	vector <string> bounds;
+	vector <pair <string, double>> mostCommon;
+};
+
+// A MyDB_AttStatsBuilder collects the statistics for one attribute as values are added to it.  The
+// smallest and largest values are tracked exactly; the histogram and the most common values are
+// computed from a fixed-size random sample of the values (a reservoir sample)
+class MyDB_AttStatsBuilder {
+
+public:
+
+	// build statistics for a numeric attribute (or not); at most sampleSize values are kept
+	MyDB_AttStatsBuilder (bool isNumeric, size_t sampleSize = 10000);
+
+	// adds a value to the statistics; this only allocates if the value is kept in the sample,
+	// or if it is a new smallest or largest string
+	void add (MyDB_Value addMe);
+
+	// adds all of the values that were added to the other builder to this one
+	void merge (MyDB_AttStatsBuilder &withMe);
+
+	// gets the statistics, with at most the given number of histogram buckets and most common values
+	MyDB_AttStats build (size_t numBuckets = 20, size_t numMostCommon = 10);
+
+private:
+
+	// gets a random number
+	uint64_t nextRandom ();
+
+	bool isNumeric;
+	size_t sampleSize;
+	size_t numSeen;
+	uint64_t randState;
+
+	// the sample, and the smallest and largest values; only the ones matching the type are used
+	vector <double> numSample;
+	vector <string> strSample;
+	double numMin, numMax;
+	string strMin, strMax;
+};
+
+#endif
@@ -3,6 +3,7 @@
 #define ATT_TYPE_H
 
 #include "MyDB_AttVal.h"
+#include "MyDB_Dictionary.h"
 #include <float.h>
 #include <climits>
 #include <memory>
@@ -24,6 +25,11 @@ public:
 	virtual MyDB_AttValPtr createAttMax () = 0;
 	virtual string toString () = 0;
 	virtual bool isBool () = 0;
+
+	// for a dictionary-encoded attribute, gets the dictionary; otherwise, nullptr
+	virtual MyDB_DictionaryPtr getDictionary () {
+		return nullptr;
+	}
 };
 
 class MyDB_IntAttType : public MyDB_AttType {
@@ -167,4 +173,63 @@ public:
 	}	
 };
 
+// a dictionary-encoded attribute: the values are ints or strings, but each record holds the value's
+// code in the attribute's dictionary (see MyDB_Dictionary.h) instead of the value itself.  So in a
+// record, the attribute looks just like an int; the attribute value (a MyDB_DictAttVal) decodes it
+// when it is asked for its value by toString, toInt, and so on.  A computation over the attribute
+// works on the value, except that a comparison of two attributes with the same dictionary just
+// compares their codes
+class MyDB_DictAttType : public MyDB_AttType {
+
+public:
+
+	// a type with an empty dictionary, for ints or strings
+	MyDB_DictAttType (bool isNumeric) {
+		dictionary = make_shared <MyDB_Dictionary> (isNumeric);
+	}
+
+	// a type that uses the given dictionary
+	MyDB_DictAttType (MyDB_DictionaryPtr dictionaryIn) {
+		dictionary = dictionaryIn;
+	}
+
+	bool promotableToInt () {
+		return true;
+	}
+
+	bool promotableToDouble () {
+		return true;
+	}
+
+	bool promotableToString () {
+		return true;
+	}
+
+	bool isBool () {
+		return false;
+	}
+
+	string toString () {
+		return "dict";
+	}
+
+	MyDB_AttValPtr createAtt () {
+		return make_shared <MyDB_DictAttVal> (dictionary);
+	}
+
+	MyDB_AttValPtr createAttMax () {
+		MyDB_DictAttValPtr retVal = make_shared <MyDB_DictAttVal> (dictionary);
+		retVal->setCode (DICT_MAX_CODE);
+		return retVal;
+	}
+
+	MyDB_DictionaryPtr getDictionary () {
+		return dictionary;
+	}
+
+private:
+
+	MyDB_DictionaryPtr dictionary;
+};
+
 #endif
@@ -0,0 +1,107 @@
+
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <climits>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "MyDB_Value.h"
+
+using namespace std;
+
+// create a smart pointer for dictionaries
+class MyDB_Dictionary;
+typedef shared_ptr <MyDB_Dictionary> MyDB_DictionaryPtr;
+
+// a code that is bigger than all of the others, and that decodes to a value at least as big as any in
+// the dictionary (this is the code of MyDB_DictAttType.createAttMax)
+#define DICT_MAX_CODE INT_MAX
+
+// This is the dictionary for a dictionary-encoded attribute (see MyDB_DictAttType in MyDB_AttType.h).
+// Each distinct value of the attribute gets a small integer code, and records store the code rather
+// than the value.  The values are either all ints (a "numeric" dictionary) or all strings.
+//
+// When a dictionary is built all at once (as it is when a table is loaded from a text file), the codes
+// are given out in sorted order, so comparing two codes is the same as comparing their values, and a
+// comparison of the attribute with a constant can be turned into a comparison of the code with another
+// code (see translateComparison).  A value that is added later on gets the next code; if the value does
+// not come after all of the others, then the dictionary is no longer "ordered", and after that, codes
+// can only be checked for equality.  A dictionary can be used (and added to) by many threads at once
+class MyDB_Dictionary {
+
+public:
+
+	// creates an empty dictionary for ints (if isNumeric is true) or for strings
+	MyDB_Dictionary (bool isNumeric);
+
+	// true if this is a dictionary for ints
+	bool isNumeric ();
+
+	// true if the codes are in the same order as the values
+	bool isOrdered ();
+
+	// the number of values in the dictionary
+	size_t size ();
+
+	// removes all of the values
+	void clear ();
+
+	// gets the value with the given code (which may be DICT_MAX_CODE); this does not allocate, and a
+	// string value points into the dictionary (it stays good even as more values are added)
+	MyDB_Value getValue (int code);
+
+	// gets the code for the given value, or -1 if it is not in the dictionary
+	int getCode (MyDB_Value val);
+
+	// gets the code for the given value, adding the value to the dictionary if it is not there
+	int addValue (MyDB_Value val);
+
+	// adds all of the given values (written as text) that are not in the dictionary yet, in sorted
+	// order... so if the dictionary was empty, it is ordered afterward
+	void addValues (vector <string> &values);
+
+	// three-way comparison of the values with the two codes; DICT_MAX_CODE is bigger than everything
+	int compare (int lhsCode, int rhsCode);
+
+	// given a comparison of a value with the constant val (which is true if the value is less than val
+	// and ifLess is set, or equal and ifEqual is set, or greater and ifGreater is set), changes the
+	// flags and sets code so that the same comparison of the value's code with code gives the same
+	// answer.  Returns false if this can't be done, which is the case for a comparison other than
+	// == or != when the dictionary is not ordered
+	bool translateComparison (MyDB_Value val, bool &ifLess, bool &ifEqual, bool &ifGreater, int &code);
+
+	// write the dictionary to a string, and read it back
+	string toString ();
+	void fromString (string &fromMe);
+
+private:
+
+	// these are the same as getValue, getCode, and addValue, for when the mutex is already held
+	MyDB_Value valueAt (int code);
+	int findCode (MyDB_Value val);
+	int insertValue (MyDB_Value val);
+
+	// three-way comparison of the value with the given code with val
+	int compareWith (int code, MyDB_Value val);
+
+	// the position in sorted of the first value that is not less than val
+	size_t lowerBound (MyDB_Value val);
+
+	bool numeric;
+	bool ordered;
+
+	// the values, by code; a deque never moves its contents, so string values can point into it
+	deque <string> strings;
+	vector <int> ints;
+
+	// the codes, in the order of their values
+	vector <int> sorted;
+
+	// protects all of the above
+	mutex myMutex;
+};
+
+#endif
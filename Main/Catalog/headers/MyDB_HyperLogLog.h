@@ -0,0 +1,68 @@
+
+#ifndef HYPER_LOG_LOG_H
+#define HYPER_LOG_LOG_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// A MyDB_HyperLogLog is a sketch that is used to estimate the number of distinct values of an
+// attribute.  It takes a fixed amount of memory (one byte for each of 2^HLL_BITS registers) no
+// matter how many values are added, adding a value is just a few arithmetic operations, and two
+// sketches can be merged, so that (for example) sketches built by different threads can be
+// combined.  With 4096 registers, the standard error of the estimate is about 1.6%
+#define HLL_BITS 12
+
+class MyDB_HyperLogLog {
+
+public:
+
+	// creates an empty sketch
+	MyDB_HyperLogLog ();
+
+	// adds a hash of a value to the sketch (as computed by MyDB_AttVal.hash)
+	inline void add (size_t hash) {
+
+		// the hashes of some attribute types are not well-mixed (an int hashes to itself), so
+		// mix the bits first (this is the finalizer from MurmurHash3)
+		uint64_t h = hash;
+		h ^= h >> 33;
+		h *= 0xff51afd7ed558ccdULL;
+		h ^= h >> 33;
+		h *= 0xc4ceb9fe1a85ec53ULL;
+		h ^= h >> 33;
+
+		// the low bits pick the register; the register remembers the longest run of zeros seen
+		// at the top of the rest of the hash
+		size_t which = h & ((1 << HLL_BITS) - 1);
+		h >>= HLL_BITS;
+		unsigned char rank = 1;
+		while (rank <= 64 - HLL_BITS && (h & 1) == 0) {
+			rank++;
+			h >>= 1;
+		}
+		if (rank > registers[which])
+			registers[which] = rank;
+	}
+
+	// gets the estimated number of distinct values that have been added
+	size_t estimate () const;
+
+	// adds all of the values in the other sketch to this one
+	void merge (MyDB_HyperLogLog &withMe);
+
+	// empties the sketch
+	void clear ();
+
+	// write the sketch to a string, so that it can be stored in the catalog, and read it back
+	string toString ();
+	void fromString (string &fromMe);
+
+private:
+
+	vector <unsigned char> registers;
+};
+
+#endif
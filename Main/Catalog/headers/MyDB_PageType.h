@@ -1,3 +1,9 @@
 
-// this lists all of the different page types
-enum MyDB_PageType {RegularPage, DirectoryPage};
+#ifndef PAGE_TYPE_H
+#define PAGE_TYPE_H
+
+// this lists all of the different page types; a MetaPage holds the metadata for a B+-Tree (see
+// MyDB_BPlusTreeReaderWriter.h), and has no records on it
+enum MyDB_PageType {RegularPage, DirectoryPage, PaxPage, MetaPage};
+
+#endif
@@ -18,6 +18,14 @@ class MyDB_Schema {
 
 public:
 
+	// creates an empty schema
+	MyDB_Schema ();
+
+	// a number that no other schema has, and that changes whenever an attribute is added (or the schema
+	// is loaded from the catalog), so that it can be used to look up things that depend on the schema,
+	// such as compiled expressions (see MyDB_ExprCache.h)
+	size_t getID ();
+
 	// get a particular attribute... the pair is the index (first, second, third, etc.) and the type
 	pair <int, MyDB_AttTypePtr> getAttByName (string findMe);
 
@@ -45,6 +53,9 @@ private:
 	// this is a list, in order, of the attributes in the schema
 	// the string is the name of the attribute, and we also know the types
 	vector <pair <string, MyDB_AttTypePtr>> allAtts;
+
+	// see getID
+	size_t myID;
 };
 
 #endif
@@ -3,9 +3,12 @@
 #define TABLE_H
 
 #include <iostream>
+#include "MyDB_AttStats.h"
 #include "MyDB_Catalog.h"
+#include "MyDB_HyperLogLog.h"
 #include "MyDB_Schema.h"
 #include "MyDB_Table.h"
+#include "MyDB_ZoneMap.h"
 #include <memory>
 #include <string>
 
@@ -71,9 +74,14 @@ public:
 	// the sort att
 	string &getSortAtt ();
 
-	// the file type (ex: "heap" or "bplustree")
+	// the file type (ex: "heap", "bplustree", or "pax", which stores the records in PAX pages; see MyDB_PaxPage.h)
 	string &getFileType ();
 
+	// get/set whether the table's pages are compressed when they are written to disk (see
+	// MyDB_CompressedFile.h); this must be set before anything is written to the table
+	bool isCompressed ();
+	void setCompressed (bool toMe);
+
 	// get/set the root location
 	void setRootLocation (int toMe);
 	int getRootLocation ();
@@ -85,6 +93,37 @@ public:
         // set the distinct value count for all attributes
         void setDistinctValues (vector <size_t> &toMe);
 
+        // get the distinct value sketches for the attributes (see MyDB_HyperLogLog.h); there is one
+        // for each attribute (or none, if nothing has been added to them yet).  These are kept up to
+        // date as records are loaded and appended, and are stored in the catalog
+        const vector <MyDB_HyperLogLog> &getSketches () const;
+
+        // get the sketches in order to change them; this makes sure that there is one for each
+        // attribute, and the distinct value counts are re-estimated from them the next time
+        // getDistinctValues is called
+        vector <MyDB_HyperLogLog> &changeSketches ();
+
+        // get/set the histogram, min/max, and most common value statistics for the attributes (see
+        // MyDB_AttStats.h); these are built by MyDB_TableReaderWriter.loadFromTextFile and .analyze,
+        // and are stored in the catalog
+        vector <MyDB_AttStats> &getAttStats ();
+        void setAttStats (vector <MyDB_AttStats> &toMe);
+
+        // estimates the fraction of the tuples where the given attribute is in [low, high]
+        double estimateSelectivity (string att, string low, string high);
+
+        // returns true if a query for the tuples where the given attribute is in [low, high] should
+        // be answered with a B+-Tree range scan, rather than by scanning the whole file... a range
+        // scan reads the pages it needs in random order, so it only pays off if it needs few of them
+        bool preferRangeScan (string att, string low, string high);
+
+        // get the zone map for the table's pages (see MyDB_ZoneMap.h); this is kept up to date as records
+        // are loaded and appended via MyDB_TableReaderWriter.  It is stored in a side file (the table's
+        // storage location, with ".zones" added on) that is read the first time that it is needed, and
+        // written whenever the table is put in the catalog; it is removed as soon as the zone map changes,
+        // so if the table is changed and not put back in the catalog, no pages are known the next time
+        MyDB_ZoneMap &getZoneMap ();
+
         // get/set the number of tuples in the relation
         void setTupleCount (size_t toMe);
         size_t getTupleCount ();
@@ -94,6 +133,19 @@ private:
 	// the distinct value counts
 	vector <size_t> allCounts;
 
+	// the distinct value sketches, and whether allCounts needs to be re-estimated from them
+	vector <MyDB_HyperLogLog> sketches;
+	bool countsStale;
+
+	// the histograms and so on
+	vector <MyDB_AttStats> attStats;
+
+	// re-estimates allCounts from the sketches, if they have changed
+	void updateCounts ();
+
+	// the zone map; this is null until it is needed
+	MyDB_ZoneMapPtr zoneMap;
+
 	// the number of tuples
 	int count;
 
@@ -102,6 +154,9 @@ private:
 
 	// the type of the file
 	string fileType;
+
+	// whether the pages are compressed
+	bool compressed;
 	
 	// the last used page in the table
 	int last;
@@ -0,0 +1,94 @@
+
+#ifndef ZONE_MAP_H
+#define ZONE_MAP_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "MyDB_Schema.h"
+
+using namespace std;
+
+// create a smart pointer for zone maps
+class MyDB_ZoneMap;
+typedef shared_ptr <MyDB_ZoneMap> MyDB_ZoneMapPtr;
+
+// A MyDB_ZoneMap records, for each page of a table, the smallest and largest value of each attribute
+// on the page.  A scan with a selection predicate can check the zone map to see whether any record
+// on a page could possibly satisfy the predicate, and skip the page (without ever reading it into
+// the buffer) if not.  This is a big win for tables that are clustered on the attributes that are
+// queried, say, by time or by key.
+//
+// The entry for a page is only "known" if the zone map has seen every record that has been put on the
+// page since the page was cleared; pages that are not known are never skipped.  The zone map is stored
+// in a side file next to the table's data (see MyDB_Table.getZoneMap).  Only the side file that was
+// last read or written is trusted: the first change to the zone map after that removes it, so that if
+// the zone map is not written again, it is not read back out of date later on
+class MyDB_ZoneMap {
+
+public:
+
+	// creates an empty zone map for a table with the given schema; no pages are known
+	MyDB_ZoneMap (MyDB_SchemaPtr mySchema);
+
+	// forget about all of the pages
+	void clear ();
+
+	// the page has just been emptied out, so it is known, and has no records
+	void clearPage (int whichPage);
+
+	// something that the zone map cannot see has been written to the page, so it is no longer known
+	void forgetPage (int whichPage);
+
+	// adds a record that has been written to the page; the record is in the serialized form written by
+	// MyDB_Record.toBinary.  If the page is not known, this does nothing
+	void add (int whichPage, void *serializedRec);
+
+	// returns true if the page is known and has no records
+	bool isEmpty (int whichPage);
+
+	// returns false only if the page is known and the given attribute (which must be numeric)
+	// is never less than (ifLess), equal to (ifEqual), or greater than (ifGreater) val on the page
+	bool mightMatch (int whichPage, int whichAtt, bool ifLess, bool ifEqual, bool ifGreater, double val);
+
+	// like the above, but for a string attribute
+	bool mightMatch (int whichPage, int whichAtt, bool ifLess, bool ifEqual, bool ifGreater, const string &val);
+
+	// write the zone map to the given file, and read it back; false is returned if the file can't
+	// be read, in which case no pages are known
+	void toFile (string fName);
+	bool fromFile (string fName);
+
+private:
+
+	// the range of one attribute's values on a page; only the ones matching the type are used
+	struct AttZone {
+		double numMin, numMax;
+		string strMin, strMax;
+	};
+
+	// everything that we know about a page
+	struct PageZone {
+		bool known;
+		size_t numRecs;
+		vector <AttZone> atts;
+	};
+
+	// gets the entry for the given page, if it is known; otherwise, returns nullptr
+	PageZone *getKnown (int whichPage);
+
+	// called before the zone map is changed; removes the side file that it matched, if any
+	void changing ();
+
+	// the side file that the zone map matches (the one that it was last read from or written to), or
+	// empty if it has changed since then
+	string sideFile;
+
+	// the type of each attribute, as in MyDB_AttType.toString
+	vector <string> attTypes;
+
+	// the entries for each of the pages
+	vector <PageZone> pages;
+};
+
+#endif
@@ -0,0 +1,326 @@
+
+#ifndef ATT_STATS_C
+#define ATT_STATS_C
+
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include "MyDB_AttStats.h"
+
+using namespace std;
+
+MyDB_AttStats :: MyDB_AttStats () {
+	isNumeric = false;
+}
+
+bool MyDB_AttStats :: isEmpty () {
+	return bounds.size () == 0;
+}
+
+string &MyDB_AttStats :: getMin () {
+	return minVal;
+}
+
+string &MyDB_AttStats :: getMax () {
+	return maxVal;
+}
+
+vector <string> &MyDB_AttStats :: getBounds () {
+	return bounds;
+}
+
+vector <pair <string, double>> &MyDB_AttStats :: getMostCommon () {
+	return mostCommon;
+}
+
+int MyDB_AttStats :: compare (const string &lhs, const string &rhs) {
+	if (isNumeric) {
+		double l = stod (lhs), r = stod (rhs);
+		return (l > r) - (l < r);
+	}
+	return lhs.compare (rhs);
+}
+
+double MyDB_AttStats :: estimateLessThan (string val) {
+
+	if (isEmpty ())
+		return 1.0;
+	if (compare (val, minVal) <= 0)
+		return 0.0;
+	if (compare (val, maxVal) > 0)
+		return 1.0;
+
+	// find the bucket that val falls in; each bucket holds the same fraction of the tuples
+	size_t numBuckets = bounds.size () - 1;
+	for (size_t i = 0; i < numBuckets; i++) {
+		if (compare (val, bounds[i + 1]) <= 0) {
+
+			// for a number, assume that the values are spread evenly through the bucket;
+			// for a string, just assume that val is in the middle
+			double frac = 0.5;
+			if (isNumeric) {
+				double low = stod (bounds[i]), high = stod (bounds[i + 1]);
+				if (high > low)
+					frac = (stod (val) - low) / (high - low);
+			}
+			return (i + frac) / numBuckets;
+		}
+	}
+	return 1.0;
+}
+
+double MyDB_AttStats :: estimateEquals (string val, size_t distinctVals) {
+
+	if (isEmpty ())
+		return 1.0;
+	if (compare (val, minVal) < 0 || compare (val, maxVal) > 0)
+		return 0.0;
+
+	// if it is one of the most common values, we know how often it appears
+	double rest = 1.0;
+	for (auto &v : mostCommon) {
+		if (compare (val, v.first) == 0)
+			return v.second;
+		rest -= v.second;
+	}
+
+	// otherwise, assume that all of the other values are equally common
+	size_t others = distinctVals > mostCommon.size () ? distinctVals - mostCommon.size () : 1;
+	return rest > 0.0 ? rest / others : 0.0;
+}
+
+double MyDB_AttStats :: estimateRange (string low, string high, size_t distinctVals) {
+
+	if (isEmpty ())
+		return 1.0;
+	if (compare (low, high) > 0)
+		return 0.0;
+
+	double res = estimateLessThan (high) - estimateLessThan (low) + estimateEquals (high, distinctVals);
+	return res < 0.0 ? 0.0 : (res > 1.0 ? 1.0 : res);
+}
+
+// the values are separated by ';'... any character that has a special meaning (here, or in the
+// catalog) is written as %XX
+static void escape (const string &val, string &intoMe) {
+	for (char c : val) {
+		if (c == '%' || c == ';' || c == '#' || c == '|' || c == '\n') {
+			char code[4];
+			snprintf (code, sizeof (code), "%%%02X", (unsigned char) c);
+			intoMe += code;
+		} else {
+			intoMe += c;
+		}
+	}
+	intoMe += ';';
+}
+
+// reads the next value (written by escape) starting at pos, and moves pos past it
+static string unescape (const string &fromMe, size_t &pos) {
+	string res;
+	while (pos < fromMe.size () && fromMe[pos] != ';') {
+		if (fromMe[pos] == '%' && pos + 2 < fromMe.size ()) {
+			res += (char) stoi (fromMe.substr (pos + 1, 2), nullptr, 16);
+			pos += 3;
+		} else {
+			res += fromMe[pos++];
+		}
+	}
+	pos++;
+	return res;
+}
+
+// the format is: numeric?; number of bounds; number of most common values; min; max; the bounds;
+// and then each of the most common values, followed by its frequency
+string MyDB_AttStats :: toString () {
+	string res;
+	escape (isNumeric ? "1" : "0", res);
+	escape (to_string (bounds.size ()), res);
+	escape (to_string (mostCommon.size ()), res);
+	escape (minVal, res);
+	escape (maxVal, res);
+	for (auto &b : bounds)
+		escape (b, res);
+	for (auto &v : mostCommon) {
+		escape (v.first, res);
+		escape (to_string (v.second), res);
+	}
+	return res;
+}
+
+void MyDB_AttStats :: fromString (string &fromMe) {
+	bounds.clear ();
+	mostCommon.clear ();
+	if (fromMe.size () == 0)
+		return;
+
+	size_t pos = 0;
+	isNumeric = unescape (fromMe, pos) == "1";
+	size_t numBounds = stoul (unescape (fromMe, pos));
+	size_t numMostCommon = stoul (unescape (fromMe, pos));
+	minVal = unescape (fromMe, pos);
+	maxVal = unescape (fromMe, pos);
+	for (size_t i = 0; i < numBounds; i++)
+		bounds.push_back (unescape (fromMe, pos));
+	for (size_t i = 0; i < numMostCommon; i++) {
+		string val = unescape (fromMe, pos);
+		mostCommon.push_back (make_pair (val, stod (unescape (fromMe, pos))));
+	}
+}
+
+MyDB_AttStatsBuilder :: MyDB_AttStatsBuilder (bool isNumericIn, size_t sampleSizeIn) {
+	isNumeric = isNumericIn;
+	sampleSize = sampleSizeIn;
+	numSeen = 0;
+	randState = 0x9e3779b97f4a7c15ULL;
+	numMin = numMax = 0.0;
+}
+
+uint64_t MyDB_AttStatsBuilder :: nextRandom () {
+	randState ^= randState << 13;
+	randState ^= randState >> 7;
+	randState ^= randState << 17;
+	return randState;
+}
+
+void MyDB_AttStatsBuilder :: add (MyDB_Value addMe) {
+
+	numSeen++;
+
+	// once the sample is full, the n^th value replaces a random member of the sample
+	// with probability sampleSize / n
+	size_t slot = numSeen - 1;
+	if (slot >= sampleSize)
+		slot = nextRandom () % numSeen;
+
+	if (isNumeric) {
+		double val = addMe.getType () == MyDB_ValueType :: BoolVal ? (addMe.toBool () ? 1.0 : 0.0) : addMe.toDouble ();
+		if (numSeen == 1 || val < numMin)
+			numMin = val;
+		if (numSeen == 1 || val > numMax)
+			numMax = val;
+		if (slot == numSample.size ())
+			numSample.push_back (val);
+		else if (slot < sampleSize)
+			numSample[slot] = val;
+	} else {
+		if (numSeen == 1 || addMe.compareStrings (MyDB_Value :: fromString (strMin.c_str (), strMin.size ())) < 0)
+			strMin.assign (addMe.getChars (), addMe.getLength ());
+		if (numSeen == 1 || addMe.compareStrings (MyDB_Value :: fromString (strMax.c_str (), strMax.size ())) > 0)
+			strMax.assign (addMe.getChars (), addMe.getLength ());
+		if (slot == strSample.size ())
+			strSample.push_back (string (addMe.getChars (), addMe.getLength ()));
+		else if (slot < sampleSize)
+			strSample[slot].assign (addMe.getChars (), addMe.getLength ());
+	}
+}
+
+// merges two reservoir samples; lhs is a sample of lhsSeen values, and rhs of rhsSeen values.  Each
+// member of the result is drawn from lhs with probability proportional to the number of values that
+// lhs's sample stands for
+template <class T>
+static void mergeSamples (vector <T> &lhs, size_t lhsSeen, vector <T> &rhs, size_t rhsSeen,
+	size_t sampleSize, function <uint64_t ()> nextRandom) {
+
+	if (lhs.size () + rhs.size () <= sampleSize) {
+		lhs.insert (lhs.end (), rhs.begin (), rhs.end ());
+		return;
+	}
+
+	vector <T> lhsLeft = lhs, rhsLeft = rhs;
+	lhs.clear ();
+	while (lhs.size () < sampleSize) {
+		bool fromLhs = rhsLeft.size () == 0 || (lhsLeft.size () != 0 &&
+			nextRandom () % (lhsSeen + rhsSeen) < lhsSeen);
+		vector <T> &from = fromLhs ? lhsLeft : rhsLeft;
+		size_t which = nextRandom () % from.size ();
+		lhs.push_back (from[which]);
+		swap (from[which], from.back ());
+		from.pop_back ();
+	}
+}
+
+void MyDB_AttStatsBuilder :: merge (MyDB_AttStatsBuilder &withMe) {
+
+	if (withMe.numSeen == 0)
+		return;
+
+	if (numSeen == 0 || withMe.numMin < numMin)
+		numMin = withMe.numMin;
+	if (numSeen == 0 || withMe.numMax > numMax)
+		numMax = withMe.numMax;
+	if (numSeen == 0 || withMe.strMin < strMin)
+		strMin = withMe.strMin;
+	if (numSeen == 0 || withMe.strMax > strMax)
+		strMax = withMe.strMax;
+
+	auto rand = [this] {return nextRandom ();};
+	mergeSamples (numSample, numSeen, withMe.numSample, withMe.numSeen, sampleSize, rand);
+	mergeSamples (strSample, numSeen, withMe.strSample, withMe.numSeen, sampleSize, rand);
+	numSeen += withMe.numSeen;
+}
+
+// builds the histogram and most common values out of a sorted sample
+template <class T>
+static void buildFromSample (vector <T> &sample, size_t numBuckets, size_t numMostCommon,
+	vector <string> &bounds, vector <pair <string, double>> &mostCommon, function <string (const T &)> toString) {
+
+	// count each of the distinct values in the sample
+	vector <pair <size_t, size_t>> counts;
+	for (size_t i = 0; i < sample.size (); ) {
+		size_t j = i;
+		while (j < sample.size () && sample[j] == sample[i])
+			j++;
+		counts.push_back (make_pair (j - i, i));
+		i = j;
+	}
+
+	// the most common values are those that appear more than once in the sample
+	sort (counts.begin (), counts.end (), [] (const pair <size_t, size_t> &lhs, const pair <size_t, size_t> &rhs) {
+		return lhs.first > rhs.first;
+	});
+	for (size_t i = 0; i < counts.size () && i < numMostCommon && counts[i].first > 1; i++)
+		mostCommon.push_back (make_pair (toString (sample[counts[i].second]),
+			((double) counts[i].first) / sample.size ()));
+
+	// and the bucket boundaries are evenly spaced through the sample
+	if (numBuckets > sample.size () - 1)
+		numBuckets = sample.size () > 1 ? sample.size () - 1 : 1;
+	for (size_t i = 0; i <= numBuckets; i++)
+		bounds.push_back (toString (sample[i * (sample.size () - 1) / numBuckets]));
+}
+
+MyDB_AttStats MyDB_AttStatsBuilder :: build (size_t numBuckets, size_t numMostCommon) {
+
+	MyDB_AttStats res;
+	res.isNumeric = isNumeric;
+	if (numSeen == 0)
+		return res;
+
+	if (isNumeric) {
+		auto toString = [] (const double &val) {
+			char buf[32];
+			snprintf (buf, sizeof (buf), "%.17g", val);
+			return string (buf);
+		};
+		vector <double> sample = numSample;
+		sort (sample.begin (), sample.end ());
+		buildFromSample <double> (sample, numBuckets, numMostCommon, res.bounds, res.mostCommon, toString);
+		res.minVal = toString (numMin);
+		res.maxVal = toString (numMax);
+	} else {
+		vector <string> sample = strSample;
+		sort (sample.begin (), sample.end ());
+		buildFromSample <string> (sample, numBuckets, numMostCommon, res.bounds, res.mostCommon,
+			[] (const string &val) {return val;});
+		res.minVal = strMin;
+		res.maxVal = strMax;
+	}
+
+	// the ends of the histogram are the exact smallest and largest values
+	res.bounds.front () = res.minVal;
+	res.bounds.back () = res.maxVal;
+	return res;
+}
+
+#endif
@@ -0,0 +1,223 @@
+
+#ifndef DICTIONARY_C
+#define DICTIONARY_C
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include "MyDB_Dictionary.h"
+
+using namespace std;
+
+MyDB_Dictionary :: MyDB_Dictionary (bool isNumericIn) {
+	numeric = isNumericIn;
+	ordered = true;
+}
+
+bool MyDB_Dictionary :: isNumeric () {
+	lock_guard <mutex> lock (myMutex);
+	return numeric;
+}
+
+bool MyDB_Dictionary :: isOrdered () {
+	lock_guard <mutex> lock (myMutex);
+	return ordered;
+}
+
+size_t MyDB_Dictionary :: size () {
+	lock_guard <mutex> lock (myMutex);
+	return sorted.size ();
+}
+
+void MyDB_Dictionary :: clear () {
+	lock_guard <mutex> lock (myMutex);
+	strings.clear ();
+	ints.clear ();
+	sorted.clear ();
+	ordered = true;
+}
+
+MyDB_Value MyDB_Dictionary :: getValue (int code) {
+	lock_guard <mutex> lock (myMutex);
+	return valueAt (code);
+}
+
+MyDB_Value MyDB_Dictionary :: valueAt (int code) {
+
+	// this is the same as the largest int or string attribute (see MyDB_AttType.h)
+	if (code == DICT_MAX_CODE) {
+		if (numeric)
+			return MyDB_Value :: fromInt (INT_MAX);
+		return MyDB_Value :: fromString ("~~~~~~~~~", 9);
+	}
+
+	if (numeric)
+		return MyDB_Value :: fromInt (ints[code]);
+	return MyDB_Value :: fromString (strings[code].c_str (), strings[code].size ());
+}
+
+int MyDB_Dictionary :: compareWith (int code, MyDB_Value val) {
+	if (numeric) {
+		double lhs = ints[code];
+		double rhs = (val.getType () == MyDB_ValueType :: StringVal) ? atof (val.toString ().c_str ()) : val.toDouble ();
+		return (lhs > rhs) - (lhs < rhs);
+	}
+	return valueAt (code).compareAsStrings (val);
+}
+
+int MyDB_Dictionary :: compare (int lhsCode, int rhsCode) {
+	lock_guard <mutex> lock (myMutex);
+	if (ordered || lhsCode == DICT_MAX_CODE || rhsCode == DICT_MAX_CODE)
+		return (lhsCode > rhsCode) - (lhsCode < rhsCode);
+	if (numeric)
+		return (ints[lhsCode] > ints[rhsCode]) - (ints[lhsCode] < ints[rhsCode]);
+	return valueAt (lhsCode).compareStrings (valueAt (rhsCode));
+}
+
+size_t MyDB_Dictionary :: lowerBound (MyDB_Value val) {
+	size_t low = 0, high = sorted.size ();
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+		if (compareWith (sorted[mid], val) < 0)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+int MyDB_Dictionary :: getCode (MyDB_Value val) {
+	lock_guard <mutex> lock (myMutex);
+	return findCode (val);
+}
+
+int MyDB_Dictionary :: findCode (MyDB_Value val) {
+	size_t pos = lowerBound (val);
+	if (pos < sorted.size () && compareWith (sorted[pos], val) == 0)
+		return sorted[pos];
+	return -1;
+}
+
+int MyDB_Dictionary :: addValue (MyDB_Value val) {
+	lock_guard <mutex> lock (myMutex);
+	return insertValue (val);
+}
+
+int MyDB_Dictionary :: insertValue (MyDB_Value val) {
+
+	size_t pos = lowerBound (val);
+	if (pos < sorted.size () && compareWith (sorted[pos], val) == 0)
+		return sorted[pos];
+
+	// the new value gets the next code; unless it goes at the end, the codes are now out of order
+	int code = (int) sorted.size ();
+	if (numeric)
+		ints.push_back (val.getType () == MyDB_ValueType :: StringVal ? atoi (val.toString ().c_str ()) : val.toInt ());
+	else
+		strings.push_back (val.toString ());
+	ordered = ordered && (pos == sorted.size ());
+	sorted.insert (sorted.begin () + pos, code);
+	return code;
+}
+
+void MyDB_Dictionary :: addValues (vector <string> &values) {
+	lock_guard <mutex> lock (myMutex);
+	if (numeric) {
+		vector <int> toAdd;
+		for (string &s : values)
+			toAdd.push_back (atoi (s.c_str ()));
+		sort (toAdd.begin (), toAdd.end ());
+		for (int val : toAdd)
+			insertValue (MyDB_Value :: fromInt (val));
+	} else {
+		vector <string> toAdd = values;
+		sort (toAdd.begin (), toAdd.end ());
+		for (string &val : toAdd)
+			insertValue (MyDB_Value :: fromString (val.c_str (), val.size ()));
+	}
+}
+
+bool MyDB_Dictionary :: translateComparison (MyDB_Value val, bool &ifLess, bool &ifEqual, bool &ifGreater, int &code) {
+
+	lock_guard <mutex> lock (myMutex);
+
+	// if the codes are not in order, we can only check for equality; no code is -1
+	if (!ordered) {
+		if (ifLess != ifGreater)
+			return false;
+		code = findCode (val);
+		return true;
+	}
+
+	// the codes are in order, so the values less than val have the codes less than pos
+	size_t pos = lowerBound (val);
+	code = (int) pos;
+	if (pos < sorted.size () && compareWith (sorted[pos], val) == 0)
+		return true;
+
+	// if val is not there, then a value is less than val exactly when its code is at most pos - 1
+	code = (int) pos - 1;
+	ifEqual = ifLess;
+	return true;
+}
+
+// the values are separated by ';'... any character that has a special meaning (here, or in the
+// catalog) is written as %XX
+static void escape (const string &val, string &intoMe) {
+	for (char c : val) {
+		if (c == '%' || c == ';' || c == '#' || c == '|' || c == '\n') {
+			char code[4];
+			snprintf (code, sizeof (code), "%%%02X", (unsigned char) c);
+			intoMe += code;
+		} else {
+			intoMe += c;
+		}
+	}
+	intoMe += ';';
+}
+
+// reads the next value (written by escape) starting at pos, and moves pos past it
+static string unescape (const string &fromMe, size_t &pos) {
+	string res;
+	while (pos < fromMe.size () && fromMe[pos] != ';') {
+		if (fromMe[pos] == '%' && pos + 2 < fromMe.size ()) {
+			res += (char) stoi (fromMe.substr (pos + 1, 2), nullptr, 16);
+			pos += 3;
+		} else {
+			res += fromMe[pos++];
+		}
+	}
+	pos++;
+	return res;
+}
+
+// the format is: numeric?; the number of values; and then the values, in the order of their codes
+string MyDB_Dictionary :: toString () {
+	lock_guard <mutex> lock (myMutex);
+	string res;
+	escape (numeric ? "1" : "0", res);
+	escape (to_string (sorted.size ()), res);
+	for (size_t i = 0; i < sorted.size (); i++)
+		escape (valueAt (i).toString (), res);
+	return res;
+}
+
+void MyDB_Dictionary :: fromString (string &fromMe) {
+	lock_guard <mutex> lock (myMutex);
+	strings.clear ();
+	ints.clear ();
+	sorted.clear ();
+	ordered = true;
+	if (fromMe.size () == 0)
+		return;
+
+	size_t pos = 0;
+	numeric = unescape (fromMe, pos) == "1";
+	size_t numValues = stoul (unescape (fromMe, pos));
+	for (size_t i = 0; i < numValues; i++) {
+		string val = unescape (fromMe, pos);
+		insertValue (MyDB_Value :: fromString (val.c_str (), val.size ()));
+	}
+}
+
+#endif
@@ -0,0 +1,56 @@
+
+#ifndef HYPER_LOG_LOG_C
+#define HYPER_LOG_LOG_C
+
+#include <cmath>
+#include "MyDB_HyperLogLog.h"
+
+MyDB_HyperLogLog :: MyDB_HyperLogLog () : registers (1 << HLL_BITS, 0) {}
+
+size_t MyDB_HyperLogLog :: estimate () const {
+
+	double m = registers.size ();
+	double sum = 0.0;
+	size_t numZeros = 0;
+	for (unsigned char r : registers) {
+		sum += ldexp (1.0, -r);
+		if (r == 0)
+			numZeros++;
+	}
+	double est = (0.7213 / (1.0 + 1.079 / m)) * m * m / sum;
+
+	// for small counts, linear counting over the empty registers is more accurate
+	if (est <= 2.5 * m && numZeros != 0)
+		est = m * log (m / numZeros);
+
+	return (size_t) (est + 0.5);
+}
+
+void MyDB_HyperLogLog :: merge (MyDB_HyperLogLog &withMe) {
+	for (size_t i = 0; i < registers.size (); i++) {
+		if (withMe.registers[i] > registers[i])
+			registers[i] = withMe.registers[i];
+	}
+}
+
+void MyDB_HyperLogLog :: clear () {
+	for (unsigned char &r : registers)
+		r = 0;
+}
+
+// each register is written as a single printable character; none of these are used as separators
+// in the catalog
+string MyDB_HyperLogLog :: toString () {
+	string res (registers.size (), '0');
+	for (size_t i = 0; i < registers.size (); i++)
+		res[i] = '0' + registers[i];
+	return res;
+}
+
+void MyDB_HyperLogLog :: fromString (string &fromMe) {
+	clear ();
+	for (size_t i = 0; i < registers.size () && i < fromMe.size (); i++)
+		registers[i] = fromMe[i] - '0';
+}
+
+#endif
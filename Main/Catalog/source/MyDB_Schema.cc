@@ -2,11 +2,26 @@
 #ifndef SCHEMA_C
 #define SCHEMA_C
 
+#include <atomic>
 #include <iostream>
 #include "MyDB_Schema.h"
 
 using namespace std;
 
+// gives out the IDs for schemas; an ID is never given out twice
+static size_t getNewID () {
+	static atomic <size_t> nextID (0);
+	return ++nextID;
+}
+
+MyDB_Schema :: MyDB_Schema () {
+	myID = getNewID ();
+}
+
+size_t MyDB_Schema :: getID () {
+	return myID;
+}
+
 pair <int, MyDB_AttTypePtr> MyDB_Schema :: getAttByName (string findMe) {
 
 	// search for the information on a particular attributes
@@ -41,6 +56,10 @@ void MyDB_Schema :: addAtt (string tableName, pair <string, MyDB_AttTypePtr> att
 	}
 	catalog->putStringList (tableName + ".attList", myAtts);
 	catalog->putString (tableName + "." + attToAdd.first + ".type", attToAdd.second->toString ());
+
+	// a dictionary-encoded attribute has its dictionary stored with it
+	if (attToAdd.second->getDictionary () != nullptr)
+		catalog->putString (tableName + "." + attToAdd.first + ".dictionary", attToAdd.second->getDictionary ()->toString ());
 }
 
 
@@ -50,6 +69,7 @@ void MyDB_Schema :: fromCatalog (string tableName, MyDB_CatalogPtr catalog) {
 	vector <string> myAtts;
 	if (!catalog->getStringList (tableName + ".attList", myAtts))
 		return;
+	myID = getNewID ();
 	
 	// get the type of each attribute
 	for (string s : myAtts) {
@@ -63,6 +83,12 @@ void MyDB_Schema :: fromCatalog (string tableName, MyDB_CatalogPtr catalog) {
 			allAtts.push_back (make_pair (s, make_shared <MyDB_StringAttType> ()));
 		} else if (attType == "bool") {
 			allAtts.push_back (make_pair (s, make_shared <MyDB_BoolAttType> ()));
+		} else if (attType == "dict") {
+			string dictionary;
+			catalog->getString (tableName + "." + s + ".dictionary", dictionary);
+			MyDB_DictionaryPtr myDictionary = make_shared <MyDB_Dictionary> (false);
+			myDictionary->fromString (dictionary);
+			allAtts.push_back (make_pair (s, make_shared <MyDB_DictAttType> (myDictionary)));
 		} else {
 			cout << "Bad att type for attribute " << s << ": " << attType << "\n";
 			exit (1);
@@ -72,6 +98,7 @@ void MyDB_Schema :: fromCatalog (string tableName, MyDB_CatalogPtr catalog) {
 
 void MyDB_Schema :: appendAtt (pair <string, MyDB_AttTypePtr> addAtt) {
 	allAtts.push_back (addAtt);
+	myID = getNewID ();
 }
 
 void MyDB_Schema :: putInCatalog (string tableName, MyDB_CatalogPtr catalog) {
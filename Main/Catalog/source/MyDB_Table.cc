@@ -11,6 +11,9 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn) {
 	fileType = "heap";
 	sortAtt = "none";
 	rootLocation = -1;
+	count = 0;
+	countsStale = false;
+	compressed = false;
 }
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySchemaIn) {
@@ -21,6 +24,9 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySch
 	fileType = "heap";
 	sortAtt = "none";
 	rootLocation = -1;
+	count = 0;
+	countsStale = false;
+	compressed = false;
 }
 
 MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySchemaIn, string fileTypeIn, string sortAttIn) {
@@ -31,6 +37,9 @@ MyDB_Table :: MyDB_Table (string name, string storageLocIn, MyDB_SchemaPtr mySch
 	fileType = fileTypeIn;
 	sortAtt = sortAttIn;
 	rootLocation = -1;
+	count = 0;
+	countsStale = false;
+	compressed = false;
 }
 
 MyDB_Table :: ~MyDB_Table () {}
@@ -42,17 +51,73 @@ string &MyDB_Table :: getName () {
 size_t MyDB_Table :: getDistinctValues (string forMe) {
 	auto res = mySchema->getAttByName (forMe);
 	if (res.first != -1)
-		return allCounts[res.first];
+		return getDistinctValues (res.first);
 	else
 		return -1;
 }
 
 size_t MyDB_Table :: getDistinctValues (int forMe) {
+	updateCounts ();
         return allCounts[forMe];
 }
 
+void MyDB_Table :: updateCounts () {
+	if (countsStale && sketches.size () != 0) {
+		allCounts.clear ();
+		for (auto &s : sketches)
+			allCounts.push_back (s.estimate ());
+	}
+	countsStale = false;
+}
+
 void MyDB_Table :: setDistinctValues (vector <size_t> &toMe) {
         allCounts = toMe;
+	countsStale = false;
+}
+
+vector <MyDB_AttStats> &MyDB_Table :: getAttStats () {
+	return attStats;
+}
+
+void MyDB_Table :: setAttStats (vector <MyDB_AttStats> &toMe) {
+	attStats = toMe;
+}
+
+double MyDB_Table :: estimateSelectivity (string att, string low, string high) {
+	auto res = mySchema->getAttByName (att);
+	if (res.first == -1 || res.first >= (int) attStats.size ())
+		return 1.0;
+	updateCounts ();
+	size_t distinctVals = res.first < (int) allCounts.size () ? allCounts[res.first] : 0;
+	return attStats[res.first].estimateRange (low, high, distinctVals);
+}
+
+// the largest fraction of a table's tuples that a range scan is used for
+#define RANGE_SCAN_CUTOFF 0.1
+
+bool MyDB_Table :: preferRangeScan (string att, string low, string high) {
+	return estimateSelectivity (att, low, high) < RANGE_SCAN_CUTOFF;
+}
+
+const vector <MyDB_HyperLogLog> &MyDB_Table :: getSketches () const {
+	return sketches;
+}
+
+vector <MyDB_HyperLogLog> &MyDB_Table :: changeSketches () {
+
+	// make sure that there is one sketch per attribute
+	if (mySchema != nullptr && sketches.size () != mySchema->getAtts ().size ())
+		sketches.resize (mySchema->getAtts ().size ());
+	countsStale = true;
+	return sketches;
+}
+
+MyDB_ZoneMap &MyDB_Table :: getZoneMap () {
+	if (zoneMap == nullptr) {
+		zoneMap = make_shared <MyDB_ZoneMap> (mySchema);
+		zoneMap->fromFile (storageLoc + ".zones");
+	}
+	return *zoneMap;
 }
 
 void MyDB_Table :: setTupleCount (size_t toMe) {
@@ -75,6 +140,14 @@ string &MyDB_Table :: getFileType () {
 	return fileType;
 }
 
+bool MyDB_Table :: isCompressed () {
+	return compressed;
+}
+
+void MyDB_Table :: setCompressed (bool toMe) {
+	compressed = toMe;
+}
+
 string &MyDB_Table :: getSortAtt () {
 	return sortAtt;
 }
@@ -102,7 +175,11 @@ map <string, MyDB_TablePtr> MyDB_Table :: getAllTables (MyDB_CatalogPtr fromMe)
 	return returnVal;
 }
 
-MyDB_Table :: MyDB_Table () {}
+MyDB_Table :: MyDB_Table () {
+	count = 0;
+	countsStale = false;
+	compressed = false;
+}
 
 int MyDB_Table :: lastPage () {
 	return last;
@@ -130,6 +207,10 @@ bool MyDB_Table :: fromCatalog (string tableNameIn, MyDB_CatalogPtr catalog) {
 	// get the type
 	catalog->getString (tableName + ".fileType", fileType);
 
+	// and whether the pages are compressed
+	string compression;
+	compressed = catalog->getString (tableName + ".compression", compression) && compression == "lz";
+
 	// get the sort att
 	catalog->getString (tableName + ".sortAtt", sortAtt);
 
@@ -143,6 +224,25 @@ bool MyDB_Table :: fromCatalog (string tableNameIn, MyDB_CatalogPtr catalog) {
 	for (auto a : temp)
 		allCounts.push_back (stoull(a));
 
+	// and the sketches they came from
+	sketches.clear ();
+	temp.clear ();
+	catalog->getStringList (tableName + ".valSketches", temp);
+	for (auto a : temp) {
+		sketches.push_back (MyDB_HyperLogLog ());
+		sketches.back ().fromString (a);
+	}
+	countsStale = false;
+
+	// get the histograms and so on
+	attStats.clear ();
+	temp.clear ();
+	catalog->getStringList (tableName + ".attStats", temp);
+	for (auto a : temp) {
+		attStats.push_back (MyDB_AttStats ());
+		attStats.back ().fromString (a);
+	}
+
 	// get the number of tuples
 	catalog->getInt (tableName + ".numTuples", count);
 
@@ -172,19 +272,37 @@ void MyDB_Table :: putInCatalog (MyDB_CatalogPtr catalog) {
 
 	// and the type
 	catalog->putString (tableName + ".fileType", fileType);
+	catalog->putString (tableName + ".compression", compressed ? "lz" : "none");
 
 	// and the root location
 	catalog->putInt (tableName + ".rootLocation", rootLocation);
 
 	// remember the number of distinct attribute vals
+	updateCounts ();
 	vector <string> temp;
 	for (auto a : allCounts)
 		temp.push_back (to_string(a));
 	catalog->putStringList (tableName + ".valCounts", temp);
 
+	// and the sketches
+	temp.clear ();
+	for (auto &s : sketches)
+		temp.push_back (s.toString ());
+	catalog->putStringList (tableName + ".valSketches", temp);
+
+	// and the histograms and so on
+	temp.clear ();
+	for (auto &s : attStats)
+		temp.push_back (s.toString ());
+	catalog->putStringList (tableName + ".attStats", temp);
+
 	// remember the number of tuples
 	catalog->putInt (tableName + ".numTuples", count);
 
+	// the zone map goes in its own file
+	if (zoneMap != nullptr)
+		zoneMap->toFile (storageLoc + ".zones");
+
 	// and the sort att
 	catalog->putString (tableName + ".sortAtt", sortAtt);
 
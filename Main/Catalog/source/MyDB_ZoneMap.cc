@@ -0,0 +1,189 @@
+
+#ifndef ZONE_MAP_C
+#define ZONE_MAP_C
+
+#include <cstring>
+#include <fstream>
+#include "MyDB_ZoneMap.h"
+#include <unistd.h>
+
+using namespace std;
+
+MyDB_ZoneMap :: MyDB_ZoneMap (MyDB_SchemaPtr mySchema) {
+	for (auto &att : mySchema->getAtts ())
+		attTypes.push_back (att.second->toString ());
+}
+
+void MyDB_ZoneMap :: changing () {
+	if (!sideFile.empty ()) {
+		unlink (sideFile.c_str ());
+		sideFile.clear ();
+	}
+}
+
+void MyDB_ZoneMap :: clear () {
+	changing ();
+	pages.clear ();
+}
+
+void MyDB_ZoneMap :: clearPage (int whichPage) {
+	if (whichPage < 0)
+		return;
+	changing ();
+	if ((size_t) whichPage >= pages.size ())
+		pages.resize (whichPage + 1, PageZone {false, 0, {}});
+	pages[whichPage].known = true;
+	pages[whichPage].numRecs = 0;
+	pages[whichPage].atts.resize (attTypes.size ());
+}
+
+void MyDB_ZoneMap :: forgetPage (int whichPage) {
+	if (whichPage >= 0 && (size_t) whichPage < pages.size () && pages[whichPage].known) {
+		changing ();
+		pages[whichPage].known = false;
+	}
+}
+
+MyDB_ZoneMap :: PageZone *MyDB_ZoneMap :: getKnown (int whichPage) {
+	if (whichPage < 0 || (size_t) whichPage >= pages.size () || !pages[whichPage].known)
+		return nullptr;
+	return &pages[whichPage];
+}
+
+bool MyDB_ZoneMap :: isEmpty (int whichPage) {
+	PageZone *zone = getKnown (whichPage);
+	return zone != nullptr && zone->numRecs == 0;
+}
+
+void MyDB_ZoneMap :: add (int whichPage, void *serializedRec) {
+
+	PageZone *zone = getKnown (whichPage);
+	if (zone == nullptr)
+		return;
+	changing ();
+	bool first = (zone->numRecs++ == 0);
+
+	// walk through the attributes; each one is prefixed with its length
+	char *loc = ((char *) serializedRec) + sizeof (short);
+	for (size_t i = 0; i < attTypes.size (); i++) {
+		char *data = loc + sizeof (short);
+		AttZone &att = zone->atts[i];
+		if (attTypes[i] == "string") {
+
+			// strings are stored with a zero byte at the end, so this only allocates on a new min or max
+			if (first || strcmp (data, att.strMin.c_str ()) < 0)
+				att.strMin = data;
+			if (first || strcmp (data, att.strMax.c_str ()) > 0)
+				att.strMax = data;
+		} else {
+			double val;
+			if (attTypes[i] == "int" || attTypes[i] == "dict")
+				val = *((int *) data);
+			else if (attTypes[i] == "double")
+				val = *((double *) data);
+			else
+				val = (*data != 0) ? 1.0 : 0.0;
+			if (first || val < att.numMin)
+				att.numMin = val;
+			if (first || val > att.numMax)
+				att.numMax = val;
+		}
+		loc += *((short *) loc);
+	}
+}
+
+bool MyDB_ZoneMap :: mightMatch (int whichPage, int whichAtt, bool ifLess, bool ifEqual, bool ifGreater, double val) {
+	PageZone *zone = getKnown (whichPage);
+	if (zone == nullptr)
+		return true;
+	if (zone->numRecs == 0)
+		return false;
+	AttZone &att = zone->atts[whichAtt];
+	return (ifLess && att.numMin < val) || (ifEqual && att.numMin <= val && val <= att.numMax) ||
+		(ifGreater && att.numMax > val);
+}
+
+bool MyDB_ZoneMap :: mightMatch (int whichPage, int whichAtt, bool ifLess, bool ifEqual, bool ifGreater, const string &val) {
+	PageZone *zone = getKnown (whichPage);
+	if (zone == nullptr)
+		return true;
+	if (zone->numRecs == 0)
+		return false;
+	AttZone &att = zone->atts[whichAtt];
+	return (ifLess && att.strMin < val) || (ifEqual && att.strMin <= val && val <= att.strMax) ||
+		(ifGreater && att.strMax > val);
+}
+
+// helpers for reading and writing the file
+template <class T>
+static void writeVal (ofstream &out, T val) {
+	out.write ((char *) &val, sizeof (T));
+}
+
+static void writeString (ofstream &out, string &val) {
+	writeVal (out, val.size ());
+	out.write (val.data (), val.size ());
+}
+
+template <class T>
+static bool readVal (ifstream &in, T &val) {
+	return (bool) in.read ((char *) &val, sizeof (T));
+}
+
+static bool readString (ifstream &in, string &val) {
+	size_t len;
+	if (!readVal (in, len))
+		return false;
+	val.resize (len);
+	return len == 0 || (bool) in.read (&val[0], len);
+}
+
+// the file has the number of attributes and the number of pages, and then for each page, whether it is
+// known, the number of records, and the range of each attribute
+void MyDB_ZoneMap :: toFile (string fName) {
+	ofstream out (fName, ios :: binary | ios :: trunc);
+	writeVal (out, attTypes.size ());
+	writeVal (out, pages.size ());
+	for (PageZone &zone : pages) {
+		writeVal (out, (char) zone.known);
+		writeVal (out, zone.numRecs);
+		for (size_t i = 0; i < attTypes.size (); i++) {
+			AttZone empty = {0.0, 0.0, "", ""};
+			AttZone &att = i < zone.atts.size () ? zone.atts[i] : empty;
+			writeVal (out, att.numMin);
+			writeVal (out, att.numMax);
+			writeString (out, att.strMin);
+			writeString (out, att.strMax);
+		}
+	}
+	sideFile = fName;
+}
+
+bool MyDB_ZoneMap :: fromFile (string fName) {
+	pages.clear ();
+	ifstream in (fName, ios :: binary);
+	size_t numAtts, numPages;
+	if (!readVal (in, numAtts) || numAtts != attTypes.size () || !readVal (in, numPages))
+		return false;
+
+	pages.resize (numPages);
+	for (PageZone &zone : pages) {
+		char known;
+		bool ok = readVal (in, known) && readVal (in, zone.numRecs);
+		zone.known = (known != 0);
+		zone.atts.resize (numAtts);
+		for (AttZone &att : zone.atts)
+			ok = ok && readVal (in, att.numMin) && readVal (in, att.numMax) &&
+				readString (in, att.strMin) && readString (in, att.strMax);
+
+		// if the file is cut off, we know nothing
+		if (!ok) {
+			pages.clear ();
+			return false;
+		}
+	}
+	sideFile = fName;
+	return true;
+}
+
+#endif
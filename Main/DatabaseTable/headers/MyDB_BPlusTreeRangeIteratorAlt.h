@@ -0,0 +1,71 @@
+
+#ifndef BPLUS_RANGE_ITER_ALT_H
+#define BPLUS_RANGE_ITER_ALT_H
+
+#include <functional>
+#include <vector>
+#include "MyDB_BPlusTreeReaderWriter.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+
+using namespace std;
+
+// This iterator returns the records in a range of keys from a B+-Tree, in sorted order.  It starts at a
+// given slot on a given leaf (the first record in the range), and then walks the leaves from left to
+// right by following their next links (see MyDB_PageLayout.h), so no leaf is looked at before the
+// iterator gets to it.  It stops for good at the first record that is past the high end of the range.
+// Other threads can append to the tree while the iterator is in use: each leaf is copied (while it is
+// latched) when the iterator gets to it, and no latch is held in between calls to advance ().  So a
+// record that is appended after the iterator has gone past its leaf is not returned.  If there is a
+// remove while the iterator is on a leaf, that leaf may have been merged away, so rather than follow
+// its link, the iterator finds its place again by going down the tree to the first record that is
+// bigger than the last one it returned (so in that case, it can miss records with the same key as
+// that one that are on later leaves)
+class MyDB_BPlusTreeRangeIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+        // load the current record into the parameter
+        void getCurrent (MyDB_RecordPtr intoMe) override;
+
+        // after a call to advance (), a call to getCurrentPointer () will get the address
+        // of the record; it points into the iterator's copy of the leaf, and so it is good
+        // until the iterator moves on to the next leaf
+        void *getCurrentPointer ();
+
+        // advance to the next record... returns true if there is a next record, and
+        // false if there are no more records to iterate over
+        bool advance () override;
+
+	// the iterator starts at slot firstSlot of page firstLeaf of the tree (if firstLeaf is -1, the
+	// iterator is empty), which is where the first record whose key is not less than low is; the
+	// caller must have that leaf latched, and version is the tree's structureVersion.  Each record is
+	// loaded into myRec, and once aboveHigh () is true, the iterator is done
+	MyDB_BPlusTreeRangeIteratorAlt (MyDB_BPlusTreeReaderWriter &parent, int firstLeaf, size_t firstSlot,
+		size_t version, MyDB_AttValPtr low, MyDB_RecordPtr myRec, function <bool ()> aboveHigh);
+	~MyDB_BPlusTreeRangeIteratorAlt ();
+
+private:
+
+	MyDB_BPlusTreeReaderWriter &parent;
+
+	// the current leaf, a copy of it, the slot of the current record on it, and the slot of the first
+	// record in the range on it
+	int curPage;
+	vector <char> curLeaf;
+	size_t curSlot;
+	size_t firstSlot;
+
+	// the tree's structureVersion when the leaf was copied, and where to pick up if it has changed by
+	// the time we go on to the next leaf: right after resumeKey (or at it, if nothing has been
+	// returned yet)
+	size_t version;
+	MyDB_AttValPtr resumeKey;
+	bool resumeAfter;
+
+	MyDB_RecordPtr myRec;
+	function <bool ()> aboveHigh;
+	bool done;
+};
+
+#endif
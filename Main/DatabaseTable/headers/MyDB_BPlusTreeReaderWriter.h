@@ -4,11 +4,15 @@
 #ifndef BPLUS_H
 #define BPLUS_H
 
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <functional>
 #include "MyDB_BufferManager.h"
 #include "MyDB_Record.h"
 #include "MyDB_INRecord.h"
+#include "MyDB_Latch.h"
+#include "MyDB_PageReaderWriter.h"
 #include "MyDB_RecordIterator.h"
 #include "MyDB_RecordIteratorAlt.h"
 #include "MyDB_Table.h"
@@ -20,18 +24,54 @@ class MyDB_PageReaderWriter;
 class MyDB_BPlusTreeReaderWriter;
 typedef shared_ptr <MyDB_BPlusTreeReaderWriter> MyDB_BPlusTreeReaderWriterPtr;
 
+// Any number of threads can use lookup, contains, getRangeIteratorAlt, getSortedRangeIteratorAlt, and
+// append on the same tree at once.  Each page of the tree has a latch (see MyDB_Latch.h), and a thread
+// going down the tree latches a child before it lets go of the parent, so the parent can't be changed
+// under it.  A reader holds shared latches.  A writer first goes down with shared latches, holding
+// only the leaf exclusively; this is all it needs unless the leaf is full.  In that case, the writer
+// starts over, this time holding the whole path from the root exclusively (and the leaf before its
+// leaf, whose next link changes when the leaf splits), so that it can split the nodes on the way back
+// up.  Leaves are latched from left to right by range scans, so a writer never waits for the latch on
+// the leaf before its leaf; if it can't get it right away, it lets go of everything and tries again.
+// A remove can be used alongside all of these, but it moves records between pages without latching
+// them, so it waits until no other thread is using the tree, and then has the tree to itself.
+// The other methods (clear, bulkLoad, loadFromTextFile, printTree, and the iterators over the whole
+// table) can't be used while any other thread is using the tree
 class MyDB_BPlusTreeReaderWriter : public MyDB_TableReaderWriter {
 
 public:
 
 	/* NOTE THAT EACH OF THESE METHODS ARE REQUIRED */
 
-	// create a BTree TableReaderWriter
+	// create a BTree TableReaderWriter.  Page 0 of the file is a metadata page that has the location of
+	// the root, the height of the tree, the attribute that the tree is on and its type, the number of
+	// records, and the list of free pages; it is kept up to date as the tree changes.  If the file
+	// already has a tree on the same attribute (for example, if forMe was read from the catalog), then
+	// that tree is opened as-is, and it can be used right away.  Otherwise, the tree starts out empty.
+	// A tree on a dictionary-encoded attribute is ordered by the actual values, not by their codes
 	MyDB_BPlusTreeReaderWriter (string nameOfAttToOrderOn, MyDB_TablePtr forMe, MyDB_BufferManagerPtr myBuffer);
 
+	// empties out the tree
+	void clear () override;
+
+	// the number of levels in the tree, counting the leaves (zero if the tree is empty), and the number
+	// of records in it
+	int getHeight ();
+	size_t getNumEntries ();
+
+	// when records are appended in increasing order, each one goes at the end of the last leaf, so
+	// splitting a full page in half would leave every page half empty.  Instead, when the record (or
+	// the entry for a new page) goes at the very end of the last page on its level, the new page is
+	// filled until fillFactor of it is used, and the rest stays on the old page.  The default is 0.9,
+	// which leaves some room for records that come out of order; it is kept in the metadata page
+	void setFillFactor (double fillFactor);
+	double getFillFactor ();
+
         // gets an instance of an alternate iterator over the table... this is an
         // iterator that has the alternate getCurrent ()/advance () interface
-	// return all records with a key value in the range [low, high], inclusive
+	// return all records with a key value in the range [low, high], inclusive.  The tree is searched
+	// once for the first record in the range, and the iterator then walks the linked leaves (see
+	// MyDB_BPlusTreeRangeIteratorAlt.h), so the records actually come back sorted
         MyDB_RecordIteratorAltPtr getRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high);
 	
         // gets an instance of an alternate iterator over the table... this is an
@@ -39,9 +79,43 @@ public:
 	// return all records with a key value in the range [low, high], inclusive
         MyDB_RecordIteratorAltPtr getSortedRangeIteratorAlt (MyDB_AttValPtr low, MyDB_AttValPtr high);
 	
+	// finds a record whose key is equal to key, by going straight down the tree to the one leaf that
+	// can have it.  If there is such a record, the first one (if there are several) is loaded into
+	// intoMe and true is returned; otherwise, false is returned, and intoMe may have been changed.  To
+	// get all of the records with the key, use getRangeIteratorAlt (key, key)
+	bool lookup (MyDB_AttValPtr key, MyDB_RecordPtr intoMe);
+
+	// true if there is a record in the tree with the given key
+	bool contains (MyDB_AttValPtr key);
+
 	// append a record to the B+-Tree
 	void append (MyDB_RecordPtr appendMe);
 
+	// removes all of the records whose key is equal to key, and returns how many there were.  A page
+	// that ends up less than a quarter full gets records from the page next to it, or is merged with
+	// it; a root with only one child is removed; and the pages that are no longer used go on the list
+	// of free pages, where later appends find them
+	size_t remove (MyDB_AttValPtr key);
+
+	// removes one record that is exactly the same as removeMe (every attribute, not just the key);
+	// returns false if there is no such record
+	bool remove (MyDB_RecordPtr removeMe);
+
+	// builds the tree from scratch (anything that was in it is thrown away) out of the records given by
+	// sortedRecs, which must come in sorted order on the ordering attribute; for example, the iterator
+	// built by buildItertorOverSortedRuns.  Rather than appending the records one at a time, this packs
+	// them into leaves from left to right, filling each leaf until fillFactor of the page is used, and
+	// then builds each level of internal nodes over the level below in the same way.  So no page is
+	// ever split, and (with a fill factor of 1) every page but the last one on each level is full.  A
+	// smaller fill factor leaves room on each page for records that are appended later
+	void bulkLoad (MyDB_RecordIteratorAltPtr sortedRecs, double fillFactor = 1.0);
+
+	// empties out the tree, and then loads a text file into it, with numThreads worker threads parsing
+	// the file (see MyDB_TableReaderWriter.loadFromTextFile); the parsed records are appended to the
+	// tree one at a time.  The one-threaded version (which also appends) is the same as for any table
+	using MyDB_TableReaderWriter :: loadFromTextFile;
+	pair <vector <size_t>, size_t> loadFromTextFile (string fromMe, int numThreads) override;
+
 	// print the contents of the tree to the screen
 	void printTree ();
 
@@ -50,20 +124,90 @@ private:
 	/* NOTE THAT EACH OF THESE METHODS ARE OPTIONAL.  They are a suggestion for a set of helper
            methods that you might consider including in order to get your stuff to work. */
 
-	// gets a list of pages that might have data for an iterator... any leaf page that can possibly
-	// have a value in the range [low, high], inclusive should be returned from this call
-	bool discoverPages (int whichPage, vector <MyDB_PageReaderWriter> &list,
-        	MyDB_AttValPtr low, MyDB_AttValPtr high);
+	// finds the first record in the tree whose key is not less than low (or, if strict is true, whose
+	// key is bigger than low): returns the leaf, and sets whichSlot to the record's slot on it (which
+	// may be one past the last record on the leaf, in which case the record is at the start of the
+	// next leaf).  The leaf is left with a shared latch on it, which the caller has to let go of.
+	// Returns -1 (and holds no latch) if the tree is empty
+	int findLowerBound (MyDB_AttValPtr low, size_t &whichSlot, bool strict = false);
 
-	// appends a record to the named page; if there is a split, then an MyDB_INRecordPtr is returned that
-	// points to the record holding the (key, ptr) pair pointing to the new page.  Note that the new page
-	// always holds the lower 1/2 of the records on the page; the upper 1/2 remains in the original page
+	// given a leaf, copies the leaf after it into intoMe, sets whichSlot to zero, and returns its number,
+	// or returns -1 if there is no leaf after it; this is how a range scan moves from leaf to leaf.  The
+	// scan copied the leaf when structureVersion was version; if there has been a remove since then,
+	// the leaf's link can't be trusted, so version is brought up to date, and the leaf that is copied
+	// is the one found by findLowerBound (resumeKey, whichSlot, strict) instead
+	int copyNextLeaf (int whichPage, size_t &version, MyDB_AttValPtr resumeKey, bool strict,
+		vector <char> &intoMe, size_t &whichSlot);
+
+	// gets the latch for a page
+	MyDB_Latch &getLatch (int whichPage);
+
+	// latches a page, and returns it pinned, so it can't be swapped out while it is latched
+	MyDB_PageReaderWriter latchPage (int whichPage, bool exclusive);
+	void unlatchPage (int whichPage, bool exclusive);
+
+	// tries to append a record by going down the tree holding only the leaf exclusively; returns
+	// false (having changed nothing) if the leaf is full
+	bool appendToLeaf (MyDB_RecordPtr appendMe);
+
+	// appends a record, holding the whole path to its leaf exclusively, so that nodes can be split
+	void appendWithSplits (MyDB_RecordPtr appendMe);
+
+	// appends a record to the named page; if there is a split (see split), then an MyDB_INRecordPtr is
+	// returned that points to the record holding the (key, ptr) pair pointing to the new page, which
+	// holds the lower records from the page.  The records on every page (leaves and internal nodes alike) are kept sorted, so the record is
+	// inserted in its place, and the child to go to in an internal node is found with a binary search
 	MyDB_RecordPtr append (int whichPage, MyDB_RecordPtr appendMe);
 
-	// splits the given page (plus the record andMe) around the median.  A MyDB_INRecordPtr is returned that
-	// points to the record holding the (key, ptr) pair pointing to the new page.  Note that the new page
-	// always holds the lower 1/2 of the records on the page; the upper 1/2 remains in the original page
-	MyDB_RecordPtr split (MyDB_PageReaderWriter splitMe, MyDB_RecordPtr andMe);
+	// removes up to limit records whose key is equal to key (and that are the same as the serialized
+	// record exact, unless it is null); returns how many were removed
+	size_t remove (MyDB_AttValPtr key, void *exact, size_t limit);
+
+	// removes up to limit records with the key of keyRec (and that are the same as exact, unless it is
+	// null) from the subtree under the given page, and returns how many were removed.  The children
+	// of an internal node that end up underfull are fixed before it returns
+	size_t remove (int whichPage, MyDB_INRecordPtr keyRec, void *exact, size_t limit);
+
+	// if the child at position whichChild of the internal node is less than a quarter full, it is
+	// merged with the child next to it if the two fit on one page; otherwise, records are moved from
+	// the fuller one to the other, so that they are about the same size
+	void fixChild (MyDB_PageReaderWriter &parentPage, size_t whichChild);
+
+	// splits the given sorted page (plus the record andMe, which belongs at position where); the lower
+	// records go to a new page, and the rest stay on the original one.  Usually the split is at the
+	// median, but if andMe goes at the very end of the last page on the level (see setFillFactor), the
+	// new page is filled until fillFactor of it is used, and only the records after that stay behind.
+	// A MyDB_INRecordPtr is returned that points to the record holding the (key, ptr) pair pointing to
+	// the new page.  Both pages are still sorted, and if they are leaves, the new page is linked into
+	// the list of leaves right before the original one
+	MyDB_RecordPtr split (int whichPage, MyDB_RecordPtr andMe, size_t where);
+
+	// the internal nodes of a tree on an int or a double attribute are arrays of keys and children (see
+	// MyDB_KeyArrayNode.h); otherwise, they are pages of IN records.  These work on internal nodes of
+	// either kind; scratch is an IN record that the search can use, if it needs one.  findEntry finds
+	// the position of the first entry whose key is not less than the key of keyRec (or, if strict is
+	// true, bigger than it); keyRec can be an IN record or a data record
+	size_t findEntry (MyDB_PageReaderWriter &page, MyDB_INRecordPtr scratch, MyDB_RecordPtr keyRec, bool strict);
+	int getChild (MyDB_PageReaderWriter &page, size_t whichEntry, MyDB_INRecordPtr scratch);
+
+	// puts the entry (an IN record) at position where on an internal node; returns false if it is full
+	bool insertEntry (MyDB_PageReaderWriter &page, size_t where, MyDB_RecordPtr entry);
+
+	// gets the records on a page (leaf or internal node) in order, serialized; the entries of an internal
+	// node come back as IN records.  They are copied into storage, so the page can then be re-written
+	void getRecords (MyDB_PageReaderWriter &page, vector <char> &storage, vector <void *> &recs);
+
+	// re-writes the page so that it holds recs[from, to) (as given by getRecords), in order; the page
+	// keeps its type and its links
+	void setRecords (MyDB_PageReaderWriter &page, vector <void *> &recs, size_t from, size_t to);
+
+	// the number of bytes that a page of the given type needs for recs[from, to) (as given by getRecords)
+	size_t getBytesNeeded (MyDB_PageType type, vector <void *> &recs, size_t from, size_t to);
+
+	// binary search over a sorted page: finds the position of the first record on the page whose key is
+	// bigger than the key of the given record.  Each record on the page is loaded into pageRec, which
+	// must be an IN record for an internal node, and a data record for a leaf
+	size_t upperBound (MyDB_PageReaderWriter &page, MyDB_RecordPtr pageRec, MyDB_RecordPtr key);
 
 	// constructs and returns an empty internal node record for this particular tree
 	MyDB_INRecordPtr getINRecord ();
@@ -71,6 +215,12 @@ private:
 	// gets the search key from a LN record
 	MyDB_AttValPtr getKey (MyDB_RecordPtr fromMe);
 
+	// gets the key for the entry of a leaf whose largest key is lower, when the leaf after it starts with
+	// upper.  Any key that is not less than lower and is less than upper will do, so for a string key,
+	// this is the shortest prefix of upper that is bigger than lower (which keeps the internal nodes
+	// small when the keys are long); if there is none, or the key is not a string, it is lower
+	MyDB_AttValPtr getSeparator (MyDB_AttValPtr lower, MyDB_AttValPtr upper);
+
 	// constructs an returns a comparator for the two records given... both must either be IN records for this particular
 	// tree, or they must be LN records for this tree, or a combination.  The resulting comparator returns true if and
 	// only if the first record has a key value less than the second record
@@ -78,15 +228,66 @@ private:
 
 	function <bool ()> buildEqualToComparator (MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
 
-	// the location (page number) of the root in the tree
+	// reads the metadata page, if there is one for a tree on this attribute; returns false if not
+	bool readMeta ();
+
+	// writes the metadata page
+	void writeMeta ();
+
+	// gets an empty page for the tree, re-using a free page if there is one
+	int allocatePage ();
+
+	// puts a page that is no longer used by the tree on the list of free pages
+	void freePage (int whichPage);
+
+	// the location (page number) of the root in the tree; this (and the height) can only be changed
+	// by a thread that holds rootLatch exclusively
 	int rootLocation;
+	MyDB_Latch rootLatch;
+
+	// held shared by every method that can be used by several threads at once, and exclusively by a
+	// remove; structureVersion goes up by one with every remove that changes the tree
+	MyDB_Latch treeLatch;
+	size_t structureVersion;
+
+	// the latches for the pages, by page number; latchesMutex is held to find one
+	deque <MyDB_Latch> latches;
+	mutex latchesMutex;
+
+	// held to change the metadata (or the table's statistics), and to write the metadata page, which
+	// is always pinned
+	mutex metaMutex;
+	MyDB_PageReaderWriterPtr metaPage;
+
+	// the pages that have been allocated while appending a record; they are kept pinned until it is done
+	vector <MyDB_PageReaderWriter> newPages;
+
+	// the number of levels, and the number of records
+	int height;
+	size_t numEntries;
+
+	// how full the new page is made by a split at the right edge of a level
+	double fillFactor;
+
+	// the first page on the list of free pages (which are linked through their next links; see
+	// MyDB_PageLayout.h), or -1 if there are none
+	int freeList;
 
 	// the type of the attribute that we are ordering on
 	MyDB_AttTypePtr orderingAttType;
 
+	// the type of the keys in the internal nodes; this is the type of the attribute, except that for a
+	// dictionary-encoded attribute, the keys are the actual values (the codes are not in order)
+	MyDB_AttTypePtr keyAttType;
+
+	// true if the internal nodes are arrays of keys, and if so, true if the keys are ints (not doubles)
+	bool keyArrays;
+	bool intKeys;
+
 	// the number of the attribute that we are ordering on, in the data records
 	int whichAttIsOrdering;
 
+	friend class MyDB_BPlusTreeRangeIteratorAlt;
 };
 
 #endif
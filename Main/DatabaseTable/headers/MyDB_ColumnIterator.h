@@ -0,0 +1,104 @@
+
+#ifndef COLUMN_ITER_H
+#define COLUMN_ITER_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "MyDB_PageReaderWriter.h"
+#include "MyDB_TableReaderWriter.h"
+#include "MyDB_Value.h"
+
+using namespace std;
+
+// create a smart pointer for column iterators
+class MyDB_ColumnIterator;
+typedef shared_ptr <MyDB_ColumnIterator> MyDB_ColumnIteratorPtr;
+
+// a batch of records from a table, holding only some of the attributes ("columns"), with all of the
+// values for each column stored together.  For a PAX table (see MyDB_PaxPage.h), the columns are just
+// the minipages of one of the table's pages, so nothing is decoded or copied until it is asked for
+class MyDB_ColumnBatch {
+
+public:
+
+	// the number of records in the batch
+	size_t getNumRows ();
+
+	// the number of columns, and the type of each one; the columns are in the order asked for
+	size_t getNumCols ();
+	MyDB_ValueType getType (size_t whichCol);
+
+	// for an int, double, or bool column, gets the array of values (for a PAX table, this points right
+	// into the page); the type of the column must match
+	int *getInts (size_t whichCol);
+	double *getDoubles (size_t whichCol);
+	char *getBools (size_t whichCol);
+
+	// gets one value out of the batch; this works for any column, and does not allocate
+	MyDB_Value getValue (size_t whichCol, size_t whichRow);
+
+	// a dictionary-encoded column is an int column that holds the codes; this gets the dictionary
+	// to decode them (or nullptr, if the column is not dictionary-encoded)
+	MyDB_DictionaryPtr getDictionary (size_t whichCol);
+
+private:
+
+	friend class MyDB_ColumnIterator;
+
+	// each column is laid out just like a minipage, from start up to end
+	struct Column {
+		MyDB_ValueType type;
+		char *start;
+		char *end;
+		MyDB_DictionaryPtr dictionary;
+	};
+
+	vector <Column> cols;
+	size_t numRows;
+
+	// when the batch comes from a regular page, the columns are copied out of the records into here
+	vector <vector <char>> copies;
+};
+
+// iterates through a table a batch at a time, where each batch holds the records on one page.  Records
+// on a PAX page are not decoded at all; records on a regular page have the requested columns copied
+// out, without ever being deserialized
+class MyDB_ColumnIterator {
+
+public:
+
+	// moves on to the next batch... returns false if there are no more records
+	bool advance ();
+
+	// gets the current batch; the batch is good until the next call to advance ()
+	MyDB_ColumnBatch &getCurrent ();
+
+	// iterate through the given attributes of the table
+	MyDB_ColumnIterator (MyDB_TableReaderWriter &myParent, vector <string> atts);
+	~MyDB_ColumnIterator ();
+
+private:
+
+	// fills the batch with the requested columns of the records on a regular page
+	void copyColumns (MyDB_PageReaderWriter &fromMe);
+
+	MyDB_TableReaderWriter &myParent;
+
+	// the attributes that were asked for, and their types and dictionaries
+	vector <int> whichAtts;
+	vector <MyDB_ValueType> types;
+	vector <MyDB_DictionaryPtr> dictionaries;
+
+	// the page that the current batch is from; it is pinned, so that the batch can point into it
+	int curPage;
+	shared_ptr <MyDB_PageReaderWriter> pinnedPage;
+
+	MyDB_ColumnBatch batch;
+
+	// scratch space used by copyColumns
+	vector <uint32_t> ends;
+	vector <char> chars;
+};
+
+#endif
@@ -0,0 +1,47 @@
+
+#ifndef FILTERED_REC_ITER_ALT_H
+#define FILTERED_REC_ITER_ALT_H
+
+#include "MyDB_RecordIteratorAlt.h"
+#include "MyDB_Record.h"
+#include <string>
+
+using namespace std;
+
+// wraps up another alternate iterator, and only returns the records that satisfy a selection
+// predicate.  When the predicate is a simple comparison of an attribute with a constant, it is
+// evaluated directly over the serialized bytes of each record (see
+// MyDB_Record.compileBinaryPredicate), so the records that do not qualify are never deserialized
+class MyDB_FilteredRecIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+        // load the current record into the parameter
+        void getCurrent (MyDB_RecordPtr intoMe) override;
+
+        // after a call to advance (), a call to getCurrentPointer () will get the address
+        // of the record.  At a later time, it is then possible to reconstitute the record
+        // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
+        // the record is located on has not been swapped out
+        void *getCurrentPointer () override;
+
+        // advance to the next record that satisfies the predicate... returns true if there is
+        // one, and false if there are no more records to iterate over
+        bool advance () override;
+
+	// the predicate is compiled over the record scratch, which must have the schema of the
+	// records returned by input; scratch is used to test predicates that have no fast path
+	MyDB_FilteredRecIteratorAlt (MyDB_RecordIteratorAltPtr input, MyDB_RecordPtr scratch, string pred);
+	~MyDB_FilteredRecIteratorAlt ();
+
+private:
+
+	MyDB_RecordIteratorAltPtr input;
+	MyDB_RecordPtr scratch;
+
+	// exactly one of these is used
+	binaryPred fastPred;
+	function <bool ()> slowPred;
+};
+
+#endif
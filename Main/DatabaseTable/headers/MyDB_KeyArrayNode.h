@@ -0,0 +1,87 @@
+
+#ifndef KEY_ARRAY_NODE_H
+#define KEY_ARRAY_NODE_H
+
+#include <cstddef>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "MyDB_PageLayout.h"
+
+// This is the layout of an internal node of a B+-Tree on an int or a double attribute (see
+// MyDB_BPlusTreeReaderWriter.h).  Rather than a page of serialized (key, ptr) IN records, which have
+// to be deserialized one at a time as the node is searched, the node is two arrays: right after the
+// usual page header (see MyDB_PageLayout.h), whose number of slots is the number of entries, come the
+// keys, in order, and then the children, each array with room for as many entries as fit on the page.
+// So a search only touches the keys, which are next to each other in memory; it narrows the keys down
+// with a binary search, and then counts the ones that are too small, which (with SSE2) is done four
+// ints or two doubles at a time
+
+// the number of entries that fit on a node of the given size
+template <class KeyType>
+inline size_t getNodeCapacity (size_t pageSize) {
+	return (pageSize - PAGE_HEADER_SIZE) / (sizeof (KeyType) + sizeof (int));
+}
+
+template <class KeyType>
+inline KeyType *getNodeKeys (void *page) {
+	return (KeyType *) (((char *) page) + PAGE_HEADER_SIZE);
+}
+
+template <class KeyType>
+inline int *getNodeChildren (void *page, size_t pageSize) {
+	return (int *) (((char *) page) + PAGE_HEADER_SIZE + getNodeCapacity <KeyType> (pageSize) * sizeof (KeyType));
+}
+
+// counts the keys in [from, to) that are less than key (or, if orEqual is true, not bigger than key)
+inline size_t countBelow (int *keys, size_t from, size_t to, int key, bool orEqual) {
+	size_t count = 0;
+	size_t i = from;
+#ifdef __SSE2__
+	__m128i compareTo = _mm_set1_epi32 (key);
+	for (; i + 4 <= to; i += 4) {
+		__m128i vals = _mm_loadu_si128 ((__m128i *) (keys + i));
+		// there is no <= for ints, so for orEqual we count the ones that are bigger, and take the rest
+		__m128i hits = orEqual ? _mm_cmpgt_epi32 (vals, compareTo) : _mm_cmplt_epi32 (vals, compareTo);
+		int mask = _mm_movemask_ps (_mm_castsi128_ps (hits));
+		count += orEqual ? 4 - __builtin_popcount (mask) : __builtin_popcount (mask);
+	}
+#endif
+	for (; i < to; i++)
+		count += orEqual ? (keys[i] <= key) : (keys[i] < key);
+	return count;
+}
+
+inline size_t countBelow (double *keys, size_t from, size_t to, double key, bool orEqual) {
+	size_t count = 0;
+	size_t i = from;
+#ifdef __SSE2__
+	__m128d compareTo = _mm_set1_pd (key);
+	for (; i + 2 <= to; i += 2) {
+		__m128d vals = _mm_loadu_pd (keys + i);
+		__m128d below = orEqual ? _mm_cmple_pd (vals, compareTo) : _mm_cmplt_pd (vals, compareTo);
+		count += __builtin_popcount (_mm_movemask_pd (below));
+	}
+#endif
+	for (; i < to; i++)
+		count += orEqual ? (keys[i] <= key) : (keys[i] < key);
+	return count;
+}
+
+// finds the position of the first key on the node that is not less than key (or, if strict is true,
+// that is bigger than key), or the number of keys if there is none
+template <class KeyType>
+inline size_t searchNode (void *page, KeyType key, bool strict) {
+	KeyType *keys = getNodeKeys <KeyType> (page);
+	size_t low = 0, high = getPageNumSlots (page);
+	while (high - low > 32) {
+		size_t mid = (low + high) / 2;
+		if (strict ? keys[mid] <= key : keys[mid] < key)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low + countBelow (keys, low, high, key, strict);
+}
+
+#endif
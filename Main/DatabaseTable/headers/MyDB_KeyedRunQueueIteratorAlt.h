@@ -0,0 +1,49 @@
+
+#ifndef KEYED_RUN_Q_ITER_ALT_H
+#define KEYED_RUN_Q_ITER_ALT_H
+
+#include "MyDB_RecordIteratorAlt.h"
+#include "MyDB_SortKey.h"
+#include <string>
+#include <vector>
+
+using namespace std;
+class MyDB_KeyedRunQueueIteratorAlt;
+typedef shared_ptr <MyDB_KeyedRunQueueIteratorAlt> MyDB_KeyedRunQueueIteratorAltPtr;
+
+// this is like a MyDB_RunQueueIteratorAlt, except that the runs are merged using normalized keys
+// (see MyDB_SortKey.h).  The key for the current record in each run is built once, when the run
+// is advanced, and then the heap just compares keys, so records are never deserialized
+class MyDB_KeyedRunQueueIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+        // load the current record into the parameter
+        void getCurrent (MyDB_RecordPtr intoMe) override;
+
+        // get the address of the current record (see MyDB_RecordIteratorAlt.h)
+        void *getCurrentPointer () override;
+
+        // advance to the next record... returns true if there is a next record, and
+        // false if there are no more records to iterate over
+        bool advance () override;
+
+	// build an iterator that merges runs using the given sort key
+	MyDB_KeyedRunQueueIteratorAlt (MyDB_SortKeyPtr sortKey);
+
+	// add a sorted run to the merge; the run should not have been advanced yet
+	void addRun (MyDB_RecordIteratorAltPtr addMe);
+
+	~MyDB_KeyedRunQueueIteratorAlt ();
+
+private:
+
+	// each run, along with the key of its current record; this is kept as a heap, with the run
+	// having the smallest key at the front
+	vector <pair <string, MyDB_RecordIteratorAltPtr>> runs;
+
+	MyDB_SortKeyPtr sortKey;
+	bool firstTime;
+};
+
+#endif
@@ -0,0 +1,61 @@
+
+#ifndef LATCH_H
+#define LATCH_H
+
+#include <condition_variable>
+#include <mutex>
+
+using namespace std;
+
+// A latch that can be held by any number of readers (shared) or by one writer (exclusive); this is
+// used to protect a single page of a B+-Tree (see MyDB_BPlusTreeReaderWriter.h) while a thread is
+// looking at it or changing it.  Readers are not made to wait for writers that are waiting, so a
+// thread can always get a shared latch on a page while it holds one on another page
+class MyDB_Latch {
+
+public:
+
+	MyDB_Latch () : numReaders (0), writing (false) {}
+
+	void lockShared () {
+		unique_lock <mutex> lock (myMutex);
+		canGo.wait (lock, [this] {return !writing;});
+		numReaders++;
+	}
+
+	void unlockShared () {
+		lock_guard <mutex> lock (myMutex);
+		if (--numReaders == 0)
+			canGo.notify_all ();
+	}
+
+	void lockExclusive () {
+		unique_lock <mutex> lock (myMutex);
+		canGo.wait (lock, [this] {return !writing && numReaders == 0;});
+		writing = true;
+	}
+
+	// gets the latch exclusively if no one else has it; returns false (without waiting) if someone does
+	bool tryLockExclusive () {
+		lock_guard <mutex> lock (myMutex);
+		if (writing || numReaders != 0)
+			return false;
+		writing = true;
+		return true;
+	}
+
+	void unlockExclusive () {
+		lock_guard <mutex> lock (myMutex);
+		writing = false;
+		canGo.notify_all ();
+	}
+
+private:
+
+	mutex myMutex;
+	condition_variable canGo;
+	int numReaders;
+	bool writing;
+};
+
+#endif
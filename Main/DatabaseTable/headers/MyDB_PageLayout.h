@@ -0,0 +1,52 @@
+
+#ifndef PAGE_LAYOUT_H
+#define PAGE_LAYOUT_H
+
+#include <cstdint>
+#include <cstring>
+#include "MyDB_PageType.h"
+
+// This is the layout of a page that holds records.  A page starts with a header made up of five
+// size_t values: the type of the page, the number of bytes that are used on the page (by the header,
+// the slots, and the records), the number of records on the page, and the numbers of the next and
+// previous pages in a list of pages (NO_PAGE if there is none; this is how the leaves of a B+-Tree
+// are linked together, in key order).  Right after the header is the
+// slot directory, which has one MyDB_SlotType for each record, giving the offset of the record from
+// the start of the page.  The slot directory grows from the front of the page and the records are
+// written from the back of the page towards the front, so the free space is in the middle.  The order
+// of the records on the page is the order of the slots, not of the records themselves, so the records
+// can be re-ordered (say, sorted) by just permuting the slots, and the i^th record can be found in O(1)
+typedef uint32_t MyDB_SlotType;
+
+#define PAGE_HEADER_SIZE (5 * sizeof (size_t))
+#define NO_PAGE ((size_t) -1)
+
+inline MyDB_PageType &getPageType (void *page) {
+	return *((MyDB_PageType *) page);
+}
+
+inline size_t &getPageBytesUsed (void *page) {
+	return *((size_t *) (((char *) page) + sizeof (size_t)));
+}
+
+inline size_t &getPageNumSlots (void *page) {
+	return *((size_t *) (((char *) page) + 2 * sizeof (size_t)));
+}
+
+inline size_t &getPageNext (void *page) {
+	return *((size_t *) (((char *) page) + 3 * sizeof (size_t)));
+}
+
+inline size_t &getPagePrev (void *page) {
+	return *((size_t *) (((char *) page) + 4 * sizeof (size_t)));
+}
+
+inline MyDB_SlotType *getPageSlots (void *page) {
+	return (MyDB_SlotType *) (((char *) page) + PAGE_HEADER_SIZE);
+}
+
+inline void *getPageRecord (void *page, size_t whichSlot) {
+	return ((char *) page) + getPageSlots (page)[whichSlot];
+}
+
+#endif
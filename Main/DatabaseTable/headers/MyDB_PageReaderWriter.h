@@ -17,7 +17,9 @@
 #include "MyDB_PageType.h"
 #include "MyDB_RecordIterator.h"
 #include "MyDB_RecordIteratorAlt.h"
+#include "MyDB_SortKey.h"
 #include "MyDB_TableReaderWriter.h"
+#include "MyDB_TypedRecord.h"
 
 using namespace std;
 class MyDB_PageReaderWriter;
@@ -43,6 +45,12 @@ public:
 	// the type of the page is set to MyDB_PageType :: RegularPage
 	void clear ();	
 
+	// empties out the contents of this page, and makes it a PAX page (see MyDB_PaxPage.h) for
+	// records with the given schema; the type of the page is set to MyDB_PageType :: PaxPage.
+	// Records are appended to a PAX page and iterated over just like on a regular page, but they
+	// can't be accessed by position, sorted, or written with appendBytes
+	void clearPax (MyDB_SchemaPtr forMe);
+
 	// return an itrator over this page... each time returnVal->next () is
 	// called, the resulting record will be placed into the record pointed to
 	// by iterateIntoMe
@@ -64,6 +72,59 @@ public:
 	// a nullptr
 	void *appendAndReturnLocation (MyDB_RecordPtr appendMe);
 
+	// appends a typed record to this page (see MyDB_TypedRecord.h)... return false if the
+	// append fails because there is not enough space on the page; otherwise, return true
+	template <class... Atts>
+	bool append (const MyDB_TypedRecord <Atts...> &appendMe) {
+		if (getType () == MyDB_PageType :: PaxPage) {
+			vector <char> recBytes (appendMe.getBinarySize ());
+			appendMe.toBinary (recBytes.data ());
+			return appendBinary (recBytes.data ());
+		}
+		void *loc = appendBytes (appendMe.getBinarySize ());
+		if (loc == nullptr)
+			return false;
+		appendMe.toBinary (loc);
+		return true;
+	}
+
+	// appends a record that has already been serialized (as by MyDB_Record.toBinary) to this
+	// page; return false if there is not enough space on the page
+	bool appendBinary (void *serializedRec);
+
+	// reserves numBytes on the page for a new record (which becomes the last record on the page),
+	// and returns the location where the record should be written; if there is not enough space,
+	// returns nullptr
+	void *appendBytes (size_t numBytes);
+
+	// inserts a record into this page, so that it becomes the whereth record on the page (the records
+	// from that position on move down by one); only the slots move, not the records.  Return false if
+	// there is not enough space on the page.  This can't be used on a PAX page
+	bool insert (size_t where, MyDB_RecordPtr insertMe);
+
+	// the page is slotted (see MyDB_PageLayout.h), so the records can be accessed by position
+	size_t getNumRecords ();
+
+	// gets a pointer to the serialized bytes of the whichRec^th record on the page
+	void *getRecordPointer (size_t whichRec);
+
+	// loads the whichRec^th record on the page into intoMe
+	void getRecord (size_t whichRec, MyDB_RecordPtr intoMe);
+
+	// binary search over a sorted page: returns the position of the first record on the page for
+	// which comparator is false (or the number of records, if there is no such record).  Each record
+	// on the page is loaded into lhs, and comparator is a lambda built with buildRecordComparator
+	// that checks whether lhs is less than the record (or key) that it was built with
+	size_t lowerBound (function <bool ()> comparator, MyDB_RecordPtr lhs);
+
+	// gets/sets the numbers of the next and previous pages in the list of pages that this one is in
+	// (see MyDB_PageLayout.h); -1 means that there is no such page.  Clearing a page takes it out of
+	// its list, but the pages that it was linked to are not changed
+	int getNextPage ();
+	void setNextPage (int toMe);
+	int getPrevPage ();
+	void setPrevPage (int toMe);
+
 	// gets the type of this page... this is just a value from an ennumeration
 	// that is stored within the page
 	MyDB_PageType getType ();
@@ -80,14 +141,32 @@ public:
 	// like the above, except that the sorting is done in place, on the page
 	void sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs);
 
+	// sorts the contents of the page using normalized keys (see MyDB_SortKey.h)... the records
+	// are never deserialized: a key is built for each record, the keys are sorted, and then the
+	// slots are written in the sorted order.  For all of the sorts, the records' bytes never move
+	MyDB_PageReaderWriterPtr sort (MyDB_SortKeyPtr sortKey);
+
+	// like the above, except that the sorting is done in place, on the page
+	void sortInPlace (MyDB_SortKeyPtr sortKey);
+
 	// returns the page size
 	size_t getPageSize ();
 
 	// returns the actual bytes
 	void *getBytes ();
 
+	// marks the page as changed, after its bytes have been changed directly (through getBytes)
+	void wroteBytes ();
+
 private:
 
+	// builds a normalized key for each of the records in the page image stored at fromHere,
+	// and sorts them, writing the sorted order into the page's slots; the keys are written to the arena
+	void getSortedKeys (void *fromHere, MyDB_SortKeyPtr sortKey, vector <MyDB_KeyedRec> &recs, string &arena);
+
+	// makes this page an exact copy of the other one
+	void copyFrom (MyDB_PageReaderWriter &fromMe);
+
 	// this is the page that we are messing with
 	MyDB_PageHandle myPage;	
 	
@@ -40,7 +40,8 @@ public:
 
 private:
 
-	int bytesConsumed;
+	// the slot of the next record
+	size_t curSlot;
 	MyDB_PageHandle myPage;
 	MyDB_RecordPtr myRec;
 	
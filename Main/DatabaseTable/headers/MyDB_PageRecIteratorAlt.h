@@ -31,8 +31,9 @@ public:
         void *getCurrentPointer ();
 
         // advance to the next record... returns true if there is a next record, and
-        // false if there are no more records to iterate over.  Not that this cannot
-        // be called until after getCurrent () has been called
+        // false if there are no more records to iterate over.  Unlike some of the other
+        // iterators, this can be called without first calling getCurrent (), so records
+        // that are not needed never have to be deserialized
         bool advance () override;
 
 	// destructor and contructor
@@ -41,8 +42,8 @@ public:
 
 private:
 
-	int bytesConsumed;
-	int nextRecSize;
+	// the slot of the current record
+	size_t curSlot;
 	MyDB_PageHandle myPage;
 };
 
@@ -0,0 +1,77 @@
+
+#ifndef PAX_PAGE_H
+#define PAX_PAGE_H
+
+#include <cstdint>
+#include <vector>
+#include "MyDB_PageLayout.h"
+#include "MyDB_Schema.h"
+#include "MyDB_Value.h"
+
+using namespace std;
+
+// This is the layout of a PAX page (a page of type PaxPage).  Rather than storing the records one after
+// another, a PAX page is split into "minipages", one per attribute, and each minipage holds the values
+// of its attribute for all of the records on the page.  So a scan that only needs a couple of the
+// attributes only has to look at their minipages, and the values that it does look at are packed
+// together.  The page starts with the same three size_t values as a regular page (see MyDB_PageLayout.h),
+// except that the third one is the number of records, followed by the number of attributes, and then
+// a MyDB_MiniPage for each attribute.  An int, double, or bool minipage is just an array of values.  A
+// string minipage has an array of uint32_t "ends" that grows up from the start of the minipage, and
+// the strings (each with its zero byte) that grow down from the end of the minipage: the i^th string
+// ends ends[i-1] bytes before the end of the minipage, and starts ends[i] bytes before the end.
+//
+// When a record does not fit into one of the minipages, but there is enough room on the page, the
+// minipages are re-packed, with the free space split up among them in proportion to how full they are
+struct MyDB_MiniPage {
+	uint32_t type;
+	uint32_t start;
+	uint32_t capacity;
+	uint32_t used;
+};
+
+#define PAX_HEADER_SIZE (4 * sizeof (size_t))
+
+inline size_t &getPaxNumRecs (void *page) {
+	return getPageNumSlots (page);
+}
+
+inline size_t &getPaxNumAtts (void *page) {
+	return *((size_t *) (((char *) page) + 3 * sizeof (size_t)));
+}
+
+inline MyDB_MiniPage *getMiniPages (void *page) {
+	return (MyDB_MiniPage *) (((char *) page) + PAX_HEADER_SIZE);
+}
+
+// gets the type of each of the attributes in the schema
+vector <MyDB_ValueType> getPaxTypes (MyDB_SchemaPtr forMe);
+
+// makes the page an empty PAX page, with a minipage for each of the given types
+void formatPaxPage (void *page, size_t pageSize, vector <MyDB_ValueType> &types);
+
+// appends a record (serialized as by MyDB_Record.toBinary) to a PAX page; returns false if the
+// record does not fit on the page
+bool appendToPaxPage (void *page, size_t pageSize, void *serializedRec);
+
+// puts the whichRec^th record on a PAX page back together, in the format written by MyDB_Record.toBinary
+void getPaxRecord (void *page, size_t whichRec, vector <char> &intoMe);
+
+// gets the value of the whichRec^th record in the given minipage, which starts at start and ends at end
+inline MyDB_Value getMiniPageValue (MyDB_ValueType type, char *start, char *end, size_t whichRec) {
+	switch (type) {
+	case MyDB_ValueType :: IntVal:
+		return MyDB_Value :: fromInt (((int *) start)[whichRec]);
+	case MyDB_ValueType :: DoubleVal:
+		return MyDB_Value :: fromDouble (((double *) start)[whichRec]);
+	case MyDB_ValueType :: BoolVal:
+		return MyDB_Value :: fromBool (start[whichRec] != 0);
+	default: {
+		uint32_t *ends = (uint32_t *) start;
+		uint32_t from = (whichRec == 0) ? 0 : ends[whichRec - 1];
+		return MyDB_Value :: fromString (end - ends[whichRec], ends[whichRec] - from - 1);
+	}
+	}
+}
+
+#endif
@@ -0,0 +1,41 @@
+
+#ifndef PAX_PAGE_REC_ITER_H
+#define PAX_PAGE_REC_ITER_H
+
+#include <vector>
+#include "MyDB_PageHandle.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIterator.h"
+
+// an iterator over the records on a PAX page (see MyDB_PaxPage.h); each record is put back together
+// out of the page's minipages as it is reached
+class MyDB_PaxPageRecIterator : public MyDB_RecordIterator {
+
+public:
+
+	// put the contents of the next record in the page into the iterator record
+	// this should be called BEFORE the iterator record is first examined
+	void getNext () override;
+
+	// return true iff there is another record in the page
+	bool hasNext () override;
+
+        // BEFORE a call to getNext (), a call to getCurrentPointer () will get the address of the
+        // record.  Since the record does not exist on the page in its serialized form, this points
+        // to a copy that is owned by the iterator, and is only good until the next call to getNext ()
+        void *getCurrentPointer () override;
+
+	// destructor and contructor
+	MyDB_PaxPageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn); 
+	~MyDB_PaxPageRecIterator ();
+
+private:
+
+	// the next record, and the serialized version of it
+	size_t curRec;
+	vector <char> recBytes;
+	MyDB_PageHandle myPage;
+	MyDB_RecordPtr myRec;
+};
+
+#endif
@@ -0,0 +1,40 @@
+
+#ifndef PAX_PAGE_REC_ITER_ALT_H
+#define PAX_PAGE_REC_ITER_ALT_H
+
+#include <vector>
+#include "MyDB_PageHandle.h"
+#include "MyDB_Record.h"
+#include "MyDB_RecordIteratorAlt.h"
+
+// an alternate iterator over the records on a PAX page (see MyDB_PaxPage.h); each record is put
+// back together out of the page's minipages as it is reached
+class MyDB_PaxPageRecIteratorAlt : public MyDB_RecordIteratorAlt {
+
+public:
+
+        // load the current record into the parameter
+        void getCurrent (MyDB_RecordPtr intoMe) override;
+
+        // after a call to advance (), a call to getCurrentPointer () will get the address of the
+        // record.  Since the record does not exist on the page in its serialized form, this points
+        // to a copy that is owned by the iterator, and is only good until the next call to advance ()
+        void *getCurrentPointer () override;
+
+        // advance to the next record... returns true if there is a next record, and
+        // false if there are no more records to iterate over
+        bool advance () override;
+
+	// destructor and contructor
+	MyDB_PaxPageRecIteratorAlt (MyDB_PageHandle myPageIn); 
+	~MyDB_PaxPageRecIteratorAlt ();
+
+private:
+
+	// the current record, and the serialized version of it
+	size_t curRec;
+	vector <char> recBytes;
+	MyDB_PageHandle myPage;
+};
+
+#endif
@@ -4,6 +4,7 @@
 
 #include <memory>
 #include "MyDB_Record.h"
+#include "MyDB_TypedRecord.h"
 using namespace std;
 
 // This pure virtual class is used to iterate through the records in a page or file
@@ -20,6 +21,12 @@ public:
 	// load the current record into the parameter
 	virtual void getCurrent (MyDB_RecordPtr intoMe) = 0;
 
+	// load the current record into a typed record (see MyDB_TypedRecord.h)
+	template <class... Atts>
+	void getCurrent (MyDB_TypedRecord <Atts...> &intoMe) {
+		intoMe.fromBinary (getCurrentPointer ());
+	}
+
         // after a call to advance (), a call to getCurrentPointer () will get the address
         // of the record.  At a later time, it is then possible to reconstitute the record
         // by calling MyDB_Record.fromBinary (obtainedPointer)... ASSUMING that the page that
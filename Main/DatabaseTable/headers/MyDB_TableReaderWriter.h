@@ -19,11 +19,13 @@
 #include "MyDB_RecordIterator.h"
 #include "MyDB_RecordIteratorAlt.h"
 #include "MyDB_Table.h"
+#include "MyDB_TypedRecord.h"
 #include <set>
 #include <vector>
 
 // create a smart pointer for the table reader writer
 using namespace std;
+class MyDB_ColumnIterator;
 class MyDB_PageReaderWriter;
 class MyDB_TableReaderWriter;
 typedef shared_ptr <MyDB_TableReaderWriter> MyDB_TableReaderWriterPtr;
@@ -38,9 +40,30 @@ public:
 	// gets an empty record from this table
 	MyDB_RecordPtr getEmptyRecord ();
 
-	// append a record to the table
+	// append a record to the table; this also updates the table's tuple count, distinct
+	// value sketches (see MyDB_Table.changeSketches), and zone map (see MyDB_Table.getZoneMap).
+	// A record that is too big to fit on a page is an error
 	virtual void append (MyDB_RecordPtr appendMe);
 
+	// append a typed record to the table (see MyDB_TypedRecord.h); the record type must
+	// match the schema of the table.  Like append (MyDB_RecordPtr), this exits with an error
+	// if the record does not fit on a page
+	template <class... Atts>
+	void append (const MyDB_TypedRecord <Atts...> &appendMe) {
+		void *loc = reserveBytes (appendMe.getBinarySize ());
+		appendMe.toBinary (loc);
+		finishAppend (loc);
+		size_t hashes[sizeof... (Atts)];
+		appendMe.getHashes (hashes);
+		updateStats (hashes);
+	}
+
+	// reserves numBytes at the end of the table for a new record (going on to a new page if
+	// there is not enough room on the last one), and returns where the record should be written;
+	// since the record is not seen, the table's statistics are not updated, and the zone map will
+	// no longer skip the page that the record goes on.  This can't be used on a PAX table
+	void *appendBytes (size_t numBytes);
+
 	// return an itrator over this table... each time returnVal->next () is
 	// called, the resulting record will be placed into the record pointed to
 	// by iterateIntoMe
@@ -55,19 +78,53 @@ public:
 	// highPage inclusive
 	MyDB_RecordIteratorAltPtr getIteratorAlt (int lowPage, int highPage);
 
+	// gets an alternate iterator over the table that only returns the records for which the
+	// selection predicate pred (encoded as in MyDB_Record.compileComputation) is true.  Any
+	// comparisons of an attribute with a constant that are and-ed into the predicate are checked
+	// against the table's zone map, and pages that can't have a qualifying record are never read
+	MyDB_RecordIteratorAltPtr getIteratorAlt (string pred);
+
+	// gets an iterator that goes through the table a page at a time, returning only the given attributes
+	// (see MyDB_ColumnIterator.h); this is fastest on a PAX table, where nothing needs to be decoded
+	shared_ptr <MyDB_ColumnIterator> getColumnIterator (vector <string> atts);
+
+	// empties out the table, and its statistics and zone map; this is done before a text file is
+	// loaded into the table
+	virtual void clear ();
+
 	// load a text file into this table... this returns a pair where the first
 	// entry is a list of (approximate) distinct value counts for each of the
 	// attributes in the table, and the second entry is the number of tuples that
-	// have been loaded into the table
+	// have been loaded into the table.  These are also recorded in the table, so
+	// they are saved the next time that the table is put in the catalog
 	pair <vector <size_t>, size_t> loadFromTextFile (string fromMe);
 
+	// just like the above, but the text is parsed by numThreads worker threads (if numThreads
+	// is not positive, one per core is used).  The file is read in large chunks that are split
+	// at line boundaries; each worker parses its part of a chunk into serialized records while
+	// the next chunk is being read, and the records are then packed onto the table's pages in
+	// the same order as in the file, so the result is identical to the one-threaded version
+	virtual pair <vector <size_t>, size_t> loadFromTextFile (string fromMe, int numThreads);
+
+	// scans the table and rebuilds all of its statistics: the tuple count, the distinct value
+	// sketches, the histograms, min/max, and most common values (see MyDB_Table.getAttStats),
+	// and the zone map
+	void analyze ();
+
 	// dump the contents of this table into a text file
 	void writeIntoTextFile (string toMe);
 
-	// access the i^th page in this file
+	// access the i^th page in this file; the caller may write to the page, so the zone map no longer
+	// knows what is on it (see MyDB_Table.getZoneMap)
 	MyDB_PageReaderWriter operator [] (size_t i);
 
-	// access the i^th page in this file... getting a pinned version of the page
+	// access the i^th page in this file, which must already exist, only to read it; the zone map
+	// still knows about the page
+	MyDB_PageReaderWriter readPage (size_t i);
+
+	// access the i^th page in this file... getting a pinned version of the page.  Like readPage, this
+	// does not change the zone map, so it is only for writing by a table that does not keep one up to
+	// date (a B+-Tree drops its zone map whenever it changes)
 	MyDB_PageReaderWriter getPinned (size_t i);
 
 	// access the last page in the file
@@ -87,11 +144,53 @@ public:
 
 private:
 
+	// reserves numBytes at the end of the table, like appendBytes, except that once the record
+	// has been written there, the caller must call finishAppend with the location.  For a PAX table,
+	// the location is off to the side, and finishAppend puts the record on the last page
+	void *reserveBytes (size_t numBytes);
+	void finishAppend (void *loc);
+
+	// starts a new, empty, last page
+	void addLastPage ();
+
+	// empties out one of the table's pages, making it a PAX page if the table is a PAX table
+	void clearPage (MyDB_PageReaderWriter &clearMe);
+
+	// true if the table is a PAX table (see MyDB_PaxPage.h); this is a table whose file type is "pax"
+	bool isPax ();
+
+	// builds a function that checks the zone map to see if a page might hold records that satisfy
+	// the given selection predicate
+	function <bool (int)> getPageFilter (string pred);
+
+	// add a record that has been appended to the table's statistics; the second version takes
+	// the hash of each of the record's attributes
+	void updateStats (MyDB_RecordPtr appendMe);
+	void updateStats (size_t *hashes);
+
+	// empty out the table's statistics
+	void clearStats ();
+
+	// builds the attribute statistics and puts them in the table
+	void setAttStats (vector <MyDB_AttStatsBuilder> &fromMe);
+
+	// get the current distinct value estimates for all of the attributes
+	vector <size_t> getDistinctValueEstimates ();
+
+	// does the work of the multi-threaded loadFromTextFile, except that each record (serialized, as by
+	// MyDB_Record.toBinary) is given to appendMe, in the same order as in the file, rather than being
+	// put on a page.  The distinct value sketches and the attribute statistics are built from the
+	// records; returns the number of records
+	size_t parseTextFile (string fName, int numThreads, function <void (void *)> appendMe);
+
 	friend class MyDB_PageReaderWriter;
 	friend class MyDB_BPlusTreeReaderWriter;
 	MyDB_TablePtr forMe;
 	MyDB_BufferManagerPtr myBuffer;
 	shared_ptr <MyDB_PageReaderWriter> lastPage;
+
+	// for a PAX table, the record that is being appended
+	vector <char> paxRec;
 	
 };
 
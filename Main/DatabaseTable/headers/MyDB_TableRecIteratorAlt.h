@@ -41,9 +41,16 @@ public:
 	~MyDB_TableRecIteratorAlt ();
 	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, int lowPage, int highPage);
 
+	// iterates over the whole table, but only reads the pages for which pageFilter returns true
+	MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn, function <bool (int)> pageFilter);
+
 private:
 
+	// gets the iterator for the current page; this is null if the page is skipped
+	void startPage ();
+
 	MyDB_RecordIteratorAltPtr myIter;
+	function <bool (int)> pageFilter;
 	int curPage;
 	int highPage;	
 	MyDB_TableReaderWriter &myParent;
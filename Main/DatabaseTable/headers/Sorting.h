@@ -6,6 +6,7 @@
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableReaderWriter.h"
 #include "IteratorComparator.h"
+#include "MyDB_SortKey.h"
 
 // performs a TPMMS of the table sortMe.  The results are written to sortIntoMe.  The run 
 // size for the first phase of the TPMMS is given by runSize.  Comparisons are performed 
@@ -32,4 +33,14 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter,
         MyDB_RecordIteratorAltPtr rightIter, function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs);
 
+// these are just like the above, except that comparisons are done using the normalized keys built
+// by sortKey (see MyDB_SortKey.h).  Records are moved around as raw bytes, and are never deserialized
+void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe, MyDB_SortKeyPtr sortKey);
+
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe, 
+	MyDB_SortKeyPtr sortKey);
+
+vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter,
+        MyDB_RecordIteratorAltPtr rightIter, MyDB_SortKeyPtr sortKey);
+
 #endif
@@ -0,0 +1,68 @@
+
+#ifndef BPLUS_RANGE_ITER_ALT_C
+#define BPLUS_RANGE_ITER_ALT_C
+
+#include <cstring>
+#include "MyDB_BPlusTreeRangeIteratorAlt.h"
+#include "MyDB_PageLayout.h"
+
+void MyDB_BPlusTreeRangeIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	intoMe->fromBinary (getPageRecord (curLeaf.data (), curSlot));
+}
+
+void *MyDB_BPlusTreeRangeIteratorAlt :: getCurrentPointer () {
+	return getPageRecord (curLeaf.data (), curSlot);
+}
+
+bool MyDB_BPlusTreeRangeIteratorAlt :: advance () {
+
+	while (!done) {
+
+		// move to the next record on this leaf, and see if it is still in the range
+		if (curSlot + 1 < getPageNumSlots (curLeaf.data ())) {
+			curSlot++;
+			getCurrent (myRec);
+			if (aboveHigh ())
+				break;
+			return true;
+		}
+
+		// out of records, so go on to the next leaf; if any were returned from this one, the last one
+		// is still in myRec
+		if (getPageNumSlots (curLeaf.data ()) > firstSlot) {
+			resumeKey = parent.getKey (myRec);
+			resumeAfter = true;
+		}
+		curPage = parent.copyNextLeaf (curPage, version, resumeKey, resumeAfter, curLeaf, firstSlot);
+		if (curPage == -1)
+			break;
+		curSlot = firstSlot - 1;
+	}
+
+	done = true;
+	return false;
+}
+
+MyDB_BPlusTreeRangeIteratorAlt :: MyDB_BPlusTreeRangeIteratorAlt (MyDB_BPlusTreeReaderWriter &parentIn, int firstLeaf,
+	size_t firstSlotIn, size_t versionIn, MyDB_AttValPtr low, MyDB_RecordPtr myRecIn, function <bool ()> aboveHighIn) : 
+	parent (parentIn) {
+
+	myRec = myRecIn;
+	aboveHigh = aboveHighIn;
+	version = versionIn;
+	resumeKey = low;
+	resumeAfter = false;
+	curPage = firstLeaf;
+	firstSlot = firstSlotIn;
+	done = (firstLeaf == -1);
+	curLeaf.resize (parent.getBufferMgr ()->getPageSize ());
+	if (!done)
+		memcpy (curLeaf.data (), parent.getPinned (firstLeaf).getBytes (), curLeaf.size ());
+
+	// this is one before the first record, and wraps around to zero if the first record is slot zero
+	curSlot = firstSlot - 1;
+}
+
+MyDB_BPlusTreeRangeIteratorAlt :: ~MyDB_BPlusTreeRangeIteratorAlt () {}
+
+#endif
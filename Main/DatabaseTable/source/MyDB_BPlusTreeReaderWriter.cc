@@ -4,11 +4,17 @@
 
 #include "MyDB_INRecord.h"
 #include "MyDB_BPlusTreeReaderWriter.h"
+#include "MyDB_KeyArrayNode.h"
+#include "MyDB_PageLayout.h"
 #include "MyDB_PageReaderWriter.h"
-#include "MyDB_PageListIteratorSelfSortingAlt.h"
-#include "MyDB_PageListIteratorAlt.h"
+#include "MyDB_BPlusTreeRangeIteratorAlt.h"
 #include "RecordComparator.h"
 #include <algorithm>
+#include <cstring>
+#include <thread>
+
+// how full a split at the right edge of a level makes the new page, unless the tree says otherwise
+#define DEFAULT_FILL_FACTOR 0.9
 
 MyDB_BPlusTreeReaderWriter :: MyDB_BPlusTreeReaderWriter (string orderOnAttName, MyDB_TablePtr forMe, 
 	MyDB_BufferManagerPtr myBuffer) : MyDB_TableReaderWriter (forMe, myBuffer) {
@@ -19,81 +25,290 @@ MyDB_BPlusTreeReaderWriter :: MyDB_BPlusTreeReaderWriter (string orderOnAttName,
 	// remember information about the ordering attribute
 	orderingAttType = res.second;
 	whichAttIsOrdering = res.first;
+	keyAttType = orderingAttType;
+	MyDB_DictionaryPtr dictionary = orderingAttType->getDictionary ();
+	if (dictionary != nullptr && dictionary->isNumeric ())
+		keyAttType = make_shared <MyDB_IntAttType> ();
+	else if (dictionary != nullptr)
+		keyAttType = make_shared <MyDB_StringAttType> ();
+	intKeys = (orderingAttType->toString () == "int");
+	keyArrays = intKeys || (orderingAttType->toString () == "double");
+	structureVersion = 0;
+	fillFactor = DEFAULT_FILL_FACTOR;
+
+	// open the tree that is already in the file, or start a new one
+	metaPage = make_shared <MyDB_PageReaderWriter> (getPinned (0));
+	if (!readMeta ())
+		clear ();
+	getTable ()->setRootLocation (rootLocation);
+}
+
+// the metadata page has this after the usual page header (see MyDB_PageLayout.h); the magic number
+// changes whenever the layout of the tree's pages does
+#define TREE_MAGIC 0x4d59444242545246ULL
+#define MAX_KEY_TYPE_LEN 64
+struct MyDB_BPlusTreeMeta {
+	unsigned long long magic;
+	int rootLocation;
+	int height;
+	size_t numEntries;
+	int freeList;
+	int whichAttIsOrdering;
+	char keyType[MAX_KEY_TYPE_LEN];
+	double fillFactor;
+};
+
+static MyDB_BPlusTreeMeta *getMeta (MyDB_PageReaderWriter &page) {
+	return (MyDB_BPlusTreeMeta *) (((char *) page.getBytes ()) + PAGE_HEADER_SIZE);
+}
+
+bool MyDB_BPlusTreeReaderWriter :: readMeta () {
+
+	// the file has to start with a metadata page for a tree on the same attribute, of the same type
+	MyDB_PageReaderWriter &page = *metaPage;
+	MyDB_BPlusTreeMeta *meta = getMeta (page);
+	if (page.getType () != MyDB_PageType :: MetaPage || meta->magic != TREE_MAGIC ||
+		meta->whichAttIsOrdering != whichAttIsOrdering || 
+		strncmp (meta->keyType, orderingAttType->toString ().c_str (), MAX_KEY_TYPE_LEN) != 0)
+		return false;
+
+	rootLocation = meta->rootLocation;
+	height = meta->height;
+	numEntries = meta->numEntries;
+	freeList = meta->freeList;
+	fillFactor = meta->fillFactor;
+	return true;
+}
+
+void MyDB_BPlusTreeReaderWriter :: writeMeta () {
+	MyDB_PageReaderWriter &page = *metaPage;
+	MyDB_BPlusTreeMeta *meta = getMeta (page);
+	meta->magic = TREE_MAGIC;
+	meta->rootLocation = rootLocation;
+	meta->height = height;
+	meta->numEntries = numEntries;
+	meta->freeList = freeList;
+	meta->whichAttIsOrdering = whichAttIsOrdering;
+	strncpy (meta->keyType, orderingAttType->toString ().c_str (), MAX_KEY_TYPE_LEN - 1);
+	meta->keyType[MAX_KEY_TYPE_LEN - 1] = 0;
+	meta->fillFactor = fillFactor;
+	getPageBytesUsed (page.getBytes ()) = PAGE_HEADER_SIZE + sizeof (MyDB_BPlusTreeMeta);
+	page.setType (MyDB_PageType :: MetaPage);
+}
+
+void MyDB_BPlusTreeReaderWriter :: clear () {
 
-	// and the root location
+	// empty out the file; the metadata page is page 0, and the tree's pages come after it
+	MyDB_TableReaderWriter :: clear ();
 	rootLocation = -1;
+	height = 0;
+	numEntries = 0;
+	freeList = -1;
 	getTable ()->setRootLocation (rootLocation);
-	// cout << "Number of pages in table: " << getNumPages() << endl; 
-	// cout << "Initiating bplus tree with root location: " << rootLocation << endl;
+	writeMeta ();
 }
 
-MyDB_RecordIteratorAltPtr MyDB_BPlusTreeReaderWriter :: getSortedRangeIteratorAlt (MyDB_AttValPtr lhs, MyDB_AttValPtr rhs) {
-    vector<MyDB_PageReaderWriter> pages;
-	// printTree();
-	// cout << "Searching for lhs of " << lhs->toInt() << endl;
-	// cout << "Searching for rhs of " << rhs->toInt() << endl;
-    discoverPages(rootLocation, pages, lhs, rhs);
+void MyDB_BPlusTreeReaderWriter :: setFillFactor (double toMe) {
+	lock_guard <mutex> lock (metaMutex);
+	fillFactor = toMe;
+	writeMeta ();
+}
+
+double MyDB_BPlusTreeReaderWriter :: getFillFactor () {
+	lock_guard <mutex> lock (metaMutex);
+	return fillFactor;
+}
 
-    MyDB_RecordPtr left = getEmptyRecord();
-    MyDB_RecordPtr right = getEmptyRecord();
+int MyDB_BPlusTreeReaderWriter :: getHeight () {
+	lock_guard <mutex> lock (metaMutex);
+	return height;
+}
+
+size_t MyDB_BPlusTreeReaderWriter :: getNumEntries () {
+	lock_guard <mutex> lock (metaMutex);
+	return numEntries;
+}
 
-    MyDB_RecordPtr tempRec = getEmptyRecord();
+int MyDB_BPlusTreeReaderWriter :: allocatePage () {
 
-    MyDB_INRecordPtr lhsRec = getINRecord();
-    MyDB_INRecordPtr rhsRec = getINRecord();
-    lhsRec->setKey(lhs);
-    rhsRec->setKey(rhs);
- 
-    function <bool ()> comparator = buildComparator(left, right);
-    function <bool ()> lowComparator = buildComparator(tempRec, lhsRec);
-    function <bool ()> highComparator = buildComparator(rhsRec, tempRec);
+	// take the first free page, if there is one; the page is kept pinned until the record that needed
+	// it has been appended
+	int whichPage = freeList;
+	if (whichPage != -1) {
+		newPages.push_back (getPinned (whichPage));
+		freeList = newPages.back ().getNextPage ();
+		newPages.back ().clear ();
+		return whichPage;
+	}
+
+	// otherwise, the file gets a new (empty) page at the end
+	whichPage = getNumPages ();
+	newPages.push_back (getPinned (whichPage));
+	(*this)[whichPage];
+	return whichPage;
+}
 
-    return make_shared<MyDB_PageListIteratorSelfSortingAlt>(pages, left, right, comparator, tempRec, lowComparator, highComparator, true);
+void MyDB_BPlusTreeReaderWriter :: freePage (int whichPage) {
+	MyDB_PageReaderWriter page = (*this)[whichPage];
+	page.clear ();
+	page.setNextPage (freeList);
+	freeList = whichPage;
+}
+
+MyDB_RecordIteratorAltPtr MyDB_BPlusTreeReaderWriter :: getSortedRangeIteratorAlt (MyDB_AttValPtr lhs, MyDB_AttValPtr rhs) {
+
+	// the leaves are in key order, so we can stop at the first record past the high end
+	MyDB_RecordPtr myRec = getEmptyRecord ();
+	MyDB_INRecordPtr highRec = getINRecord ();
+	highRec->setKey (rhs);
+
+	// the iterator copies the first leaf while we have it latched
+	size_t whichSlot;
+	treeLatch.lockShared ();
+	int whichPage = findLowerBound (lhs, whichSlot);
+	MyDB_RecordIteratorAltPtr returnVal = make_shared <MyDB_BPlusTreeRangeIteratorAlt> (*this, whichPage, whichSlot, 
+		structureVersion, lhs, myRec, buildComparator (highRec, myRec));
+	if (whichPage != -1)
+		unlatchPage (whichPage, false);
+	treeLatch.unlockShared ();
+	return returnVal;
 }
 
 MyDB_RecordIteratorAltPtr MyDB_BPlusTreeReaderWriter :: getRangeIteratorAlt (MyDB_AttValPtr lhs, MyDB_AttValPtr rhs) {
-    return getSortedRangeIteratorAlt(lhs, rhs);
-    // vector<MyDB_PageReaderWriter> pages;
-    // discoverPages(rootLocation, pages, lhs, rhs);
-    // return make_shared<MyDB_PageListIteratorAlt>(pages);
+	return getSortedRangeIteratorAlt (lhs, rhs);
 }
 
+MyDB_Latch &MyDB_BPlusTreeReaderWriter :: getLatch (int whichPage) {
 
-bool MyDB_BPlusTreeReaderWriter :: discoverPages (int whichPage, vector <MyDB_PageReaderWriter> & list, MyDB_AttValPtr lhs, MyDB_AttValPtr rhs) {
-    MyDB_RecordPtr currentRec = getEmptyRecord();
-    MyDB_PageReaderWriter page = (*this)[whichPage];
-    if (page.getType() == MyDB_PageType::RegularPage) {
-		// cout << "Adding leaf page with this these values" << endl;
-        list.push_back(page);
-        return true;
-    }
-    MyDB_RecordIteratorAltPtr iter = page.getIteratorAlt();
-    currentRec = getINRecord();
-    MyDB_INRecordPtr left;
-    MyDB_INRecordPtr right;
-    while (iter->advance()) {
-        iter->getCurrent(currentRec);
-        MyDB_AttValPtr key = getKey(currentRec);
-        left = getINRecord();
-        right = getINRecord();
-        left->setKey(lhs);
-        right->setKey(rhs);
-		// cout << "Checking current internal record key: " << currentRec->getAtt (0)->toInt () << endl;
-        auto leftCmp = buildEqualToComparator(left, currentRec);
-        auto rightCmp = buildComparator(right, currentRec);
-        if (leftCmp()) { // Use custom comparator to check if this page should be added
-            int idx = static_pointer_cast<MyDB_INRecord>(currentRec)->getPtr();
-			// cout << "Going to this page to discover more pages" << endl;
-            discoverPages(idx, list, lhs, rhs);
-            if (rightCmp()) {
-				// cout << "Not going to future pages to discover pages" << endl;
-               break;
-            }
-        }
+	// a deque never moves its contents, so the latch stays put as more are added
+	lock_guard <mutex> lock (latchesMutex);
+	while ((int) latches.size () <= whichPage)
+		latches.emplace_back ();
+	return latches[whichPage];
+}
 
-    }
+MyDB_PageReaderWriter MyDB_BPlusTreeReaderWriter :: latchPage (int whichPage, bool exclusive) {
+	if (exclusive)
+		getLatch (whichPage).lockExclusive ();
+	else
+		getLatch (whichPage).lockShared ();
+	return getPinned (whichPage);
+}
 
-	return false;
+void MyDB_BPlusTreeReaderWriter :: unlatchPage (int whichPage, bool exclusive) {
+	if (exclusive)
+		getLatch (whichPage).unlockExclusive ();
+	else
+		getLatch (whichPage).unlockShared ();
+}
+
+int MyDB_BPlusTreeReaderWriter :: findLowerBound (MyDB_AttValPtr low, size_t &whichSlot, bool strict) {
+
+	rootLatch.lockShared ();
+	int whichPage = rootLocation;
+	whichSlot = 0;
+	if (whichPage == -1) {
+		rootLatch.unlockShared ();
+		return -1;
+	}
+	MyDB_PageReaderWriter page = latchPage (whichPage, false);
+	rootLatch.unlockShared ();
+
+	// a child only has keys that are not bigger than its entry's key, so the first record that is not
+	// less than low is under the first entry whose key is not less than low (and the first record that
+	// is bigger than low is under the first entry whose key is bigger); the last entry has the largest
+	// possible key, so if there is no such entry, we use the last one
+	MyDB_INRecordPtr inRec = getINRecord ();
+	MyDB_INRecordPtr lowRec = getINRecord ();
+	lowRec->setKey (low);
+	while (page.getType () == MyDB_PageType :: DirectoryPage) {
+		size_t where = findEntry (page, inRec, lowRec, strict);
+		if (where == page.getNumRecords ())
+			where--;
+		int childPage = getChild (page, where, inRec);
+		MyDB_PageReaderWriter child = latchPage (childPage, false);
+		unlatchPage (whichPage, false);
+		whichPage = childPage;
+		page = child;
+	}
+
+	// and find the record on the leaf
+	MyDB_RecordPtr rec = getEmptyRecord ();
+	whichSlot = strict ? upperBound (page, rec, lowRec) : page.lowerBound (buildComparator (rec, lowRec), rec);
+	return whichPage;
+}
+
+int MyDB_BPlusTreeReaderWriter :: copyNextLeaf (int whichPage, size_t &version, MyDB_AttValPtr resumeKey, bool strict,
+	vector <char> &intoMe, size_t &whichSlot) {
+
+	treeLatch.lockShared ();
+	whichSlot = 0;
+
+	// the leaf may have split since it was copied, but it kept its upper half, so its next link is
+	// still right... unless there has been a remove, which may have merged it away
+	int nextPage;
+	if (version == structureVersion) {
+		MyDB_PageReaderWriter page = latchPage (whichPage, false);
+		nextPage = page.getNextPage ();
+		if (nextPage != -1)
+			latchPage (nextPage, false);
+		unlatchPage (whichPage, false);
+	} else {
+		version = structureVersion;
+		nextPage = findLowerBound (resumeKey, whichSlot, strict);
+	}
+
+	if (nextPage != -1) {
+		memcpy (intoMe.data (), getPinned (nextPage).getBytes (), intoMe.size ());
+		unlatchPage (nextPage, false);
+	}
+	treeLatch.unlockShared ();
+	return nextPage;
+}
+
+bool MyDB_BPlusTreeReaderWriter :: lookup (MyDB_AttValPtr key, MyDB_RecordPtr intoMe) {
+
+	treeLatch.lockShared ();
+	size_t whichSlot;
+	int whichPage = findLowerBound (key, whichSlot);
+	if (whichPage == -1) {
+		treeLatch.unlockShared ();
+		return false;
+	}
+
+	// if every record on the leaf is smaller than the key, the next leaf starts with the first one that
+	// is not smaller
+	MyDB_PageReaderWriter page = getPinned (whichPage);
+	if (whichSlot == page.getNumRecords ()) {
+		int nextPage = page.getNextPage ();
+		if (nextPage == -1) {
+			unlatchPage (whichPage, false);
+			treeLatch.unlockShared ();
+			return false;
+		}
+		MyDB_PageReaderWriter next = latchPage (nextPage, false);
+		unlatchPage (whichPage, false);
+		whichPage = nextPage;
+		page = next;
+		whichSlot = 0;
+	}
+
+	bool found = whichSlot < page.getNumRecords ();
+	if (found)
+		page.getRecord (whichSlot, intoMe);
+	unlatchPage (whichPage, false);
+	treeLatch.unlockShared ();
+	if (!found)
+		return false;
+
+	// the record's key is not smaller than the key, so they are equal unless the key is smaller
+	MyDB_INRecordPtr keyRec = getINRecord ();
+	keyRec->setKey (key);
+	return !buildComparator (keyRec, intoMe) ();
+}
+
+bool MyDB_BPlusTreeReaderWriter :: contains (MyDB_AttValPtr key) {
+	return lookup (key, getEmptyRecord ());
 }
 
 // Helper function to print all records
@@ -108,13 +323,104 @@ void printRecords(const vector<MyDB_RecordPtr>& records, const string& label) {
 }
 
 void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
+
+	treeLatch.lockShared ();
+	if (!appendToLeaf (appendMe))
+		appendWithSplits (appendMe);
+	treeLatch.unlockShared ();
+
+	// keep the table's tuple count and distinct value sketches up to date; records move from page to
+	// page as the tree splits, so the zone map can't be, and we just drop it
+	lock_guard <mutex> lock (metaMutex);
+	updateStats (appendMe);
+	getTable ()->getZoneMap ().clear ();
+	numEntries++;
+	writeMeta ();
+}
+
+bool MyDB_BPlusTreeReaderWriter :: appendToLeaf (MyDB_RecordPtr appendMe) {
+
+	// the root is always an internal node, and the leaves are at level one
+	rootLatch.lockShared ();
+	int whichPage = rootLocation;
+	int level = height;
+	if (whichPage == -1) {
+		rootLatch.unlockShared ();
+		return false;
+	}
+	MyDB_PageReaderWriter page = latchPage (whichPage, level == 1);
+	rootLatch.unlockShared ();
+
+	// go down to the leaf, just as in append (whichPage, appendMe)
+	MyDB_INRecordPtr inRec = getINRecord ();
+	for (; level > 1; level--) {
+		size_t where = findEntry (page, inRec, appendMe, true);
+		if (where == page.getNumRecords ())
+			where--;
+		int childPage = getChild (page, where, inRec);
+		MyDB_PageReaderWriter child = latchPage (childPage, level == 2);
+		unlatchPage (whichPage, false);
+		whichPage = childPage;
+		page = child;
+	}
+
+	bool res = page.insert (upperBound (page, getEmptyRecord (), appendMe), appendMe);
+	unlatchPage (whichPage, true);
+	return res;
+}
+
+void MyDB_BPlusTreeReaderWriter :: appendWithSplits (MyDB_RecordPtr appendMe) {
+
+	// latch the path to the leaf, from the top down
+	vector <int> latched;
+	vector <MyDB_PageReaderWriter> pinned;
+	while (true) {
+		rootLatch.lockExclusive ();
+		int whichPage = rootLocation;
+		MyDB_INRecordPtr inRec = getINRecord ();
+		while (whichPage != -1) {
+			pinned.push_back (latchPage (whichPage, true));
+			latched.push_back (whichPage);
+			if (pinned.back ().getType () != MyDB_PageType :: DirectoryPage)
+				break;
+			size_t where = findEntry (pinned.back (), inRec, appendMe, true);
+			if (where == pinned.back ().getNumRecords ())
+				where--;
+			whichPage = getChild (pinned.back (), where, inRec);
+		}
+
+		// if the leaf is going to split, we need the leaf before it too; a range scan could be holding
+		// that one while it waits for the leaf, so if we can't get it right away, we start over
+		if (whichPage == -1)
+			break;
+		int prevPage = pinned.back ().getPrevPage ();
+		size_t needed = appendMe->getBinarySize () + sizeof (MyDB_SlotType);
+		if (prevPage == -1 || getPageBytesUsed (pinned.back ().getBytes ()) + needed <= pinned.back ().getPageSize ())
+			break;
+		if (getLatch (prevPage).tryLockExclusive ()) {
+			pinned.push_back (getPinned (prevPage));
+			latched.push_back (prevPage);
+			break;
+		}
+		for (int page : latched)
+			unlatchPage (page, true);
+		latched.clear ();
+		pinned.clear ();
+		rootLatch.unlockExclusive ();
+		this_thread :: yield ();
+	}
+
+	// now no one else can see the pages that change
+	lock_guard <mutex> lock (metaMutex);
+
 	// Base case for an empty tree: Create a internal node (root) with an infinity internal record 
 	// that points to an empty leaf page
 	if (rootLocation == -1) {
 		// cout << "appending record in high level append " << appendMe << endl;
 		// cout << "Creating initial root node for b plus tree" << endl;
 		// cout << "Initial number of pages: " << this-> getNumPages() << endl;
-		rootLocation = 0;
+		rootLocation = allocatePage();
+		height = 2;
 		getTable()->setRootLocation(rootLocation);
 		// cout << "Initial root location: " << rootLocation << endl;
 
@@ -127,7 +433,7 @@ void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
 		MyDB_INRecordPtr newINRec = getINRecord();
 
 		// Point root node to an empty leaf page
-		int newPageNumber = this->getNumPages();
+		int newPageNumber = allocatePage();
 		// cout << "New page number for leaf page: " << newPageNumber << endl;
 		MyDB_PageReaderWriter newPage = (*this)[newPageNumber];
 		newPage.setType(MyDB_PageType::RegularPage);
@@ -135,7 +441,7 @@ void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
 		
 		// cout << "Adding initial internal record to rootPage" << endl;
 		// cout << "Initial ptr for root internal record: " << newINRec->getPtr() << endl;
-		rootPage.append(newINRec);
+		insertEntry (rootPage, 0, newINRec);
 		// cout << "Done adding initial internal record to rootPage" << endl;
         // printTree();
 	}
@@ -145,191 +451,527 @@ void MyDB_BPlusTreeReaderWriter :: append (MyDB_RecordPtr appendMe) {
 	// cout << "Current rootLocation: " << rootLocation << endl;
 	MyDB_RecordPtr maybeSplit = append(rootLocation, appendMe);
 	if (maybeSplit != nullptr) {
-		int newPageNumber = this->getNumPages();
+		int newPageNumber = allocatePage();
 		// cout << "Updating root location" << endl;
 		// cout << "New page number to add " << newPageNumber << endl;
 		MyDB_PageReaderWriter newPage = (*this)[newPageNumber];
 		newPage.setType(MyDB_PageType::DirectoryPage);
-		newPage.append(maybeSplit);
+		insertEntry (newPage, 0, maybeSplit);
 		// cout << "Created new rootPage and added maybeSplit" << endl;
 
 		// Add a new internal node to point to the old root (key is automatically to largest possible value)
 		// cout << "Adding new infinity internal node to root page " << endl;
 		MyDB_INRecordPtr newINRec = getINRecord();
 		newINRec->setPtr(rootLocation);
-		newPage.append(newINRec);
+		insertEntry (newPage, 1, newINRec);
 		rootLocation = newPageNumber;
+		height++;
 		getTable()->setRootLocation(newPageNumber);
-		MyDB_INRecordPtr lhs = getINRecord();
-		MyDB_INRecordPtr rhs = getINRecord();
-		auto compare = buildComparator(lhs, rhs);
-		newPage.sortInPlace(compare, lhs, rhs);
 	}
+	newPages.clear ();
 
-	// cout << "Print tree at end of high level append" << endl;
-	// printTree();
+	for (int page : latched)
+		unlatchPage (page, true);
+	rootLatch.unlockExclusive ();
 }
 
-MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: split (MyDB_PageReaderWriter splitMe, MyDB_RecordPtr andMe) {
-	// Sort all records (splitMe records + andMe)
-	vector<MyDB_RecordPtr> records;
-    vector<MyDB_INRecordPtr> inRecords;
-	MyDB_RecordPtr tempRec = getEmptyRecord();
-    if (splitMe.getType() == MyDB_PageType::DirectoryPage) {
-        tempRec = getINRecord();
-    }
-	MyDB_RecordIteratorPtr iter = splitMe.getIterator(tempRec);
-	
-	// cout << "Aggregating records together for sorting" << endl;
-	while (iter->hasNext()) {
-		iter->getNext();
-		// cout << "Current record beging sorted: " << tempRec << endl;
-		// Deep copy of the record
-		// Allocate a temporary buffer for copying the record
-		size_t size = tempRec->getBinarySize();
-		vector<char> buffer(size);
-
-		// Serialize the other record into the buffer
-		tempRec->toBinary(buffer.data());
-
-		// Copy the binary into a new record
-        if (splitMe.getType() == MyDB_PageType::DirectoryPage) {
-            MyDB_INRecordPtr inRec = getINRecord();
-            inRec->fromBinary(buffer.data());
-            inRecords.push_back(inRec);
-        } else {
-            MyDB_RecordPtr recordCopy = getEmptyRecord();
-            recordCopy->fromBinary(buffer.data());
-            records.push_back(recordCopy);
-        }
+// appends the record to the page, unless the page already has at least minRecs records and adding this
+// one would use more than limit bytes; returns false if the record was not appended
+static bool appendUpTo (MyDB_PageReaderWriter &page, MyDB_RecordPtr appendMe, size_t limit, size_t minRecs) {
+	size_t needed = appendMe->getBinarySize () + sizeof (MyDB_SlotType);
+	if (page.getNumRecords () >= minRecs && getPageBytesUsed (page.getBytes ()) + needed > limit)
+		return false;
+	return page.append (appendMe);
+}
+
+pair <vector <size_t>, size_t> MyDB_BPlusTreeReaderWriter :: loadFromTextFile (string fName, int numThreads) {
+
+	// the records can't just be put on pages, so append keeps the tree (and its statistics) up to date
+	clear ();
+	MyDB_RecordPtr tempRec = getEmptyRecord ();
+	size_t counter = parseTextFile (fName, numThreads, [&] (void *rec) {
+		tempRec->fromBinary (rec);
+		append (tempRec);
+	});
+	return make_pair (getDistinctValueEstimates (), counter);
+}
 
+void MyDB_BPlusTreeReaderWriter :: bulkLoad (MyDB_RecordIteratorAltPtr sortedRecs, double fillFactor) {
+
+	// empty out the file
+	clear ();
+
+	// a page is full once this many bytes are used
+	size_t limit = (size_t) (fillFactor * getBufferMgr ()->getPageSize ());
+
+	// first, pack the records into the leaves, linking each one to the next; for each leaf, we remember
+	// the key that goes with it in the level above (its largest key, or a shorter separator; see
+	// getSeparator)
+	vector <pair <MyDB_AttValPtr, int>> level;
+	MyDB_RecordPtr rec = getEmptyRecord ();
+	MyDB_AttValPtr lastKey;
+	int curPage = allocatePage ();
+	MyDB_PageReaderWriter page = (*this)[curPage];
+	while (sortedRecs->advance ()) {
+		sortedRecs->getCurrent (rec);
+		if (!appendUpTo (page, rec, limit, 1)) {
+			level.push_back (make_pair (getSeparator (lastKey, getKey (rec)), curPage));
+			page.setNextPage (curPage + 1);
+			page = (*this)[++curPage];
+			page.setPrevPage (curPage - 1);
+			page.append (rec);
+		}
+		lastKey = getKey (rec);
+		updateStats (rec);
+		numEntries++;
 	}
-    if (splitMe.getType() == MyDB_PageType::DirectoryPage) {
-        inRecords.push_back(static_pointer_cast<MyDB_INRecord>(andMe));
-    } else {
-	    records.push_back(andMe);
-    }
-	// Print before sorting
-	// printRecords(records, "Records BEFORE sort");
-
-	if (splitMe.getType() == MyDB_PageType::RegularPage) {
-		std::sort(records.begin(), records.end(), [this](MyDB_RecordPtr a, MyDB_RecordPtr b) {
-			auto compare = buildComparator(a, b);
-			return compare();
-		});
-	} else {
-        std::sort(inRecords.begin(), inRecords.end(), [this](MyDB_INRecordPtr a, MyDB_INRecordPtr b) {
-            auto compare = buildComparator(a, b);
-            return compare();
-        });
-        records.clear();
-        for (auto &inRec : inRecords) {
-            records.push_back(inRec);
-        }
-    }
 
-	// Print after sorting
-	// printRecords(records, "Records AFTER sort");
+	// an empty tree has no root
+	if (lastKey == nullptr) {
+		newPages.clear ();
+		writeMeta ();
+		return;
+	}
+	level.push_back (make_pair (lastKey, curPage));
+	height = 1;
+
+	// now build the levels of internal nodes, up to the root; as in a tree built by append, the last
+	// entry on each level has the largest possible key.  An internal node always gets at least two
+	// entries, so each level is smaller than the one below it
+	do {
+		vector <pair <MyDB_AttValPtr, int>> nextLevel;
+		page = (*this)[++curPage];
+		page.setType (MyDB_PageType :: DirectoryPage);
+		for (size_t i = 0; i < level.size (); i++) {
+			MyDB_INRecordPtr inRec = getINRecord ();
+			if (i != level.size () - 1)
+				inRec->setKey (level[i].first);
+			inRec->setPtr (level[i].second);
+			size_t needed = keyArrays ? (intKeys ? sizeof (int) : sizeof (double)) + sizeof (int) :
+				inRec->getBinarySize () + sizeof (MyDB_SlotType);
+			if (page.getNumRecords () >= 2 && getPageBytesUsed (page.getBytes ()) + needed > limit) {
+				nextLevel.push_back (make_pair (level[i - 1].first, curPage));
+				page = (*this)[++curPage];
+				page.setType (MyDB_PageType :: DirectoryPage);
+			}
+			insertEntry (page, page.getNumRecords (), inRec);
+		}
+		nextLevel.push_back (make_pair (level.back ().first, curPage));
+		level = nextLevel;
+		height++;
+	} while (level.size () > 1);
+
+	rootLocation = level[0].second;
+	getTable ()->setRootLocation (rootLocation);
+	newPages.clear ();
+	writeMeta ();
+}
 
-	// Split records in half
-	int mid = records.size() / 2;
-	vector<MyDB_RecordPtr> lower(records.begin(), records.begin() + mid);
-	vector<MyDB_RecordPtr> upper(records.begin() + mid, records.end());
+MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: split (int whichPage, MyDB_RecordPtr andMe, size_t where) {
 
-	// Print both halves for debugging
-	// printRecords(lower, "LOWER half (left child)");
-	// printRecords(upper, "UPPER half (right child)");
+	// the page is re-written, so we work from a copy of its records; they are already sorted, and andMe
+	// goes at position where
+	MyDB_PageReaderWriter splitMe = (*this)[whichPage];
+	MyDB_PageType type = splitMe.getType ();
+	int prevPage = splitMe.getPrevPage ();
+	int nextPage = splitMe.getNextPage ();
+	vector <char> copy, andMeBytes (andMe->getBinarySize ());
+	vector <void *> recs;
+	getRecords (splitMe, copy, recs);
+	andMe->toBinary (andMeBytes.data ());
+	recs.insert (recs.begin () + where, andMeBytes.data ());
+	size_t numRecs = recs.size ();
 
-	// Create a new page for the lower half
-	int newPageNumber = this->getNumPages();
+	// the lower half goes to a new page, and the upper half stays on this one... unless andMe goes at
+	// the very end of the last page on this level (the last leaf, or the internal node whose last entry
+	// has the largest possible key, where andMe goes right before that entry).  Then the records are
+	// most likely coming in increasing order, so the new page is filled up to the fill factor, and only
+	// the records after that (at least andMe, and that last entry) stay here
+	size_t mid = numRecs / 2;
+	size_t numAtEnd = (type == MyDB_PageType :: RegularPage) ? 1 : 2;
+	bool rightEdge = (where + numAtEnd == numRecs);
+	if (rightEdge && type == MyDB_PageType :: RegularPage) {
+		rightEdge = (nextPage == -1);
+	} else if (rightEdge) {
+		MyDB_INRecordPtr lastEntry = getINRecord ();
+		lastEntry->fromBinary (recs.back ());
+		rightEdge = !buildComparator (lastEntry, getINRecord ()) ();
+	}
+	if (rightEdge) {
+		size_t limit = (size_t) (fillFactor * splitMe.getPageSize ());
+		size_t used = PAGE_HEADER_SIZE;
+		for (mid = 0; mid + numAtEnd < numRecs; mid++) {
+			used += getBytesNeeded (type, recs, mid, mid + 1) - PAGE_HEADER_SIZE;
+			if (used > limit)
+				break;
+		}
+		if (mid == 0)
+			mid = 1;
+	}
+
+	// the records are moved as raw bytes
+	int newPageNumber = allocatePage ();
 	MyDB_PageReaderWriter newPage = (*this)[newPageNumber];
-	newPage.setType(splitMe.getType());
-	// cout << "Finished creating page" << endl;
-	newPage.clear();
-	for (auto &rec : lower) {
-		// cout << "IN lower append" << endl;
-		// cout << "Appending in lower half: " << rec << endl;
-		newPage.append(rec);
-	}
-    newPage.setType(splitMe.getType());
-
-	// cout << "Replacing current pages in upper half" << endl;
-	// Replace current page contents with upper half
-	splitMe.clear();
-    splitMe.setType(newPage.getType());
-	// cout << "finished clearing original page" << endl;
-	for (auto &rec : upper) {
-		// cout << "In upper append" << endl;
-		// cout << "Appending in upper half: " << rec << endl;
-		splitMe.append(rec);
+	newPage.setType (type);
+	setRecords (newPage, recs, 0, mid);
+	setRecords (splitMe, recs, mid, numRecs);
+
+	// the new leaf goes into the list of leaves between this one and the one before it
+	if (type == MyDB_PageType :: RegularPage) {
+		newPage.setPrevPage (prevPage);
+		newPage.setNextPage (whichPage);
+		splitMe.setPrevPage (newPageNumber);
+		splitMe.setNextPage (nextPage);
+		if (prevPage != -1)
+			(*this)[prevPage].setNextPage (newPageNumber);
 	}
-	
-	// Return an internal record (key, ptr) pointing to the new page
-	MyDB_INRecordPtr newINRec = getINRecord();
-	newINRec->setKey(getKey(lower.back()));
-	newINRec->setPtr(newPageNumber);
+
+	// the entry for the new page has the largest key on it; for a leaf, it can be anything from that up
+	// to (but not including) the smallest key on this page, so we use the shortest one
+	MyDB_RecordPtr largest = (type == MyDB_PageType :: DirectoryPage) ? getINRecord () : getEmptyRecord ();
+	largest->fromBinary (recs[mid - 1]);
+	MyDB_AttValPtr newKey = getKey (largest);
+	if (type == MyDB_PageType :: RegularPage) {
+		MyDB_RecordPtr smallest = getEmptyRecord ();
+		smallest->fromBinary (recs[mid]);
+		newKey = getSeparator (newKey, getKey (smallest));
+	}
+	MyDB_INRecordPtr newINRec = getINRecord ();
+	newINRec->setKey (newKey);
+	newINRec->setPtr (newPageNumber);
 	return newINRec;
 }
 
+size_t MyDB_BPlusTreeReaderWriter :: upperBound (MyDB_PageReaderWriter &page, MyDB_RecordPtr pageRec, MyDB_RecordPtr key) {
+	return page.lowerBound (buildEqualToComparator (pageRec, key), pageRec);
+}
+
 MyDB_RecordPtr MyDB_BPlusTreeReaderWriter :: append (int whichPage, MyDB_RecordPtr appendMe) {
+
 	MyDB_PageReaderWriter currentPage = (*this)[whichPage];
-	// cout << "Appending record in lower level append on page " << whichPage << endl;
-	// Leaf node just append
-	if (currentPage.getType() == MyDB_PageType::RegularPage) {
-		// cout << "Adding record to leaf node" << endl;
-		bool success = currentPage.append(appendMe);
-		if (!success) { // split page
-			// cout << "Not successful in adding leaf node" << endl;
-			return split(currentPage, appendMe);
+
+	// a leaf is kept sorted, so the record goes right after the last record whose key is not bigger
+	if (currentPage.getType () == MyDB_PageType :: RegularPage) {
+		size_t where = upperBound (currentPage, getEmptyRecord (), appendMe);
+		if (!currentPage.insert (where, appendMe))
+			return split (whichPage, appendMe, where);
+		return nullptr;
+	}
+
+	// in an internal node, the record goes to the first child whose key is bigger than the record's; the
+	// last entry has the largest possible key, so if there is no such child, we use the last one
+	MyDB_INRecordPtr inRec = getINRecord ();
+	size_t where = findEntry (currentPage, inRec, appendMe, true);
+	if (where == currentPage.getNumRecords ())
+		where--;
+	MyDB_RecordPtr maybeSplit = append (getChild (currentPage, where, inRec), appendMe);
+	if (maybeSplit == nullptr)
+		return nullptr;
+
+	// if the child split, the new page has the lower half of its records, so the new page's entry goes
+	// right before the child's
+	if (!insertEntry (currentPage, where, maybeSplit))
+		return split (whichPage, maybeSplit, where);
+	return nullptr;
+}
+
+size_t MyDB_BPlusTreeReaderWriter :: remove (MyDB_AttValPtr key) {
+	return remove (key, nullptr, (size_t) -1);
+}
+
+bool MyDB_BPlusTreeReaderWriter :: remove (MyDB_RecordPtr removeMe) {
+	vector <char> exact (removeMe->getBinarySize ());
+	removeMe->toBinary (exact.data ());
+	return remove (getKey (removeMe), exact.data (), 1) == 1;
+}
+
+size_t MyDB_BPlusTreeReaderWriter :: remove (MyDB_AttValPtr key, void *exact, size_t limit) {
+
+	// records are moved from page to page without latching them, so we need the tree to ourselves
+	treeLatch.lockExclusive ();
+	size_t removed = 0;
+	if (rootLocation != -1) {
+		MyDB_INRecordPtr keyRec = getINRecord ();
+		keyRec->setKey (key);
+		removed = remove (rootLocation, keyRec, exact, limit);
+
+		// a root with one child is not needed, unless that child is a leaf (the root is always an
+		// internal node)
+		MyDB_PageReaderWriter root = (*this)[rootLocation];
+		while (height > 2 && root.getNumRecords () == 1) {
+			int onlyChild = getChild (root, 0, getINRecord ());
+			freePage (rootLocation);
+			rootLocation = onlyChild;
+			height--;
+			root = (*this)[rootLocation];
 		}
-	} else if (currentPage.getType() == MyDB_PageType::DirectoryPage) {
-		// cout << "In internal page, going to next layer" << endl;
-		// internal node, recursively find page
-		MyDB_INRecordPtr inRec = getINRecord();
-		MyDB_RecordIteratorPtr iter = currentPage.getIterator(inRec);
-
-		int childPtr = -1;
-		// cout << "iter->hasNext() " << iter->hasNext() << endl;
-		while (iter->hasNext()) {
-			iter->getNext();
-
-			auto compare = buildComparator(appendMe, inRec);
-			// cout << "Comparing internal rec with append Me" << endl;
-			// cout << "Result of compare: " << compare() << endl;
-			// cout << "Internal record ptr: " << inRec->getPtr() << endl;
-			if (compare()) {
-				// If keyToInsert < inRec's key, go to child pointed to by inRec
-				childPtr = inRec->getPtr();
-				break;
+		getTable ()->setRootLocation (rootLocation);
+	}
+
+	if (removed > 0) {
+		lock_guard <mutex> lock (metaMutex);
+		size_t tupleCount = getTable ()->getTupleCount ();
+		getTable ()->setTupleCount (tupleCount > removed ? tupleCount - removed : 0);
+		getTable ()->getZoneMap ().clear ();
+		numEntries -= removed;
+		writeMeta ();
+		structureVersion++;
+	}
+	treeLatch.unlockExclusive ();
+	return removed;
+}
+
+// puts the (key, ptr) entry at position where on an array node (see MyDB_KeyArrayNode.h), moving the
+// entries after it over; returns false if the node is full
+template <class KeyType>
+static bool insertIntoNode (void *page, size_t pageSize, size_t where, KeyType key, int ptr) {
+	size_t numEntries = getPageNumSlots (page);
+	if (numEntries == getNodeCapacity <KeyType> (pageSize))
+		return false;
+	KeyType *keys = getNodeKeys <KeyType> (page);
+	int *children = getNodeChildren <KeyType> (page, pageSize);
+	memmove (keys + where + 1, keys + where, (numEntries - where) * sizeof (KeyType));
+	memmove (children + where + 1, children + where, (numEntries - where) * sizeof (int));
+	keys[where] = key;
+	children[where] = ptr;
+	getPageNumSlots (page)++;
+	getPageBytesUsed (page) += sizeof (KeyType) + sizeof (int);
+	return true;
+}
+
+size_t MyDB_BPlusTreeReaderWriter :: findEntry (MyDB_PageReaderWriter &page, MyDB_INRecordPtr scratch, 
+	MyDB_RecordPtr keyRec, bool strict) {
+
+	if (!keyArrays) {
+		if (strict)
+			return upperBound (page, scratch, keyRec);
+		return page.lowerBound (buildComparator (scratch, keyRec), scratch);
+	}
+
+	MyDB_AttValPtr keyAtt = (keyRec->getSchema () == nullptr) ? keyRec->getAtt (0) : keyRec->getAtt (whichAttIsOrdering);
+	if (intKeys)
+		return searchNode <int> (page.getBytes (), keyAtt->toInt (), strict);
+	return searchNode <double> (page.getBytes (), keyAtt->toDouble (), strict);
+}
+
+int MyDB_BPlusTreeReaderWriter :: getChild (MyDB_PageReaderWriter &page, size_t whichEntry, MyDB_INRecordPtr scratch) {
+	if (!keyArrays) {
+		page.getRecord (whichEntry, scratch);
+		return scratch->getPtr ();
+	}
+	if (intKeys)
+		return getNodeChildren <int> (page.getBytes (), page.getPageSize ())[whichEntry];
+	return getNodeChildren <double> (page.getBytes (), page.getPageSize ())[whichEntry];
+}
+
+bool MyDB_BPlusTreeReaderWriter :: insertEntry (MyDB_PageReaderWriter &page, size_t where, MyDB_RecordPtr entry) {
+	if (!keyArrays)
+		return page.insert (where, entry);
+
+	MyDB_INRecordPtr inRec = static_pointer_cast <MyDB_INRecord> (entry);
+	bool res;
+	if (intKeys)
+		res = insertIntoNode <int> (page.getBytes (), page.getPageSize (), where, inRec->getKey ()->toInt (), inRec->getPtr ());
+	else
+		res = insertIntoNode <double> (page.getBytes (), page.getPageSize (), where, inRec->getKey ()->toDouble (), 
+			inRec->getPtr ());
+	if (res)
+		page.wroteBytes ();
+	return res;
+}
+
+void MyDB_BPlusTreeReaderWriter :: getRecords (MyDB_PageReaderWriter &page, vector <char> &storage, vector <void *> &recs) {
+
+	recs.clear ();
+	size_t numRecs = page.getNumRecords ();
+
+	// a page of records is just copied
+	if (!keyArrays || page.getType () != MyDB_PageType :: DirectoryPage) {
+		storage.resize (page.getPageSize ());
+		memcpy (storage.data (), page.getBytes (), storage.size ());
+		for (size_t i = 0; i < numRecs; i++)
+			recs.push_back (getPageRecord (storage.data (), i));
+		return;
+	}
+
+	// an array node has its entries written out as IN records, which all have the same size
+	MyDB_INRecordPtr inRec = getINRecord ();
+	MyDB_AttValPtr key;
+	if (intKeys)
+		key = make_shared <MyDB_IntAttVal> ();
+	else
+		key = make_shared <MyDB_DoubleAttVal> ();
+	inRec->setKey (key);
+	size_t recSize = inRec->getBinarySize ();
+	storage.resize (numRecs * recSize);
+	for (size_t i = 0; i < numRecs; i++) {
+		if (intKeys)
+			static_pointer_cast <MyDB_IntAttVal> (key)->set (getNodeKeys <int> (page.getBytes ())[i]);
+		else
+			static_pointer_cast <MyDB_DoubleAttVal> (key)->set (getNodeKeys <double> (page.getBytes ())[i]);
+		inRec->setKey (key);
+		inRec->setPtr (getChild (page, i, inRec));
+		inRec->toBinary (storage.data () + i * recSize);
+		recs.push_back (storage.data () + i * recSize);
+	}
+}
+
+void MyDB_BPlusTreeReaderWriter :: setRecords (MyDB_PageReaderWriter &page, vector <void *> &recs, size_t from, size_t to) {
+	MyDB_PageType type = page.getType ();
+	int prevPage = page.getPrevPage ();
+	int nextPage = page.getNextPage ();
+	page.clear ();
+	page.setType (type);
+	page.setPrevPage (prevPage);
+	page.setNextPage (nextPage);
+	if (!keyArrays || type != MyDB_PageType :: DirectoryPage) {
+		for (size_t i = from; i < to; i++)
+			page.appendBinary (recs[i]);
+		return;
+	}
+
+	MyDB_INRecordPtr inRec = getINRecord ();
+	for (size_t i = from; i < to; i++) {
+		inRec->fromBinary (recs[i]);
+		insertEntry (page, i - from, inRec);
+	}
+}
+
+size_t MyDB_BPlusTreeReaderWriter :: getBytesNeeded (MyDB_PageType type, vector <void *> &recs, size_t from, size_t to) {
+	if (keyArrays && type == MyDB_PageType :: DirectoryPage)
+		return PAGE_HEADER_SIZE + (to - from) * ((intKeys ? sizeof (int) : sizeof (double)) + sizeof (int));
+	size_t total = PAGE_HEADER_SIZE;
+	for (size_t i = from; i < to; i++)
+		total += *((short *) recs[i]) + sizeof (MyDB_SlotType);
+	return total;
+}
+
+// a page is underfull if less than a quarter of the room for records is used
+static bool isUnderfull (MyDB_PageReaderWriter &page) {
+	return (getPageBytesUsed (page.getBytes ()) - PAGE_HEADER_SIZE) * 4 < page.getPageSize () - PAGE_HEADER_SIZE;
+}
+
+size_t MyDB_BPlusTreeReaderWriter :: remove (int whichPage, MyDB_INRecordPtr keyRec, void *exact, size_t limit) {
+
+	MyDB_PageReaderWriter page = (*this)[whichPage];
+
+	// on a leaf, the records with the key are together, so we re-write the leaf without the ones that go
+	if (page.getType () == MyDB_PageType :: RegularPage) {
+		MyDB_RecordPtr rec = getEmptyRecord ();
+		size_t from = page.lowerBound (buildComparator (rec, keyRec), rec);
+		size_t to = upperBound (page, rec, keyRec);
+		vector <char> storage;
+		vector <void *> recs, keep;
+		getRecords (page, storage, recs);
+		size_t removed = 0;
+		for (size_t i = 0; i < recs.size (); i++) {
+			void *pageRec = recs[i];
+			if (i >= from && i < to && removed < limit && (exact == nullptr || (*((short *) pageRec) == 
+				*((short *) exact) && memcmp (pageRec, exact, *((short *) exact)) == 0))) {
+				removed++;
+				continue;
 			}
+			keep.push_back (pageRec);
 		}
-		// cout << "Going to page " << childPtr << endl;
-        if (childPtr == -1) {
-            cout << "childPtr is at -1" << endl;
-            printTree();
-            exit(1);
-        }
-		MyDB_RecordPtr maybeSplit = append(childPtr, appendMe);
-		// Handle potential child split
-		if (maybeSplit != nullptr) {
-			// cout << "Split happened, adding new ptr to current page " << whichPage << endl;
-			if (!currentPage.append(maybeSplit)) {
-				// cout << "Failed to add new internal node to current page, splitting again" << endl;
-				return split(currentPage, maybeSplit);
-			}
-			MyDB_INRecordPtr lhs = getINRecord();
-			MyDB_INRecordPtr rhs = getINRecord();
-			auto compare = buildComparator(lhs, rhs);
-			currentPage.sortInPlace(compare, lhs, rhs);
+		if (removed > 0)
+			setRecords (page, keep, 0, keep.size ());
+		return removed;
+	}
+
+	// the records with the key can be under any entry from the first one whose key is not less than the
+	// key, up to the first one whose key is bigger (or the last one, whose key is the largest possible)
+	MyDB_INRecordPtr inRec = getINRecord ();
+	size_t from = findEntry (page, inRec, keyRec, false);
+	size_t to = findEntry (page, inRec, keyRec, true);
+	if (to == page.getNumRecords ())
+		to--;
+	size_t removed = 0;
+	for (size_t i = from; i <= to && removed < limit; i++)
+		removed += remove (getChild (page, i, inRec), keyRec, exact, limit - removed);
+
+	// fixing a child can take away the entry after it, so we go from right to left
+	if (removed > 0)
+		for (size_t i = to + 1; i-- > from;)
+			fixChild (page, i);
+	return removed;
+}
+
+void MyDB_BPlusTreeReaderWriter :: fixChild (MyDB_PageReaderWriter &parentPage, size_t whichChild) {
+
+	if (parentPage.getNumRecords () < 2 || whichChild >= parentPage.getNumRecords ())
+		return;
+	MyDB_INRecordPtr inRec = getINRecord ();
+	MyDB_PageReaderWriter child = (*this)[getChild (parentPage, whichChild, inRec)];
+	if (!isUnderfull (child))
+		return;
+
+	// the child is paired up with the one before it (or after it, if it is the first one)
+	size_t left = (whichChild > 0) ? whichChild - 1 : 0;
+	int leftPage = getChild (parentPage, left, inRec);
+	int rightPage = getChild (parentPage, left + 1, inRec);
+	MyDB_PageReaderWriter leftNode = (*this)[leftPage];
+	MyDB_PageReaderWriter rightNode = (*this)[rightPage];
+	MyDB_PageType type = leftNode.getType ();
+	vector <char> leftCopy, rightCopy, parentCopy;
+	vector <void *> recs, rightRecs, parentRecs;
+	getRecords (leftNode, leftCopy, recs);
+	getRecords (rightNode, rightCopy, rightRecs);
+	getRecords (parentPage, parentCopy, parentRecs);
+	recs.insert (recs.end (), rightRecs.begin (), rightRecs.end ());
+
+	// if they fit on one page, everything goes to the right one, which keeps its entry (its key is the
+	// larger of the two); the left one is taken out of the list of leaves, and freed
+	if (getBytesNeeded (type, recs, 0, recs.size ()) <= rightNode.getPageSize ()) {
+		setRecords (rightNode, recs, 0, recs.size ());
+		if (type == MyDB_PageType :: RegularPage) {
+			int prevPage = leftNode.getPrevPage ();
+			rightNode.setPrevPage (prevPage);
+			if (prevPage != -1)
+				(*this)[prevPage].setNextPage (rightPage);
 		}
+		freePage (leftPage);
+		parentRecs.erase (parentRecs.begin () + left);
+		setRecords (parentPage, parentRecs, 0, parentRecs.size ());
+		return;
 	}
 
-	// printTree();
-	return nullptr;
+	// otherwise, split the records so that the two pages are about the same size; each one ends up at
+	// least half full, since they did not fit on one page.  The right page always keeps its last record,
+	// so the last entry of the last node on a level is still there
+	size_t total = getBytesNeeded (type, recs, 0, recs.size ());
+	size_t mid = 1;
+	while (mid < recs.size () - 1 && getBytesNeeded (type, recs, 0, mid) * 2 < total)
+		mid++;
+
+	// the left page's entry gets a new key (its largest key, or for a leaf, the separator between the two
+	// pages); a string key may be longer than the old one, and if the parent has no room for it, we leave
+	// the pages as they are
+	MyDB_INRecordPtr newEntry = getINRecord ();
+	if (type == MyDB_PageType :: DirectoryPage) {
+		MyDB_INRecordPtr largest = getINRecord ();
+		largest->fromBinary (recs[mid - 1]);
+		newEntry->setKey (getKey (largest));
+	} else {
+		MyDB_RecordPtr largest = getEmptyRecord ();
+		MyDB_RecordPtr smallest = getEmptyRecord ();
+		largest->fromBinary (recs[mid - 1]);
+		smallest->fromBinary (recs[mid]);
+		newEntry->setKey (getSeparator (getKey (largest), getKey (smallest)));
+	}
+	newEntry->setPtr (leftPage);
+	vector <char> entryBytes (newEntry->getBinarySize ());
+	newEntry->toBinary (entryBytes.data ());
+	parentRecs[left] = entryBytes.data ();
+	if (getBytesNeeded (MyDB_PageType :: DirectoryPage, parentRecs, 0, parentRecs.size ()) > parentPage.getPageSize ())
+		return;
+
+	setRecords (leftNode, recs, 0, mid);
+	setRecords (rightNode, recs, mid, recs.size ());
+	setRecords (parentPage, parentRecs, 0, parentRecs.size ());
 }
 
 MyDB_INRecordPtr MyDB_BPlusTreeReaderWriter :: getINRecord () {
-	return make_shared <MyDB_INRecord> (orderingAttType->createAttMax ());
+	return make_shared <MyDB_INRecord> (keyAttType->createAttMax ());
 }
 
 void MyDB_BPlusTreeReaderWriter :: printTree () {
@@ -344,20 +986,22 @@ void MyDB_BPlusTreeReaderWriter :: printTree () {
         for (auto &page : curr) {
             MyDB_INRecordPtr inRec = getINRecord();
             MyDB_RecordPtr rec = getEmptyRecord();
-            MyDB_RecordIteratorAltPtr pageIter = page.getIteratorAlt();
+            vector<char> storage;
+            vector<void *> recs;
+            getRecords(page, storage, recs);
             if (page.getType() == MyDB_PageType::RegularPage) {
                 cout << " { LEAF : ";
             } else {
                 cout << " { INTERNAL : ";
             }
 
-            while (pageIter->advance()) { 
+            for (void *pageRec : recs) { 
                 if (page.getType() == MyDB_PageType::DirectoryPage) {
-                    pageIter->getCurrent(inRec);
+                    inRec->fromBinary(pageRec);
                     cout << getKey(inRec)->toString() <<  "-" << inRec->getPtr() << " ";
                     children.push_back((*this)[inRec->getPtr()]);
                 } else {
-                    pageIter->getCurrent(rec);
+                    rec->fromBinary(pageRec);
                     cout << getKey(rec)->toString() << " ";
                 }
             }
@@ -376,9 +1020,49 @@ MyDB_AttValPtr MyDB_BPlusTreeReaderWriter :: getKey (MyDB_RecordPtr fromMe) {
 	if (fromMe->getSchema () == nullptr) 
 		return fromMe->getAtt (0)->getCopy ();
 
-	// in this case, got a data record
-	else 
-		return fromMe->getAtt (whichAttIsOrdering)->getCopy ();
+	// in this case, got a data record; a dictionary-encoded attribute is decoded
+	MyDB_AttValPtr key = fromMe->getAtt (whichAttIsOrdering);
+	if (keyAttType == orderingAttType)
+		return key->getCopy ();
+	MyDB_AttValPtr decoded = keyAttType->createAtt ();
+	decoded->set (key);
+	return decoded;
+}
+
+MyDB_AttValPtr MyDB_BPlusTreeReaderWriter :: getSeparator (MyDB_AttValPtr lower, MyDB_AttValPtr upper) {
+
+	// strings are compared byte-by-byte, so the prefix of upper that goes one byte past where it first
+	// differs from lower is bigger than lower, and (if it is shorter than upper) less than upper
+	if (keyAttType->promotableToInt () || keyAttType->promotableToDouble ())
+		return lower;
+	string low = lower->toString ();
+	string high = upper->toString ();
+	size_t common = 0;
+	while (common < low.size () && common < high.size () && low[common] == high[common])
+		common++;
+	if (common + 1 >= high.size ())
+		return lower;
+	MyDB_StringAttValPtr separator = make_shared <MyDB_StringAttVal> ();
+	separator->set (high.substr (0, common + 1));
+	return separator;
+}
+
+// builds a comparison of two keys where at least one is dictionary-encoded (it comes from a data
+// record, or it is a key that was given to us); these are compared by their actual values, since the
+// codes are given out in the order that the values are added
+static function <bool ()> compareDecoded (MyDB_AttValPtr lhAtt, MyDB_AttValPtr rhAtt, bool asInts, bool orEqual) {
+	MyDB_DictAttVal *lhDict = dynamic_cast <MyDB_DictAttVal *> (lhAtt.get ());
+	MyDB_DictAttVal *rhDict = dynamic_cast <MyDB_DictAttVal *> (rhAtt.get ());
+	return [lhAtt, rhAtt, lhDict, rhDict, asInts, orEqual] {
+		MyDB_Value lhVal = (lhDict != nullptr) ? lhDict->getDecodedValue () : lhAtt->getValue ();
+		MyDB_Value rhVal = (rhDict != nullptr) ? rhDict->getDecodedValue () : rhAtt->getValue ();
+		int res;
+		if (asInts)
+			res = (lhVal.toInt () > rhVal.toInt ()) - (lhVal.toInt () < rhVal.toInt ());
+		else
+			res = lhVal.compareAsStrings (rhVal);
+		return orEqual ? res <= 0 : res < 0;
+	};
 }
 
 function <bool ()>  MyDB_BPlusTreeReaderWriter :: buildComparator (MyDB_RecordPtr lhs, MyDB_RecordPtr rhs) {
@@ -404,12 +1088,14 @@ function <bool ()>  MyDB_BPlusTreeReaderWriter :: buildComparator (MyDB_RecordPt
 	}
 	
 	// now, build the comparison lambda and return
-	if (orderingAttType->promotableToInt ()) {
-		return [lhAtt, rhAtt] {return lhAtt->toInt () < rhAtt->toInt ();};
-	} else if (orderingAttType->promotableToDouble ()) {
-		return [lhAtt, rhAtt] {return lhAtt->toDouble () < rhAtt->toDouble ();};
-	} else if (orderingAttType->promotableToString ()) {
-		return [lhAtt, rhAtt] {return lhAtt->toString () < rhAtt->toString ();};
+	if (dynamic_cast <MyDB_DictAttVal *> (lhAtt.get ()) != nullptr || dynamic_cast <MyDB_DictAttVal *> (rhAtt.get ()) != nullptr)
+		return compareDecoded (lhAtt, rhAtt, keyAttType->promotableToInt (), false);
+	if (keyAttType->promotableToInt ()) {
+		return [lhAtt, rhAtt] {return lhAtt->getValue ().toInt () < rhAtt->getValue ().toInt ();};
+	} else if (keyAttType->promotableToDouble ()) {
+		return [lhAtt, rhAtt] {return lhAtt->getValue ().toDouble () < rhAtt->getValue ().toDouble ();};
+	} else if (keyAttType->promotableToString ()) {
+		return [lhAtt, rhAtt] {return lhAtt->getValue ().compareAsStrings (rhAtt->getValue ()) < 0;};
 	} else {
 		cout << "This is bad... cannot do anything with the >.\n";
 		exit (1);
@@ -439,12 +1125,14 @@ function<bool()> MyDB_BPlusTreeReaderWriter :: buildEqualToComparator (MyDB_Reco
 	}
 	
 	// now, build the comparison lambda and return
-	if (orderingAttType->promotableToInt ()) {
-		return [lhAtt, rhAtt] { return lhAtt->toInt () <= rhAtt->toInt (); };
-	} else if (orderingAttType->promotableToDouble ()) {
-		return [lhAtt, rhAtt] { return lhAtt->toDouble () <= rhAtt->toDouble (); };
-	} else if (orderingAttType->promotableToString ()) {
-		return [lhAtt, rhAtt] { return lhAtt->toString () <= rhAtt->toString (); };
+	if (dynamic_cast <MyDB_DictAttVal *> (lhAtt.get ()) != nullptr || dynamic_cast <MyDB_DictAttVal *> (rhAtt.get ()) != nullptr)
+		return compareDecoded (lhAtt, rhAtt, keyAttType->promotableToInt (), true);
+	if (keyAttType->promotableToInt ()) {
+		return [lhAtt, rhAtt] { return lhAtt->getValue ().toInt () <= rhAtt->getValue ().toInt (); };
+	} else if (keyAttType->promotableToDouble ()) {
+		return [lhAtt, rhAtt] { return lhAtt->getValue ().toDouble () <= rhAtt->getValue ().toDouble (); };
+	} else if (keyAttType->promotableToString ()) {
+		return [lhAtt, rhAtt] { return lhAtt->getValue ().compareAsStrings (rhAtt->getValue ()) <= 0; };
 	} else {
 		cout << "This is bad... cannot do anything with the <=.\n";
 		exit (1);
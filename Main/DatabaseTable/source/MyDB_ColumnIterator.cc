@@ -0,0 +1,147 @@
+
+#ifndef COLUMN_ITER_C
+#define COLUMN_ITER_C
+
+#include <cstring>
+#include <iostream>
+#include "MyDB_ColumnIterator.h"
+#include "MyDB_PaxPage.h"
+
+using namespace std;
+
+size_t MyDB_ColumnBatch :: getNumRows () {
+	return numRows;
+}
+
+size_t MyDB_ColumnBatch :: getNumCols () {
+	return cols.size ();
+}
+
+MyDB_ValueType MyDB_ColumnBatch :: getType (size_t whichCol) {
+	return cols[whichCol].type;
+}
+
+int *MyDB_ColumnBatch :: getInts (size_t whichCol) {
+	return (int *) cols[whichCol].start;
+}
+
+double *MyDB_ColumnBatch :: getDoubles (size_t whichCol) {
+	return (double *) cols[whichCol].start;
+}
+
+char *MyDB_ColumnBatch :: getBools (size_t whichCol) {
+	return cols[whichCol].start;
+}
+
+MyDB_Value MyDB_ColumnBatch :: getValue (size_t whichCol, size_t whichRow) {
+	Column &col = cols[whichCol];
+	return getMiniPageValue (col.type, col.start, col.end, whichRow);
+}
+
+MyDB_DictionaryPtr MyDB_ColumnBatch :: getDictionary (size_t whichCol) {
+	return cols[whichCol].dictionary;
+}
+
+bool MyDB_ColumnIterator :: advance () {
+
+	while (curPage < myParent.getNumPages () - 1) {
+		curPage++;
+		pinnedPage = make_shared <MyDB_PageReaderWriter> (true, myParent, curPage);
+		MyDB_PageType type = pinnedPage->getType ();
+		if (type == MyDB_PageType :: DirectoryPage)
+			continue;
+
+		// on a PAX page, the columns are the minipages
+		batch.cols.resize (whichAtts.size ());
+		for (size_t i = 0; i < whichAtts.size (); i++)
+			batch.cols[i].dictionary = dictionaries[i];
+		if (type == MyDB_PageType :: PaxPage) {
+			char *bytes = (char *) pinnedPage->getBytes ();
+			MyDB_MiniPage *miniPages = getMiniPages (bytes);
+			batch.numRows = getPaxNumRecs (bytes);
+			for (size_t i = 0; i < whichAtts.size (); i++) {
+				MyDB_MiniPage &mini = miniPages[whichAtts[i]];
+				batch.cols[i].type = types[i];
+				batch.cols[i].start = bytes + mini.start;
+				batch.cols[i].end = bytes + mini.start + mini.capacity;
+			}
+		} else {
+			copyColumns (*pinnedPage);
+		}
+
+		if (batch.numRows != 0)
+			return true;
+	}
+	pinnedPage = nullptr;
+	return false;
+}
+
+void MyDB_ColumnIterator :: copyColumns (MyDB_PageReaderWriter &fromMe) {
+
+	batch.numRows = fromMe.getNumRecords ();
+	batch.copies.resize (whichAtts.size ());
+	for (size_t i = 0; i < whichAtts.size (); i++) {
+
+		// go through the records, and find the attribute in each one by hopping over the ones before it
+		vector <char> &copy = batch.copies[i];
+		ends.clear ();
+		chars.clear ();
+		copy.clear ();
+		for (size_t j = 0; j < batch.numRows; j++) {
+			char *att = ((char *) fromMe.getRecordPointer (j)) + sizeof (short);
+			for (int k = 0; k < whichAtts[i]; k++)
+				att += *((short *) att);
+			size_t len = *((short *) att) - sizeof (short);
+			if (types[i] == MyDB_ValueType :: StringVal) {
+				chars.insert (chars.end (), att + sizeof (short), att + sizeof (short) + len);
+				ends.push_back (chars.size ());
+			} else {
+				copy.insert (copy.end (), att + sizeof (short), att + sizeof (short) + len);
+			}
+		}
+
+		// strings are laid out just as in a minipage: the ends at the front, and the strings going
+		// down from the back
+		if (types[i] == MyDB_ValueType :: StringVal) {
+			size_t endsSize = ends.size () * sizeof (uint32_t);
+			copy.resize (endsSize + chars.size ());
+			if (endsSize != 0)
+				memcpy (copy.data (), ends.data (), endsSize);
+			for (size_t j = 0; j < ends.size (); j++) {
+				uint32_t from = (j == 0) ? 0 : ends[j - 1];
+				memcpy (copy.data () + copy.size () - ends[j], chars.data () + from, ends[j] - from);
+			}
+		}
+
+		batch.cols[i].type = types[i];
+		batch.cols[i].start = copy.data ();
+		batch.cols[i].end = copy.data () + copy.size ();
+	}
+}
+
+MyDB_ColumnBatch &MyDB_ColumnIterator :: getCurrent () {
+	return batch;
+}
+
+MyDB_ColumnIterator :: MyDB_ColumnIterator (MyDB_TableReaderWriter &myParentIn, vector <string> atts) :
+	myParent (myParentIn) {
+
+	MyDB_SchemaPtr mySchema = myParent.getTable ()->getSchema ();
+	vector <MyDB_ValueType> allTypes = getPaxTypes (mySchema);
+	for (string &att : atts) {
+		int whichAtt = mySchema->getAttByName (att).first;
+		if (whichAtt == -1) {
+			cout << "Could not find attribute " << att << " to iterate over.\n";
+			exit (1);
+		}
+		whichAtts.push_back (whichAtt);
+		types.push_back (allTypes[whichAtt]);
+		dictionaries.push_back (mySchema->getAtts ()[whichAtt].second->getDictionary ());
+	}
+	curPage = -1;
+	batch.numRows = 0;
+}
+
+MyDB_ColumnIterator :: ~MyDB_ColumnIterator () {}
+
+#endif
@@ -0,0 +1,44 @@
+
+#ifndef FILTERED_REC_ITER_ALT_C
+#define FILTERED_REC_ITER_ALT_C
+
+#include "MyDB_FilteredRecIteratorAlt.h"
+
+void MyDB_FilteredRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	input->getCurrent (intoMe);
+}
+
+void *MyDB_FilteredRecIteratorAlt :: getCurrentPointer () {
+	return input->getCurrentPointer ();
+}
+
+bool MyDB_FilteredRecIteratorAlt :: advance () {
+	while (input->advance ()) {
+
+		// if we can, check the record without deserializing it
+		if (fastPred != nullptr) {
+			if (fastPred (input->getCurrentPointer ()))
+				return true;
+
+		// otherwise, load it up and run the full computation
+		} else {
+			input->getCurrent (scratch);
+			if (slowPred ())
+				return true;
+		}
+	}
+	return false;
+}
+
+MyDB_FilteredRecIteratorAlt :: MyDB_FilteredRecIteratorAlt (MyDB_RecordIteratorAltPtr inputIn, 
+	MyDB_RecordPtr scratchIn, string pred) {
+	input = inputIn;
+	scratch = scratchIn;
+	fastPred = scratch->compileBinaryPredicate (pred);
+	if (fastPred == nullptr)
+		slowPred = scratch->compilePredicate (pred);
+}
+
+MyDB_FilteredRecIteratorAlt :: ~MyDB_FilteredRecIteratorAlt () {}
+
+#endif
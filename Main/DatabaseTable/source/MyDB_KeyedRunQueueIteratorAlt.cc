@@ -0,0 +1,62 @@
+
+#ifndef KEYED_RUN_QITER_ALT_C
+#define KEYED_RUN_QITER_ALT_C
+
+#include <algorithm>
+#include "MyDB_KeyedRunQueueIteratorAlt.h"
+
+using namespace std;
+
+// orders the heap so that the run with the smallest key is at the front
+static bool keyIsGreater (const pair <string, MyDB_RecordIteratorAltPtr> &lhs, 
+	const pair <string, MyDB_RecordIteratorAltPtr> &rhs) {
+	return MyDB_SortKey :: compare (lhs.first.data (), lhs.first.size (), rhs.first.data (), rhs.first.size ()) > 0;
+}
+
+void MyDB_KeyedRunQueueIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	intoMe->fromBinary (runs.front ().second->getCurrentPointer ());
+}
+
+void *MyDB_KeyedRunQueueIteratorAlt :: getCurrentPointer () {
+	return runs.front ().second->getCurrentPointer ();
+}
+
+MyDB_KeyedRunQueueIteratorAlt :: MyDB_KeyedRunQueueIteratorAlt (MyDB_SortKeyPtr sortKeyIn) {
+	sortKey = sortKeyIn;
+	firstTime = true;
+}
+
+void MyDB_KeyedRunQueueIteratorAlt :: addRun (MyDB_RecordIteratorAltPtr addMe) {
+	if (!addMe->advance ())
+		return;
+	runs.push_back (make_pair (string (), addMe));
+	sortKey->encode (addMe->getCurrentPointer (), runs.back ().first);
+	push_heap (runs.begin (), runs.end (), keyIsGreater);
+}
+	
+bool MyDB_KeyedRunQueueIteratorAlt :: advance () {
+
+	if (firstTime) {
+		firstTime = false;
+		return runs.size () != 0;
+	}
+
+	if (runs.size () == 0)
+		return false;
+
+	// move the front run to the back, and advance it; its key is re-built in place, so the
+	// string's storage gets re-used
+	pop_heap (runs.begin (), runs.end (), keyIsGreater);
+	if (runs.back ().second->advance ()) {
+		sortKey->encode (runs.back ().second->getCurrentPointer (), runs.back ().first);
+		push_heap (runs.begin (), runs.end (), keyIsGreater);
+	} else {
+		runs.pop_back ();
+	}
+
+	return runs.size () != 0;
+}
+
+MyDB_KeyedRunQueueIteratorAlt :: ~MyDB_KeyedRunQueueIteratorAlt () {}
+
+#endif
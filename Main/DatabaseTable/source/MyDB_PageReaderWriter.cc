@@ -18,10 +18,16 @@
 #include "MyDB_PageRecIterator.h"
 #include "MyDB_PageRecIteratorAlt.h"
 #include "MyDB_PageListIteratorAlt.h"
+#include "MyDB_PageLayout.h"
+#include "MyDB_PaxPage.h"
+#include "MyDB_PaxPageRecIterator.h"
+#include "MyDB_PaxPageRecIteratorAlt.h"
 #include "RecordComparator.h"
 
-#define PAGE_TYPE *((MyDB_PageType *) ((char *) myPage->getBytes ()))
-#define NUM_BYTES_USED *((size_t *) (((char *) myPage->getBytes ()) + sizeof (size_t)))
+// see MyDB_PageLayout.h
+#define PAGE_TYPE getPageType (myPage->getBytes ())
+#define NUM_BYTES_USED getPageBytesUsed (myPage->getBytes ())
+#define NUM_SLOTS getPageNumSlots (myPage->getBytes ())
 #define NUM_BYTES_LEFT (pageSize - NUM_BYTES_USED)
 
 MyDB_PageReaderWriter :: MyDB_PageReaderWriter (MyDB_TableReaderWriter &parent, int whichPage) {
@@ -60,8 +66,37 @@ MyDB_PageReaderWriter :: MyDB_PageReaderWriter (bool pinned, MyDB_BufferManager
 }
 
 void MyDB_PageReaderWriter :: clear () {
-	NUM_BYTES_USED = 2 * sizeof (size_t);
+	NUM_BYTES_USED = PAGE_HEADER_SIZE;
+	NUM_SLOTS = 0;
 	PAGE_TYPE = MyDB_PageType :: RegularPage;
+	getPageNext (myPage->getBytes ()) = NO_PAGE;
+	getPagePrev (myPage->getBytes ()) = NO_PAGE;
+	myPage->wroteBytes ();	
+}
+
+int MyDB_PageReaderWriter :: getNextPage () {
+	size_t next = getPageNext (myPage->getBytes ());
+	return (next == NO_PAGE) ? -1 : (int) next;
+}
+
+void MyDB_PageReaderWriter :: setNextPage (int toMe) {
+	getPageNext (myPage->getBytes ()) = (toMe == -1) ? NO_PAGE : (size_t) toMe;
+	myPage->wroteBytes ();	
+}
+
+int MyDB_PageReaderWriter :: getPrevPage () {
+	size_t prev = getPagePrev (myPage->getBytes ());
+	return (prev == NO_PAGE) ? -1 : (int) prev;
+}
+
+void MyDB_PageReaderWriter :: setPrevPage (int toMe) {
+	getPagePrev (myPage->getBytes ()) = (toMe == -1) ? NO_PAGE : (size_t) toMe;
+	myPage->wroteBytes ();	
+}
+
+void MyDB_PageReaderWriter :: clearPax (MyDB_SchemaPtr forMe) {
+	vector <MyDB_ValueType> types = getPaxTypes (forMe);
+	formatPaxPage (myPage->getBytes (), pageSize, types);
 	myPage->wroteBytes ();	
 }
 
@@ -74,10 +109,14 @@ MyDB_RecordIteratorAltPtr getIteratorAlt (vector <MyDB_PageReaderWriter> &forUs)
 }
 
 MyDB_RecordIteratorPtr MyDB_PageReaderWriter :: getIterator (MyDB_RecordPtr iterateIntoMe) {
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage)
+		return make_shared <MyDB_PaxPageRecIterator> (myPage, iterateIntoMe);
 	return make_shared <MyDB_PageRecIterator> (myPage, iterateIntoMe);
 }
 
 MyDB_RecordIteratorAltPtr MyDB_PageReaderWriter :: getIteratorAlt () {
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage)
+		return make_shared <MyDB_PaxPageRecIteratorAlt> (myPage);
 	return make_shared <MyDB_PageRecIteratorAlt> (myPage);
 }
 
@@ -87,89 +126,205 @@ void MyDB_PageReaderWriter :: setType (MyDB_PageType toMe) {
 }
 
 void *MyDB_PageReaderWriter :: appendAndReturnLocation (MyDB_RecordPtr appendMe) {
-	void *recLocation = NUM_BYTES_USED + (char *)  myPage->getBytes ();
-	if (append (appendMe))
-		return recLocation;
-	else
-		return nullptr;
+	void *loc = appendBytes (appendMe->getBinarySize ());
+	if (loc != nullptr)
+		appendMe->toBinary (loc);
+	return loc;
 }
 
-bool MyDB_PageReaderWriter :: append (MyDB_RecordPtr appendMe) {
-	
-	size_t recSize = appendMe->getBinarySize ();
-	if (recSize > NUM_BYTES_LEFT)
+bool MyDB_PageReaderWriter :: appendBinary (void *serializedRec) {
+
+	// on a PAX page, the record is split up among the minipages
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage) {
+		if (!appendToPaxPage (myPage->getBytes (), pageSize, serializedRec))
+			return false;
+		myPage->wroteBytes ();
+		return true;
+	}
+
+	short recSize = *((short *) serializedRec);
+	void *loc = appendBytes (recSize);
+	if (loc == nullptr)
 		return false;
+	memcpy (loc, serializedRec, recSize);
+	return true;
+}
 
-	// write at the end
-	void *address = myPage->getBytes ();
-	appendMe->toBinary (NUM_BYTES_USED + (char *) address);
-	NUM_BYTES_USED += recSize;
+void *MyDB_PageReaderWriter :: appendBytes (size_t numBytes) {
+
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage) {
+		cout << "Can't reserve bytes for a record on a PAX page.\n";
+		exit (1);
+	}
+
+	// we need room for the record and for its slot
+	if (numBytes + sizeof (MyDB_SlotType) > NUM_BYTES_LEFT)
+		return nullptr;
+
+	// the records are written from the end of the page towards the front; the bytes used by the
+	// records are all of the bytes used, except for the header and the slots
+	char *bytes = (char *) myPage->getBytes ();
+	size_t recBytesUsed = NUM_BYTES_USED - PAGE_HEADER_SIZE - NUM_SLOTS * sizeof (MyDB_SlotType);
+	size_t offset = pageSize - recBytesUsed - numBytes;
+	getPageSlots (bytes)[NUM_SLOTS] = (MyDB_SlotType) offset;
+	NUM_SLOTS++;
+	NUM_BYTES_USED += numBytes + sizeof (MyDB_SlotType);
 	myPage->wroteBytes ();
+	return bytes + offset;
+}
+
+bool MyDB_PageReaderWriter :: insert (size_t where, MyDB_RecordPtr insertMe) {
+
+	// the record goes in the last slot, and then the slots from where on are shifted over to make room
+	void *loc = appendBytes (insertMe->getBinarySize ());
+	if (loc == nullptr)
+		return false;
+	insertMe->toBinary (loc);
+	MyDB_SlotType *slots = getPageSlots (myPage->getBytes ());
+	MyDB_SlotType newSlot = slots[NUM_SLOTS - 1];
+	memmove (slots + where + 1, slots + where, (NUM_SLOTS - 1 - where) * sizeof (MyDB_SlotType));
+	slots[where] = newSlot;
 	return true;
 }
 
-void MyDB_PageReaderWriter :: 
-	sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
+size_t MyDB_PageReaderWriter :: getNumRecords () {
+	return NUM_SLOTS;
+}
+
+void *MyDB_PageReaderWriter :: getRecordPointer (size_t whichRec) {
+	return getPageRecord (myPage->getBytes (), whichRec);
+}
 
-	void *temp = malloc (pageSize);
-	memcpy (temp, myPage->getBytes (), pageSize);
+void MyDB_PageReaderWriter :: getRecord (size_t whichRec, MyDB_RecordPtr intoMe) {
+	intoMe->fromBinary (getRecordPointer (whichRec));
+}
 
-	// first, read in the positions of all of the records
-	vector <void *> positions;
+size_t MyDB_PageReaderWriter :: lowerBound (function <bool ()> comparator, MyDB_RecordPtr lhs) {
 	
-	// this basically iterates through all of the records on the page
-	int bytesConsumed = sizeof (size_t) * 2;
-	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) temp;
-		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
+	// the records on the page are loaded into lhs
+	size_t low = 0, high = NUM_SLOTS;
+	while (low < high) {
+		size_t mid = (low + high) / 2;
+		lhs->fromBinary (getRecordPointer (mid));
+		if (comparator ())
+			low = mid + 1;
+		else
+			high = mid;
 	}
+	return low;
+}
 
-	// and now we sort the vector of positions, using the record contents to build a comparator
-	RecordComparator myComparator (comparator, lhs, rhs);
-	std::stable_sort (positions.begin (), positions.end (), myComparator);
+bool MyDB_PageReaderWriter :: append (MyDB_RecordPtr appendMe) {
 
-	// and write the guys back
-	NUM_BYTES_USED = 2 * sizeof (size_t);
-	myPage->wroteBytes ();	
-	for (void *pos : positions) {
-		lhs->fromBinary (pos);
-		append (lhs);
+	// a PAX page needs the serialized record to split up
+	if (PAGE_TYPE == MyDB_PageType :: PaxPage) {
+		vector <char> recBytes (appendMe->getBinarySize ());
+		appendMe->toBinary (recBytes.data ());
+		return appendBinary (recBytes.data ());
+	}
+	
+	// write at the end
+	void *loc = appendBytes (appendMe->getBinarySize ());
+	if (loc == nullptr)
+		return false;
+	appendMe->toBinary (loc);
+	return true;
+}
+
+// only the slots of a regular page are sorted; a PAX page has no slots
+static void checkSortable (void *page) {
+	if (getPageType (page) == MyDB_PageType :: PaxPage) {
+		cout << "Can't sort a PAX page.\n";
+		exit (1);
 	}
+}
+
+// sorts the slots of the given page image, using the record contents to build a comparator
+static void sortSlots (void *page, function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
+	checkSortable (page);
+	RecordComparator myComparator (comparator, lhs, rhs);
+	char *bytes = (char *) page;
+	MyDB_SlotType *slots = getPageSlots (page);
+	std::stable_sort (slots, slots + getPageNumSlots (page), [&] (MyDB_SlotType lhsSlot, MyDB_SlotType rhsSlot) {
+		return myComparator (bytes + lhsSlot, bytes + rhsSlot);
+	});
+}
+
+void MyDB_PageReaderWriter :: 
+	sortInPlace (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
 
-	free (temp);
+	// only the slots move
+	sortSlots (myPage->getBytes (), comparator, lhs, rhs);
+	myPage->wroteBytes ();	
 }
 
 MyDB_PageReaderWriterPtr MyDB_PageReaderWriter :: 
 	sort (function <bool ()> comparator, MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs) {
 
-	// first, read in the positions of all of the records
-	vector <void *> positions;
-	
-	// this basically iterates through all of the records on the page
-	int bytesConsumed = sizeof (size_t) * 2;
-	while (bytesConsumed != NUM_BYTES_USED) {
-		void *pos = bytesConsumed + (char *) myPage->getBytes ();
-		positions.push_back (pos);
-		void *nextPos = lhs->fromBinary (pos);
-		bytesConsumed += ((char *) nextPos) - ((char *) pos);
+	// copy the page over, and sort the copy's slots
+	MyDB_PageReaderWriterPtr returnVal = make_shared <MyDB_PageReaderWriter> (myPage->getParent ());
+	returnVal->copyFrom (*this);
+	sortSlots (returnVal->getBytes (), comparator, lhs, rhs);
+	return returnVal;
+}
+
+void MyDB_PageReaderWriter :: copyFrom (MyDB_PageReaderWriter &fromMe) {
+
+	// the header and slots are at the front of the page, and the records are at the back
+	char *from = (char *) fromMe.getBytes ();
+	char *to = (char *) myPage->getBytes ();
+	size_t frontBytes = PAGE_HEADER_SIZE + getPageNumSlots (from) * sizeof (MyDB_SlotType);
+	size_t backBytes = getPageBytesUsed (from) - frontBytes;
+	memcpy (to, from, frontBytes);
+	memcpy (to + pageSize - backBytes, from + pageSize - backBytes, backBytes);
+	myPage->wroteBytes ();
+}
+
+void MyDB_PageReaderWriter :: 
+	getSortedKeys (void *fromHere, MyDB_SortKeyPtr sortKey, vector <MyDB_KeyedRec> &recs, string &arena) {
+
+	// build the keys, in slot order
+	checkSortable (fromHere);
+	size_t numSlots = getPageNumSlots (fromHere);
+	for (size_t i = 0; i < numSlots; i++) {
+		MyDB_KeyedRec rec;
+		rec.rec = getPageRecord (fromHere, i);
+		rec.keyOffset = arena.size ();
+		sortKey->appendKey (rec.rec, arena);
+		rec.keyLen = arena.size () - rec.keyOffset;
+		recs.push_back (rec);
 	}
 
-	// and now we sort the vector of positions, using the record contents to build a comparator
-	RecordComparator myComparator (comparator, lhs, rhs);
-	std::stable_sort (positions.begin (), positions.end (), myComparator);
+	// the arena is done growing, so now we can get the prefixes
+	for (MyDB_KeyedRec &rec : recs) 
+		rec.prefix = MyDB_SortKey :: getPrefix (arena.data () + rec.keyOffset, rec.keyLen);
+
+	std::stable_sort (recs.begin (), recs.end (), MyDB_KeyedRecComparator (arena.data ()));
+
+	// and write the sorted order back into the slots
+	MyDB_SlotType *slots = getPageSlots (fromHere);
+	for (size_t i = 0; i < numSlots; i++)
+		slots[i] = (MyDB_SlotType) (((char *) recs[i].rec) - (char *) fromHere);
+}
 
-	// and now create the page to return
+void MyDB_PageReaderWriter :: sortInPlace (MyDB_SortKeyPtr sortKey) {
+
+	// only the slots move
+	vector <MyDB_KeyedRec> recs;
+	string arena;
+	getSortedKeys (myPage->getBytes (), sortKey, recs, arena);
+	myPage->wroteBytes ();	
+}
+
+MyDB_PageReaderWriterPtr MyDB_PageReaderWriter :: sort (MyDB_SortKeyPtr sortKey) {
+
+	// copy the page over, and sort the copy's slots
 	MyDB_PageReaderWriterPtr returnVal = make_shared <MyDB_PageReaderWriter> (myPage->getParent ());
-	returnVal->clear ();
-	
-	// loop through all of the sorted records and write them out
-	for (void *pos : positions) {
-		lhs->fromBinary (pos);
-		returnVal->append (lhs);
-	}
+	returnVal->copyFrom (*this);
 
+	vector <MyDB_KeyedRec> recs;
+	string arena;
+	returnVal->getSortedKeys (returnVal->getBytes (), sortKey, recs, arena);
 	return returnVal;
 }
 
@@ -181,4 +336,8 @@ void *MyDB_PageReaderWriter :: getBytes () {
 	return myPage->getBytes ();
 }
 
+void MyDB_PageReaderWriter :: wroteBytes () {
+	myPage->wroteBytes ();
+}
+
 #endif
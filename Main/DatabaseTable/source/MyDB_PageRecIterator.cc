@@ -14,26 +14,23 @@
 #define PAGE_REC_ITER_C
 
 #include "MyDB_PageRecIterator.h"
-#include "MyDB_PageType.h"
-
-#define NUM_BYTES_USED *((size_t *) (((char *) myPage->getBytes ()) + sizeof (size_t)))
+#include "MyDB_PageLayout.h"
 
 void MyDB_PageRecIterator :: getNext () {
-	void *pos = bytesConsumed + (char *) myPage->getBytes ();
- 	void *nextPos = myRec->fromBinary (pos);
-	bytesConsumed += ((char *) nextPos) - ((char *) pos);	
+	myRec->fromBinary (getPageRecord (myPage->getBytes (), curSlot));
+	curSlot++;
 }
 
 void *MyDB_PageRecIterator :: getCurrentPointer () {
-	return bytesConsumed + (char *) myPage->getBytes ();
+	return getPageRecord (myPage->getBytes (), curSlot);
 }
 
 bool MyDB_PageRecIterator :: hasNext () {
-	return bytesConsumed != NUM_BYTES_USED;
+	return curSlot < getPageNumSlots (myPage->getBytes ());
 }
 
 MyDB_PageRecIterator :: MyDB_PageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn) {
-	bytesConsumed = sizeof (size_t) * 2;
+	curSlot = 0;
 	myPage = myPageIn;
 	myRec = myRecIn;
 }
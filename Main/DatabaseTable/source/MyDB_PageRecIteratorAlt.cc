@@ -14,34 +14,33 @@
 #define PAGE_REC_ITER_ALT_C
 
 #include "MyDB_PageRecIteratorAlt.h"
-#include "MyDB_PageType.h"
-
-#define NUM_BYTES_USED *((size_t *) (((char *) myPage->getBytes ()) + sizeof (size_t)))
+#include "MyDB_PageLayout.h"
 
 void MyDB_PageRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
-	void *pos = bytesConsumed + (char *) myPage->getBytes ();
- 	void *nextPos = intoMe->fromBinary (pos);
-	nextRecSize = ((char *) nextPos) - ((char *) pos);	
+	intoMe->fromBinary (getPageRecord (myPage->getBytes (), curSlot));
 }
 
 void *MyDB_PageRecIteratorAlt :: getCurrentPointer () {
-	return bytesConsumed + (char *) myPage->getBytes ();
+	return getPageRecord (myPage->getBytes (), curSlot);
 }
 
 bool MyDB_PageRecIteratorAlt :: advance () {
-	if (nextRecSize == -1) {
-		cout << "You can't call advance without calling getCurrent!!\n";
-		exit (1);
+
+	// the records are visited in slot order, so there is nothing to skip over
+	size_t numSlots = getPageNumSlots (myPage->getBytes ());
+	if (curSlot + 1 >= numSlots) {
+		curSlot = numSlots;
+		return false;
 	}
-	bytesConsumed += nextRecSize;
-	nextRecSize = -1;
-	return bytesConsumed != NUM_BYTES_USED;
+	curSlot++;
+	return true;
 }
 
 MyDB_PageRecIteratorAlt :: MyDB_PageRecIteratorAlt (MyDB_PageHandle myPageIn) {
-	bytesConsumed = sizeof (size_t) * 2;
 	myPage = myPageIn;
-	nextRecSize = 0;
+
+	// this wraps around to zero on the first call to advance
+	curSlot = (size_t) -1;
 }
 
 MyDB_PageRecIteratorAlt :: ~MyDB_PageRecIteratorAlt () {}
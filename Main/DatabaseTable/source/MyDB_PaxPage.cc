@@ -0,0 +1,198 @@
+
+#ifndef PAX_PAGE_C
+#define PAX_PAGE_C
+
+#include <cstdlib>
+#include <cstring>
+#include "MyDB_PaxPage.h"
+
+using namespace std;
+
+// everything in a PAX page is kept on an eight-byte boundary, so the arrays of values can be used directly
+#define PAX_ALIGN(x) (((x) + 7) & ~((size_t) 7))
+
+// the number of bytes taken by one value of a fixed-size type
+static size_t getWidth (MyDB_ValueType type) {
+	switch (type) {
+	case MyDB_ValueType :: IntVal:
+		return sizeof (int);
+	case MyDB_ValueType :: DoubleVal:
+		return sizeof (double);
+	case MyDB_ValueType :: BoolVal:
+		return sizeof (char);
+	default:
+		return 0;
+	}
+}
+
+// the number of bytes that a value (given as one attribute of a serialized record) takes in a minipage
+static size_t getNeeded (MyDB_ValueType type, char *att) {
+	if (type == MyDB_ValueType :: StringVal)
+		return sizeof (uint32_t) + *((short *) att) - sizeof (short);
+	return getWidth (type);
+}
+
+vector <MyDB_ValueType> getPaxTypes (MyDB_SchemaPtr forMe) {
+	vector <MyDB_ValueType> returnVal;
+	for (auto &att : forMe->getAtts ()) {
+		string type = att.second->toString ();
+		if (type == "int" || type == "dict")
+			returnVal.push_back (MyDB_ValueType :: IntVal);
+		else if (type == "double")
+			returnVal.push_back (MyDB_ValueType :: DoubleVal);
+		else if (type == "bool")
+			returnVal.push_back (MyDB_ValueType :: BoolVal);
+		else
+			returnVal.push_back (MyDB_ValueType :: StringVal);
+	}
+	return returnVal;
+}
+
+void formatPaxPage (void *page, size_t pageSize, vector <MyDB_ValueType> &types) {
+
+	getPageType (page) = MyDB_PageType :: PaxPage;
+	getPaxNumRecs (page) = 0;
+	getPaxNumAtts (page) = types.size ();
+	size_t headerSize = PAX_HEADER_SIZE + types.size () * sizeof (MyDB_MiniPage);
+	getPageBytesUsed (page) = headerSize;
+
+	// until we see some records, guess that a string is about 24 characters long
+	size_t totalWeight = 0;
+	for (MyDB_ValueType type : types)
+		totalWeight += (type == MyDB_ValueType :: StringVal) ? 28 : getWidth (type);
+
+	size_t pos = headerSize, spaceLeft = pageSize - headerSize;
+	MyDB_MiniPage *miniPages = getMiniPages (page);
+	for (size_t i = 0; i < types.size (); i++) {
+		size_t weight = (types[i] == MyDB_ValueType :: StringVal) ? 28 : getWidth (types[i]);
+		miniPages[i].type = (uint32_t) types[i];
+		miniPages[i].start = pos;
+		miniPages[i].capacity = (spaceLeft * weight / totalWeight) & ~((size_t) 7);
+		miniPages[i].used = 0;
+		pos += miniPages[i].capacity;
+	}
+}
+
+// re-packs the minipages so that there is room in each one for the given record; returns false if
+// there is not enough room on the page
+static bool repackPaxPage (void *page, size_t pageSize, void *serializedRec) {
+
+	size_t numAtts = getPaxNumAtts (page);
+	size_t numRecs = getPaxNumRecs (page);
+	MyDB_MiniPage *miniPages = getMiniPages (page);
+	size_t headerSize = PAX_HEADER_SIZE + numAtts * sizeof (MyDB_MiniPage);
+
+	// figure out how much room each minipage needs
+	vector <size_t> needed (numAtts);
+	size_t totalNeeded = 0, totalAligned = 0;
+	char *att = ((char *) serializedRec) + sizeof (short);
+	for (size_t i = 0; i < numAtts; i++) {
+		needed[i] = miniPages[i].used + getNeeded ((MyDB_ValueType) miniPages[i].type, att);
+		totalNeeded += needed[i];
+		totalAligned += PAX_ALIGN (needed[i]);
+		att += *((short *) att);
+	}
+	if (headerSize + totalAligned > pageSize)
+		return false;
+
+	// split the free space up in proportion to the room needed, and move each minipage over
+	char *oldPage = (char *) malloc (pageSize);
+	memcpy (oldPage, page, pageSize);
+	MyDB_MiniPage *oldMiniPages = getMiniPages (oldPage);
+	size_t spaceLeft = pageSize - headerSize - totalAligned;
+	size_t pos = headerSize;
+	for (size_t i = 0; i < numAtts; i++) {
+		MyDB_MiniPage &from = oldMiniPages[i];
+		MyDB_MiniPage &to = miniPages[i];
+		to.start = pos;
+		to.capacity = PAX_ALIGN (needed[i]) + ((spaceLeft * needed[i] / totalNeeded) & ~((size_t) 7));
+		pos += to.capacity;
+
+		// a string minipage has its ends at the front and its strings at the back
+		if (from.type == (uint32_t) MyDB_ValueType :: StringVal) {
+			size_t endsSize = numRecs * sizeof (uint32_t);
+			size_t charsSize = from.used - endsSize;
+			memcpy (((char *) page) + to.start, oldPage + from.start, endsSize);
+			memcpy (((char *) page) + to.start + to.capacity - charsSize, oldPage + from.start + from.capacity - charsSize, charsSize);
+		} else {
+			memcpy (((char *) page) + to.start, oldPage + from.start, from.used);
+		}
+	}
+	free (oldPage);
+	return true;
+}
+
+bool appendToPaxPage (void *page, size_t pageSize, void *serializedRec) {
+
+	size_t numAtts = getPaxNumAtts (page);
+	size_t numRecs = getPaxNumRecs (page);
+	MyDB_MiniPage *miniPages = getMiniPages (page);
+
+	// see if the record fits into all of the minipages
+	bool fits = true;
+	size_t totalNeeded = 0;
+	char *att = ((char *) serializedRec) + sizeof (short);
+	for (size_t i = 0; i < numAtts; i++) {
+		size_t needed = getNeeded ((MyDB_ValueType) miniPages[i].type, att);
+		fits = fits && (miniPages[i].used + needed <= miniPages[i].capacity);
+		totalNeeded += needed;
+		att += *((short *) att);
+	}
+	if (!fits && !repackPaxPage (page, pageSize, serializedRec))
+		return false;
+
+	// and write each of the values
+	att = ((char *) serializedRec) + sizeof (short);
+	for (size_t i = 0; i < numAtts; i++) {
+		MyDB_MiniPage &mini = miniPages[i];
+		char *start = ((char *) page) + mini.start;
+		char *data = att + sizeof (short);
+		size_t len = *((short *) att) - sizeof (short);
+		if (mini.type == (uint32_t) MyDB_ValueType :: StringVal) {
+			uint32_t *ends = (uint32_t *) start;
+			uint32_t end = ((numRecs == 0) ? 0 : ends[numRecs - 1]) + len;
+			ends[numRecs] = end;
+			memcpy (start + mini.capacity - end, data, len);
+			mini.used += sizeof (uint32_t) + len;
+		} else {
+			memcpy (start + mini.used, data, len);
+			mini.used += len;
+		}
+		att += *((short *) att);
+	}
+
+	getPaxNumRecs (page)++;
+	getPageBytesUsed (page) += totalNeeded;
+	return true;
+}
+
+void getPaxRecord (void *page, size_t whichRec, vector <char> &intoMe) {
+
+	size_t numAtts = getPaxNumAtts (page);
+	MyDB_MiniPage *miniPages = getMiniPages (page);
+
+	// the record starts with its size, and each attribute starts with its own size
+	intoMe.resize (sizeof (short));
+	for (size_t i = 0; i < numAtts; i++) {
+		MyDB_MiniPage &mini = miniPages[i];
+		char *start = ((char *) page) + mini.start;
+		char *from;
+		size_t len;
+		if (mini.type == (uint32_t) MyDB_ValueType :: StringVal) {
+			uint32_t *ends = (uint32_t *) start;
+			uint32_t end = ends[whichRec];
+			len = end - ((whichRec == 0) ? 0 : ends[whichRec - 1]);
+			from = start + mini.capacity - end;
+		} else {
+			len = getWidth ((MyDB_ValueType) mini.type);
+			from = start + whichRec * len;
+		}
+		size_t pos = intoMe.size ();
+		intoMe.resize (pos + sizeof (short) + len);
+		*((short *) (intoMe.data () + pos)) = (short) (sizeof (short) + len);
+		memcpy (intoMe.data () + pos + sizeof (short), from, len);
+	}
+	*((short *) intoMe.data ()) = (short) intoMe.size ();
+}
+
+#endif
@@ -0,0 +1,30 @@
+
+#ifndef PAX_PAGE_REC_ITER_C
+#define PAX_PAGE_REC_ITER_C
+
+#include "MyDB_PaxPage.h"
+#include "MyDB_PaxPageRecIterator.h"
+
+void MyDB_PaxPageRecIterator :: getNext () {
+	myRec->fromBinary (getCurrentPointer ());
+	curRec++;
+}
+
+void *MyDB_PaxPageRecIterator :: getCurrentPointer () {
+	getPaxRecord (myPage->getBytes (), curRec, recBytes);
+	return recBytes.data ();
+}
+
+bool MyDB_PaxPageRecIterator :: hasNext () {
+	return curRec < getPaxNumRecs (myPage->getBytes ());
+}
+
+MyDB_PaxPageRecIterator :: MyDB_PaxPageRecIterator (MyDB_PageHandle myPageIn, MyDB_RecordPtr myRecIn) {
+	curRec = 0;
+	myPage = myPageIn;
+	myRec = myRecIn;
+}
+
+MyDB_PaxPageRecIterator :: ~MyDB_PaxPageRecIterator () {}
+
+#endif
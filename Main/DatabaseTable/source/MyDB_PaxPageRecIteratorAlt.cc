@@ -0,0 +1,36 @@
+
+#ifndef PAX_PAGE_REC_ITER_ALT_C
+#define PAX_PAGE_REC_ITER_ALT_C
+
+#include "MyDB_PaxPage.h"
+#include "MyDB_PaxPageRecIteratorAlt.h"
+
+void MyDB_PaxPageRecIteratorAlt :: getCurrent (MyDB_RecordPtr intoMe) {
+	intoMe->fromBinary (recBytes.data ());
+}
+
+void *MyDB_PaxPageRecIteratorAlt :: getCurrentPointer () {
+	return recBytes.data ();
+}
+
+bool MyDB_PaxPageRecIteratorAlt :: advance () {
+	size_t numRecs = getPaxNumRecs (myPage->getBytes ());
+	if (curRec + 1 >= numRecs) {
+		curRec = numRecs;
+		return false;
+	}
+	curRec++;
+	getPaxRecord (myPage->getBytes (), curRec, recBytes);
+	return true;
+}
+
+MyDB_PaxPageRecIteratorAlt :: MyDB_PaxPageRecIteratorAlt (MyDB_PageHandle myPageIn) {
+	myPage = myPageIn;
+
+	// this wraps around to zero on the first call to advance
+	curRec = (size_t) -1;
+}
+
+MyDB_PaxPageRecIteratorAlt :: ~MyDB_PaxPageRecIteratorAlt () {}
+
+#endif
@@ -13,9 +13,13 @@
 #ifndef TABLE_RW_C
 #define TABLE_RW_C
 
+#include <cstring>
 #include <fstream>
 #include <limits>
 #include <queue>
+#include <thread>
+#include "MyDB_ColumnIterator.h"
+#include "MyDB_FilteredRecIteratorAlt.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_TableRecIterator.h"
 #include "MyDB_TableRecIteratorAlt.h"
@@ -26,6 +30,9 @@
 
 using namespace std;
 
+// the multi-threaded loadFromTextFile reads the file this many bytes at a time
+#define CHUNK_SIZE (16 * 1024 * 1024)
+
 MyDB_TableReaderWriter :: MyDB_TableReaderWriter (MyDB_TablePtr forMeIn, MyDB_BufferManagerPtr myBufferIn) {
 	forMe = forMeIn;
 	myBuffer = myBufferIn;
@@ -33,7 +40,9 @@ MyDB_TableReaderWriter :: MyDB_TableReaderWriter (MyDB_TablePtr forMeIn, MyDB_Bu
 	if (forMe->lastPage () == -1) {
 		forMe->setLastPage (0);
 		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
-		lastPage->clear ();
+		clearPage (*lastPage);
+		forMe->getZoneMap ().clear ();
+		forMe->getZoneMap ().clearPage (0);
 	} else {
 		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());	
 	}
@@ -61,14 +70,21 @@ MyDB_PageReaderWriter MyDB_TableReaderWriter :: operator [] (size_t i) {
 	while (i > forMe->lastPage ()) {
 		forMe->setLastPage (forMe->lastPage () + 1);
 		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
-		lastPage->clear ();	
+		clearPage (*lastPage);
 	}
 
+	// the caller can write to the page directly, so the zone map can't know what is on it
+	forMe->getZoneMap ().forgetPage (i);
+
 	// now get the page
 	MyDB_PageReaderWriter arrayAccessBuffer (*this, i);
 	return arrayAccessBuffer;
 }
 
+MyDB_PageReaderWriter MyDB_TableReaderWriter :: readPage (size_t i) {
+	return MyDB_PageReaderWriter (*this, i);
+}
+
 MyDB_RecordPtr MyDB_TableReaderWriter :: getEmptyRecord () {
 
 	// use the schema to produce an empty record
@@ -81,84 +97,412 @@ MyDB_PageReaderWriter MyDB_TableReaderWriter :: last () {
 }
 
 void MyDB_TableReaderWriter :: append (MyDB_RecordPtr appendMe) {
+	void *loc = reserveBytes (appendMe->getBinarySize ());
+	appendMe->toBinary (loc);
+	finishAppend (loc);
+	updateStats (appendMe);
+}
 
-	// try to append the record on the current page...
-	if (!lastPage->append (appendMe)) {
+void *MyDB_TableReaderWriter :: appendBytes (size_t numBytes) {
 
-		// if we cannot, then get a new last page and append
-		forMe->setLastPage (forMe->lastPage () + 1);
-		lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
-		lastPage->clear ();
-		lastPage->append (appendMe);
+	// the caller writes the record after we return, which is too late to split it up
+	if (isPax ()) {
+		cout << "Can't reserve bytes for a record in a PAX table.\n";
+		exit (1);
 	}
+
+	// we won't see what is written here, so the zone map no longer knows about the page
+	void *loc = reserveBytes (numBytes);
+	forMe->getZoneMap ().forgetPage (forMe->lastPage ());
+	return loc;
 }
 
-pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (string fName) {
+void *MyDB_TableReaderWriter :: reserveBytes (size_t numBytes) {
 
-	// empty out the database file
+	// a record for a PAX table is written to the side, and then split up by finishAppend
+	if (isPax ()) {
+		paxRec.resize (numBytes);
+		return paxRec.data ();
+	}
+
+	// try to put the record on the current page...
+	void *loc = lastPage->appendBytes (numBytes);
+	if (loc == nullptr) {
+
+		// if we cannot, then get a new last page; if it does not fit there either, it never will
+		addLastPage ();
+		loc = lastPage->appendBytes (numBytes);
+		if (loc == nullptr) {
+			cout << "Can't append a record of " << numBytes << " bytes; it does not fit on a page.\n";
+			exit (1);
+		}
+	}
+	return loc;
+}
+
+void MyDB_TableReaderWriter :: finishAppend (void *loc) {
+	if (isPax () && !lastPage->appendBinary (loc)) {
+		addLastPage ();
+		if (!lastPage->appendBinary (loc)) {
+			cout << "Can't append a record of " << *((short *) loc) << " bytes; it does not fit on a page.\n";
+			exit (1);
+		}
+	}
+	forMe->getZoneMap ().add (forMe->lastPage (), loc);
+}
+
+void MyDB_TableReaderWriter :: addLastPage () {
+	forMe->setLastPage (forMe->lastPage () + 1);
+	lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
+	clearPage (*lastPage);
+	forMe->getZoneMap ().clearPage (forMe->lastPage ());
+}
+
+void MyDB_TableReaderWriter :: clearPage (MyDB_PageReaderWriter &clearMe) {
+	if (isPax ())
+		clearMe.clearPax (forMe->getSchema ());
+	else
+		clearMe.clear ();
+}
+
+void MyDB_TableReaderWriter :: clear () {
 	forMe->setLastPage (0);
 	lastPage = make_shared <MyDB_PageReaderWriter> (*this, forMe->lastPage ());
-	lastPage->clear ();
+	clearPage (*lastPage);
+	clearStats ();
+	forMe->getZoneMap ().clear ();
+	forMe->getZoneMap ().clearPage (0);
+}
+
+bool MyDB_TableReaderWriter :: isPax () {
+	return forMe->getFileType () == "pax";
+}
+
+// the part of a chunk of text that is parsed by one worker thread
+struct MyDB_LoadSlice {
+
+	// the lines to parse
+	const char *begin;
+	const char *end;
+
+	// the serialized records, packed back to back, and how many there are
+	vector <char> recs;
+	size_t numRecs;
+
+	// the distinct value sketches and other statistics for the records in the slice
+	vector <MyDB_HyperLogLog> sketches;
+	vector <MyDB_AttStatsBuilder> stats;
+};
+
+// gets an empty statistics builder for each of the attributes in the record
+static vector <MyDB_AttStatsBuilder> getStatsBuilders (MyDB_RecordPtr forMe) {
+	vector <MyDB_AttStatsBuilder> returnVal;
+	for (auto &att : forMe->getSchema ()->getAtts ()) {
+		MyDB_DictionaryPtr dictionary = att.second->getDictionary ();
+		bool isNumeric = (dictionary != nullptr) ? dictionary->isNumeric () : att.second->toString () != "string";
+		returnVal.push_back (MyDB_AttStatsBuilder (isNumeric));
+	}
+	return returnVal;
+}
+
+// fills the dictionaries for the dictionary-encoded attributes with all of the values in the given
+// text file, before it is loaded.  Since the values all go in at once, the codes are given out in
+// sorted order, and since all of the values are there, the loader never changes the dictionaries
+// (so the workers in the parallel loader can share them)
+static void buildDictionaries (MyDB_SchemaPtr mySchema, string fName) {
+
+	vector <pair <size_t, MyDB_DictionaryPtr>> dictionaries;
+	for (size_t i = 0; i < mySchema->getAtts ().size (); i++) {
+		MyDB_DictionaryPtr dictionary = mySchema->getAtts ()[i].second->getDictionary ();
+		if (dictionary != nullptr)
+			dictionaries.push_back (make_pair (i, dictionary));
+	}
+	if (dictionaries.empty ())
+		return;
+
+	// collect the distinct values of each attribute
+	vector <set <string>> values (dictionaries.size ());
+	ifstream myfile (fName);
+	string line;
+	while (getline (myfile, line)) {
+		size_t whichAtt = 0, pos = 0, next = 0;
+		for (size_t i = 0; i < dictionaries.size () && pos <= line.size (); whichAtt++, pos = next + 1) {
+			next = line.find ('|', pos);
+			if (next == string :: npos)
+				next = line.size ();
+			if (whichAtt == dictionaries[i].first)
+				values[i++].insert (line.substr (pos, next - pos));
+		}
+	}
+
+	for (size_t i = 0; i < dictionaries.size (); i++) {
+		vector <string> toAdd (values[i].begin (), values[i].end ());
+		dictionaries[i].second->clear ();
+		dictionaries[i].second->addValues (toAdd);
+	}
+}
+
+// a chunk of the text file, and the slices it is split into
+struct MyDB_LoadChunk {
+	vector <char> text;
+	vector <MyDB_LoadSlice> slices;
+};
+
+// parses all of the lines in the slice using the given record
+static void parseSlice (MyDB_LoadSlice &slice, MyDB_RecordPtr tempRec) {
+
+	size_t numAtts = tempRec->getSchema ()->getAtts ().size ();
+	slice.recs.clear ();
+	slice.numRecs = 0;
+	slice.sketches.resize (numAtts);
+	for (auto &s : slice.sketches)
+		s.clear ();
+	slice.stats = getStatsBuilders (tempRec);
+
+	for (const char *pos = slice.begin; pos < slice.end; ) {
+
+		// find the end of the line
+		const char *lineEnd = (const char *) memchr (pos, '\n', slice.end - pos);
+		if (lineEnd == nullptr)
+			lineEnd = slice.end;
+		const char *lineStart = pos;
+		pos = lineEnd + 1;
+		if (lineEnd == lineStart)
+			continue;
+
+		// the text is parsed right out of the chunk
+		tempRec->fromText (lineStart, lineEnd);
+		for (size_t i = 0; i < numAtts; i++) {
+			slice.sketches[i].add (tempRec->getAtt (i)->hash ());
+			slice.stats[i].add (tempRec->getDecodedValue (i));
+		}
+
+		size_t oldSize = slice.recs.size ();
+		slice.recs.resize (oldSize + tempRec->getBinarySize ());
+		tempRec->toBinary (slice.recs.data () + oldSize);
+		slice.numRecs++;
+	}
+}
+
+// reads the next chunk of the file into intoMe; the partial line at the end of the chunk (if any)
+// is carried over in leftover, to be put at the start of the next chunk.  Returns false if there is
+// no more text.  The chunk's text is split into numSlices slices, at line boundaries
+static bool readChunk (ifstream &myfile, string &leftover, MyDB_LoadChunk &intoMe, size_t numSlices) {
+
+	intoMe.text.resize (leftover.size () + CHUNK_SIZE);
+	memcpy (intoMe.text.data (), leftover.data (), leftover.size ());
+	myfile.read (intoMe.text.data () + leftover.size (), CHUNK_SIZE);
+	size_t len = leftover.size () + myfile.gcount ();
+	if (len == 0)
+		return false;
+
+	// if we are not at the end of the file, then the chunk stops at the last newline
+	size_t chunkLen = len;
+	if (myfile) {
+		while (chunkLen > 0 && intoMe.text[chunkLen - 1] != '\n')
+			chunkLen--;
+	}
+	leftover.assign (intoMe.text.data () + chunkLen, len - chunkLen);
+
+	// and cut the chunk into slices
+	intoMe.slices.resize (numSlices);
+	const char *start = intoMe.text.data (), *chunkEnd = intoMe.text.data () + chunkLen;
+	for (size_t i = 0; i < numSlices; i++) {
+		const char *sliceEnd = start + (chunkEnd - start) / (numSlices - i);
+		if (i == numSlices - 1) {
+			sliceEnd = chunkEnd;
+		} else if (sliceEnd < chunkEnd) {
+			sliceEnd = (const char *) memchr (sliceEnd, '\n', chunkEnd - sliceEnd);
+			sliceEnd = (sliceEnd == nullptr) ? chunkEnd : sliceEnd + 1;
+		}
+		intoMe.slices[i].begin = start;
+		intoMe.slices[i].end = sliceEnd;
+		start = sliceEnd;
+	}
+	return true;
+}
+
+pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (string fName, int numThreads) {
+
+	// empty out the database file, and put the records on its pages as they come
+	clear ();
+	size_t counter = parseTextFile (fName, numThreads, [this] (void *rec) {
+		void *loc = reserveBytes (*((short *) rec));
+		memcpy (loc, rec, *((short *) rec));
+		finishAppend (loc);
+	});
+	forMe->setTupleCount (counter);
+	return make_pair (getDistinctValueEstimates (), counter);
+}
+
+size_t MyDB_TableReaderWriter :: parseTextFile (string fName, int numThreads, function <void (void *)> appendMe) {
+
+	if (numThreads <= 0)
+		numThreads = thread :: hardware_concurrency ();
+	if (numThreads <= 0)
+		numThreads = 1;
+	buildDictionaries (forMe->getSchema (), fName);
+
+	// each worker gets its own record to parse into
+	vector <MyDB_RecordPtr> tempRecs;
+	for (int i = 0; i < numThreads; i++)
+		tempRecs.push_back (getEmptyRecord ());
+	vector <MyDB_AttStatsBuilder> stats = getStatsBuilders (tempRecs[0]);
+
+	// we use two chunks: while the workers parse one, the last one is packed into pages and
+	// the next one is read
+	MyDB_LoadChunk chunks[2];
+	string leftover;
+	size_t counter = 0;
+	ifstream myfile (fName, ios :: binary);
+	if (myfile.is_open ()) {
+
+		bool moreText = readChunk (myfile, leftover, chunks[0], numThreads);
+		bool haveParsed = false;
+		int cur = 0;
+		while (moreText || haveParsed) {
+
+			// start the workers on the current chunk
+			vector <thread> workers;
+			if (moreText) {
+				for (int i = 0; i < numThreads; i++)
+					workers.push_back (thread (parseSlice, ref (chunks[cur].slices[i]), tempRecs[i]));
+			}
+
+			// hand over the records that were parsed last time around, in order, and fold
+			// their sketches into the table's
+			if (haveParsed) {
+				vector <MyDB_HyperLogLog> &sketches = forMe->changeSketches ();
+				for (MyDB_LoadSlice &slice : chunks[1 - cur].slices) {
+					for (size_t i = 0; i < slice.sketches.size (); i++) {
+						sketches[i].merge (slice.sketches[i]);
+						stats[i].merge (slice.stats[i]);
+					}
+					for (size_t pos = 0; pos < slice.recs.size (); ) {
+						short recSize = *((short *) (slice.recs.data () + pos));
+						appendMe (slice.recs.data () + pos);
+						pos += recSize;
+					}
+					counter += slice.numRecs;
+				}
+			}
+
+			// read the next chunk while the workers are busy
+			bool nextText = false;
+			if (moreText)
+				nextText = readChunk (myfile, leftover, chunks[1 - cur], numThreads);
+
+			for (thread &t : workers)
+				t.join ();
+
+			haveParsed = moreText;
+			moreText = nextText;
+			cur = 1 - cur;
+		}
+		myfile.close ();
+	}
+	cout << "Loaded " << counter << " records.\n";
+	setAttStats (stats);
+	return counter;
+}
+
+pair <vector <size_t>, size_t>  MyDB_TableReaderWriter :: loadFromTextFile (string fName) {
+
+	// empty out the database file
+	clear ();
+	buildDictionaries (forMe->getSchema (), fName);
 
 	// try to open the file
 	string line;
 	ifstream myfile (fName);
 
 	MyDB_RecordPtr tempRec = getEmptyRecord ();
+	vector <MyDB_AttStatsBuilder> stats = getStatsBuilders (tempRec);
 
-	// this data structure is used for apporoximate counting of the number of distinct
-	// values of each attribute
-	vector <pair <set <size_t>, int>> allHashes;
-	for (int i = 0; i < tempRec->getSchema ()->getAtts ().size (); i++) {
-		set <size_t> temp1;
-		allHashes.push_back (make_pair (temp1, 1));
-	}
-
-	// if we opened it, read the contents
+	// if we opened it, read the contents; append keeps the count and sketches up to date
 	size_t counter = 0;
 	if (myfile.is_open()) {
 
 		// loop through all of the lines
 		while (getline (myfile,line)) {
-			tempRec->fromString (line);		
+			tempRec->fromText (line.data (), line.data () + line.size ());
 			counter++;
-			// hash all of the attributes... this is used for counting
-			int i = 0;
-			for (auto &a : allHashes) {
-
-				// insert the hash
-				size_t hash = tempRec->getAtt (i)->hash ();
-				i++;
-				if (hash % a.second != 0)
-					continue;
-
-				a.first.insert (hash);
-
-				// if we have too many items, compact them
-				#define MAX_SIZE 1000
-				if (a.first.size () > MAX_SIZE) {
-					a.second *= 2;
-					set <size_t> newSet;
-					for (auto &num : a.first) {
-						if (num % a.second == 0)
-							newSet.insert (num);
-					}
-					a.first = newSet;	
-				}
-			}
+			for (size_t i = 0; i < stats.size (); i++)
+				stats[i].add (tempRec->getDecodedValue (i));
 			append (tempRec);
 		}
 		myfile.close ();
 	}
 	cout << "Loaded " << counter << " records.\n";
+	setAttStats (stats);
 
-	// finally, compute the vector of estimates
-	vector <size_t> returnVal;
-	for (auto &a : allHashes) {
-		size_t est = ((size_t) a.first.size ()) * a.second;
-		returnVal.push_back (est);
+	return make_pair (getDistinctValueEstimates (), counter);
+}
+
+void MyDB_TableReaderWriter :: updateStats (MyDB_RecordPtr appendMe) {
+	vector <MyDB_HyperLogLog> &sketches = forMe->changeSketches ();
+	for (size_t i = 0; i < sketches.size (); i++)
+		sketches[i].add (appendMe->getAtt (i)->hash ());
+	forMe->setTupleCount (forMe->getTupleCount () + 1);
+}
+
+void MyDB_TableReaderWriter :: updateStats (size_t *hashes) {
+	vector <MyDB_HyperLogLog> &sketches = forMe->changeSketches ();
+	for (size_t i = 0; i < sketches.size (); i++)
+		sketches[i].add (hashes[i]);
+	forMe->setTupleCount (forMe->getTupleCount () + 1);
+}
+
+void MyDB_TableReaderWriter :: setAttStats (vector <MyDB_AttStatsBuilder> &fromMe) {
+	vector <MyDB_AttStats> stats;
+	for (auto &b : fromMe)
+		stats.push_back (b.build ());
+	forMe->setAttStats (stats);
+}
+
+void MyDB_TableReaderWriter :: analyze () {
+
+	clearStats ();
+	MyDB_RecordPtr tempRec = getEmptyRecord ();
+	vector <MyDB_AttStatsBuilder> stats = getStatsBuilders (tempRec);
+	vector <MyDB_HyperLogLog> &sketches = forMe->changeSketches ();
+	MyDB_ZoneMap &zones = forMe->getZoneMap ();
+	zones.clear ();
+	size_t counter = 0;
+
+	// scan the whole table; only the leaf pages of a B+-Tree hold records
+	for (int i = 0; i < getNumPages (); i++) {
+		MyDB_PageReaderWriter page = readPage (i);
+		if (page.getType () == MyDB_PageType :: DirectoryPage)
+			continue;
+		zones.clearPage (i);
+		MyDB_RecordIteratorAltPtr myIter = page.getIteratorAlt ();
+		while (myIter->advance ()) {
+			myIter->getCurrent (tempRec);
+			zones.add (i, myIter->getCurrentPointer ());
+			for (size_t j = 0; j < stats.size (); j++) {
+				sketches[j].add (tempRec->getAtt (j)->hash ());
+				stats[j].add (tempRec->getDecodedValue (j));
+			}
+			counter++;
+		}
 	}
-	return make_pair (returnVal, counter);
+
+	forMe->setTupleCount (counter);
+	setAttStats (stats);
+}
+
+void MyDB_TableReaderWriter :: clearStats () {
+	for (auto &s : forMe->changeSketches ())
+		s.clear ();
+	forMe->setTupleCount (0);
+}
+
+vector <size_t> MyDB_TableReaderWriter :: getDistinctValueEstimates () {
+	vector <size_t> returnVal;
+	for (const MyDB_HyperLogLog &s : forMe->getSketches ())
+		returnVal.push_back (s.estimate ());
+	return returnVal;
 }
 
 MyDB_RecordIteratorPtr MyDB_TableReaderWriter :: getIterator (MyDB_RecordPtr iterateIntoMe) {
@@ -173,6 +517,62 @@ MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (int lowPage,
 	return make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, lowPage, highPage);
 }
 
+MyDB_RecordIteratorAltPtr MyDB_TableReaderWriter :: getIteratorAlt (string pred) {
+	MyDB_RecordIteratorAltPtr allRecs = make_shared <MyDB_TableRecIteratorAlt> (*this, forMe, getPageFilter (pred));
+	return make_shared <MyDB_FilteredRecIteratorAlt> (allRecs, getEmptyRecord (), pred);
+}
+
+MyDB_ColumnIteratorPtr MyDB_TableReaderWriter :: getColumnIterator (vector <string> atts) {
+	return make_shared <MyDB_ColumnIterator> (*this, atts);
+}
+
+function <bool (int)> MyDB_TableReaderWriter :: getPageFilter (string pred) {
+
+	// each of the simple comparisons that is and-ed into the predicate can be checked against the zone map
+	MyDB_TablePtr table = forMe;
+	vector <function <bool (int)>> checks;
+	for (MyDB_SimpleComparison &comp : getEmptyRecord ()->getSimpleConjuncts (pred)) {
+		int whichAtt = comp.whichAtt;
+		bool ifLess = comp.ifLess, ifEqual = comp.ifEqual, ifGreater = comp.ifGreater;
+		if (comp.attType == "string" && comp.constType == "string") {
+			string val = comp.constVal;
+			checks.push_back ([=] (int whichPage) {
+				return table->getZoneMap ().mightMatch (whichPage, whichAtt, ifLess, ifEqual, ifGreater, val);
+			});
+		} else if ((comp.attType == "int" || comp.attType == "double") && comp.constType != "string") {
+			double val = stod (comp.constVal);
+			checks.push_back ([=] (int whichPage) {
+				return table->getZoneMap ().mightMatch (whichPage, whichAtt, ifLess, ifEqual, ifGreater, val);
+			});
+
+		// the zone map has the smallest and largest codes, so the constant is turned into a code
+		} else if (comp.attType == "dict") {
+			MyDB_DictionaryPtr dictionary = forMe->getSchema ()->getAtts ()[whichAtt].second->getDictionary ();
+			if (dictionary->isNumeric () == (comp.constType == "string"))
+				continue;
+			MyDB_Value val = dictionary->isNumeric () ? MyDB_Value :: fromDouble (stod (comp.constVal)) :
+				MyDB_Value :: fromString (comp.constVal.c_str (), comp.constVal.size ());
+			int code;
+			if (!dictionary->translateComparison (val, ifLess, ifEqual, ifGreater, code))
+				continue;
+			checks.push_back ([=] (int whichPage) {
+				return table->getZoneMap ().mightMatch (whichPage, whichAtt, ifLess, ifEqual, ifGreater, (double) code);
+			});
+		}
+	}
+
+	// a page is read if it might have a record that passes all of the checks
+	return [table, checks] (int whichPage) {
+		if (table->getZoneMap ().isEmpty (whichPage))
+			return false;
+		for (auto &check : checks) {
+			if (!check (whichPage))
+				return false;
+		}
+		return true;
+	};
+}
+
 void MyDB_TableReaderWriter :: writeIntoTextFile (string fName) {
 	
 	// open up the output file
@@ -25,14 +25,14 @@ void *MyDB_TableRecIterator :: getCurrentPointer () {
 }
 
 bool MyDB_TableRecIterator :: hasNext () {
-	if (myParent[curPage].getType () == MyDB_PageType :: RegularPage && myIter->hasNext ())
+	if (myParent.readPage (curPage).getType () != MyDB_PageType :: DirectoryPage && myIter->hasNext ())
 		return true;
 
 	if (curPage == myTable->lastPage ())
 		return false;
 
 	curPage++;
-	myIter = myParent[curPage].getIterator (myRec);
+	myIter = myParent.readPage (curPage).getIterator (myRec);
 	return hasNext ();
 }
 
@@ -41,7 +41,7 @@ MyDB_TableRecIterator :: MyDB_TableRecIterator (MyDB_TableReaderWriter &myParent
 	myTable = myTableIn;
 	myRec = myRecIn;
 	curPage = 0;
-	myIter = myParent[curPage].getIterator (myRec);		
+	myIter = myParent.readPage (curPage).getIterator (myRec);		
 }
 
 MyDB_TableRecIterator :: ~MyDB_TableRecIterator () {}
@@ -26,15 +26,25 @@ void *MyDB_TableRecIteratorAlt :: getCurrentPointer () {
 
 bool MyDB_TableRecIteratorAlt :: advance () {
 
-	if (myParent[curPage].getType () == MyDB_PageType :: RegularPage && myIter->advance ())
-		return true;
+	while (true) {
+		if (myIter != nullptr && myParent.readPage (curPage).getType () != MyDB_PageType :: DirectoryPage && myIter->advance ())
+			return true;
 
-	if (curPage == myTable->lastPage () || curPage == highPage)
-		return false;
+		if (curPage == myTable->lastPage () || curPage == highPage)
+			return false;
 
-	curPage++;
-	myIter = myParent[curPage].getIteratorAlt ();
-	return advance ();
+		curPage++;
+		startPage ();
+	}
+}
+
+void MyDB_TableRecIteratorAlt :: startPage () {
+
+	// a page that is filtered out is never even brought into the buffer
+	if (pageFilter != nullptr && !pageFilter (curPage))
+		myIter = nullptr;
+	else
+		myIter = myParent.readPage (curPage).getIteratorAlt ();
 }
 
 MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
@@ -43,7 +53,7 @@ MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &my
 	myTable = myTableIn;
 	curPage = lowPage;
 	highPage = highPageIn;
-	myIter = myParent[curPage].getIteratorAlt ();		
+	startPage ();
 }
 
 MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn) :
@@ -51,7 +61,17 @@ MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &my
 	myTable = myTableIn;
 	curPage = 0;
 	highPage = 1999999999;
-	myIter = myParent[curPage].getIteratorAlt ();		
+	startPage ();
+}
+
+MyDB_TableRecIteratorAlt :: MyDB_TableRecIteratorAlt (MyDB_TableReaderWriter &myParent, MyDB_TablePtr myTableIn,
+	function <bool (int)> pageFilterIn) :
+	myParent (myParent) {
+	myTable = myTableIn;
+	curPage = 0;
+	highPage = 1999999999;
+	pageFilter = pageFilterIn;
+	startPage ();
 }
 
 MyDB_TableRecIteratorAlt :: ~MyDB_TableRecIteratorAlt () {}
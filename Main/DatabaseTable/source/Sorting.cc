@@ -8,6 +8,7 @@
 #include "MyDB_TableRecIteratorAlt.h"
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_RunQueueIteratorAlt.h"
+#include "MyDB_KeyedRunQueueIteratorAlt.h"
 #include "IteratorComparator.h"
 #include "Sorting.h"
 
@@ -105,74 +106,37 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 	return buildItertorOverSortedRuns (runSize, sortMe, comparator, lhs, rhs, "bool[true]");
 }
 
-MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe, 
-	function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs, string lhsPred) {
-
-	bool skipPred = false;
-	if (lhsPred == "bool[true]")
-		skipPred = true;
+// a list of pages holding sorted records
+typedef vector <MyDB_PageReaderWriter> MyDB_Run;
 
-	func f = lhs->compileComputation (lhsPred);
-
-	// this is the list of all of the pages in the file
-	vector <vector<MyDB_PageReaderWriter>> allPages;
+// this is the part of the TPMMS that is the same for both kinds of comparisons.  It goes through the
+// pages of sortMe, and every runSize pages, merges them into a single sorted run; an iterator over each
+// of the runs is returned.  getRuns is called for each page (with its number), and adds the sorted runs
+// that come from it (it may add none, or more than one); mergeRuns merges two runs, the first of which
+// came earlier in the file
+static vector <MyDB_RecordIteratorAltPtr> buildSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe,
+	function <void (int, vector <MyDB_Run> &)> getRuns, function <MyDB_Run (MyDB_Run &, MyDB_Run &)> mergeRuns) {
 
 	// this is the pages making up the current run
-	vector <vector<MyDB_PageReaderWriter>> pagesToSort;
+	vector <MyDB_Run> pagesToSort;
 
 	// this is the list of all of the iterators, with one for each run
 	vector <MyDB_RecordIteratorAltPtr> runIters;
 	
 	// process the file 
-	MyDB_PageReaderWriter tempPage (true, *sortMe.getBufferMgr ());
 	for (int i = 0; i < sortMe.getNumPages (); i++) {
-		
-		if (sortMe[i].getType () == MyDB_PageType :: RegularPage) {
-
-			if (skipPred) {
-				vector <MyDB_PageReaderWriter> run;
-				run.push_back (*(sortMe[i].sort (comparator, lhs, rhs)));	
-				pagesToSort.push_back (run);
-			} else {
-				MyDB_RecordIteratorAltPtr temp = sortMe[i].getIteratorAlt ();
-				while (temp->advance ()) {
-					temp->getCurrent (lhs);
-
-					if (!f ()->toBool ())
-						continue;
 
-					if (!tempPage.append (lhs)) {
-	
-						// remember the old page
-						vector <MyDB_PageReaderWriter> run;
-						run.push_back (*(tempPage.sort (comparator, lhs, rhs)));
-						pagesToSort.push_back (run);
-	
-						// get the new page
-						tempPage = MyDB_PageReaderWriter (true, *sortMe.getBufferMgr ());	
-						temp->getCurrent (lhs);
-						tempPage.append (lhs);
-					}
-				}
-			}
-		}
-
-		// if we are all done, remember the last page
-		if (i == sortMe.getNumPages () - 1) {
-			vector <MyDB_PageReaderWriter> run;
-			run.push_back (*(tempPage.sort (comparator, lhs, rhs)));
-			pagesToSort.push_back (run);
-		}
+		getRuns (i, pagesToSort);
 
 		// if we are not done reading this run, go on to the next one
-		if (pagesToSort.size () != runSize && i != sortMe.getNumPages () - 1)
+		if (pagesToSort.size () < (size_t) runSize && i != sortMe.getNumPages () - 1)
 			continue;
 
 		// while we don't have a single sorted list
 		while (pagesToSort.size () > 1) {
 			
 			// the new version of the pages to sort vector
-			vector <vector<MyDB_PageReaderWriter>> newPagesToSort;
+			vector <MyDB_Run> newPagesToSort;
 	
 			// repeatedly merge the last two pages
 			while (pagesToSort.size () > 0) {
@@ -185,26 +149,84 @@ MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableRea
 				}
 	
 				// get the next two runs
-				vector<MyDB_PageReaderWriter> runOne = pagesToSort.back ();
+				MyDB_Run runOne = pagesToSort.back ();
 				pagesToSort.pop_back ();
-				vector<MyDB_PageReaderWriter> runTwo = pagesToSort.back ();
+				MyDB_Run runTwo = pagesToSort.back ();
 				pagesToSort.pop_back ();
 		
-				// merge them
-				newPagesToSort.push_back (mergeIntoList (sortMe.getBufferMgr (), getIteratorAlt (runOne), 
-					getIteratorAlt (runTwo), comparator, lhs, rhs));
+				// merge them; runTwo came first in the file
+				newPagesToSort.push_back (mergeRuns (runTwo, runOne));
 			}
 	
 			pagesToSort = newPagesToSort;
 		}
 
-		
 		// now we have a single list, so create an iterator for it
-		runIters.push_back (getIteratorAlt (pagesToSort[0]));
+		if (pagesToSort.size () == 1)
+			runIters.push_back (getIteratorAlt (pagesToSort[0]));
 
 		// and start over on the next run
 		pagesToSort.clear ();
 	}
+
+	return runIters;
+}
+
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe, 
+	function <bool ()> comparator, MyDB_RecordPtr lhs, MyDB_RecordPtr rhs, string lhsPred) {
+
+	bool skipPred = false;
+	if (lhsPred == "bool[true]")
+		skipPred = true;
+
+	// if the predicate is simple enough, we test it over the page bytes, and only deserialize
+	// the records that pass
+	binaryPred fastPred = nullptr;
+	function <bool ()> f;
+	if (!skipPred)
+		fastPred = lhs->compileBinaryPredicate (lhsPred);
+	if (fastPred == nullptr && !skipPred)
+		f = lhs->compilePredicate (lhsPred);
+
+	// a page with no predicate to run is sorted as is; otherwise (or if it is a PAX page, which can't be
+	// sorted), the records that we want are copied onto anonymous pages, which are sorted when they fill up
+	MyDB_PageReaderWriter tempPage (true, *sortMe.getBufferMgr ());
+	auto getRuns = [&] (int i, vector <MyDB_Run> &pagesToSort) {
+		MyDB_PageReaderWriter page = sortMe.readPage (i);
+		if (skipPred && page.getType () == MyDB_PageType :: RegularPage) {
+			pagesToSort.push_back (MyDB_Run {*(page.sort (comparator, lhs, rhs))});
+		} else if (page.getType () == MyDB_PageType :: RegularPage || page.getType () == MyDB_PageType :: PaxPage) {
+			MyDB_RecordIteratorAltPtr temp = page.getIteratorAlt ();
+			while (temp->advance ()) {
+				if (fastPred != nullptr && !fastPred (temp->getCurrentPointer ()))
+					continue;
+				temp->getCurrent (lhs);
+				if (f != nullptr && !f ())
+					continue;
+
+				if (!tempPage.append (lhs)) {
+
+					// remember the old page
+					pagesToSort.push_back (MyDB_Run {*(tempPage.sort (comparator, lhs, rhs))});
+
+					// get the new page
+					tempPage = MyDB_PageReaderWriter (true, *sortMe.getBufferMgr ());	
+					temp->getCurrent (lhs);
+					tempPage.append (lhs);
+				}
+			}
+		}
+
+		// if we are all done, remember the last page
+		if (i == sortMe.getNumPages () - 1)
+			pagesToSort.push_back (MyDB_Run {*(tempPage.sort (comparator, lhs, rhs))});
+	};
+
+	// the later run goes on the left, since the right one wins ties
+	auto mergeRuns = [&] (MyDB_Run &first, MyDB_Run &second) {
+		return mergeIntoList (sortMe.getBufferMgr (), getIteratorAlt (second), getIteratorAlt (first), comparator, lhs, rhs);
+	};
+	vector <MyDB_RecordIteratorAltPtr> runIters = buildSortedRuns (runSize, sortMe, getRuns, mergeRuns);
 	
 	// and now, we are ready to merge everything
 	MyDB_RunQueueIteratorAltPtr temp = make_shared <MyDB_RunQueueIteratorAlt> (comparator, lhs, rhs);
@@ -233,5 +255,107 @@ void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &
 	}
 }
 
+// copies the current record of fromMe onto the end of curPage, without deserializing it
+static void appendRecordBytes (MyDB_PageReaderWriter &curPage, vector <MyDB_PageReaderWriter> &returnVal, 
+	MyDB_RecordIteratorAltPtr fromMe, MyDB_BufferManagerPtr parent) {
+
+	short recSize = *((short *) fromMe->getCurrentPointer ());
+	void *loc = curPage.appendBytes (recSize);
+	if (loc == nullptr) {
+		returnVal.push_back (curPage);
+		MyDB_PageReaderWriter temp (*parent);
+		loc = temp.appendBytes (recSize);
+		curPage = temp;
+	}
+
+	// getting a new page can evict the one we are reading from, so get the record's location again
+	memcpy (loc, fromMe->getCurrentPointer (), recSize);
+}
+
+vector <MyDB_PageReaderWriter> mergeIntoList (MyDB_BufferManagerPtr parent, MyDB_RecordIteratorAltPtr leftIter, 
+	MyDB_RecordIteratorAltPtr rightIter, MyDB_SortKeyPtr sortKey) {
+	
+	vector <MyDB_PageReaderWriter> returnVal;
+	MyDB_PageReaderWriter curPage (*parent);
+
+	// the key of the current record in each of the runs
+	string lhsKey, rhsKey;
+	bool lhsValid = leftIter->advance (), rhsValid = rightIter->advance ();
+	if (lhsValid)
+		sortKey->encode (leftIter->getCurrentPointer (), lhsKey);
+	if (rhsValid)
+		sortKey->encode (rightIter->getCurrentPointer (), rhsKey);
+
+	while (lhsValid || rhsValid) {
+		if (lhsValid && (!rhsValid || MyDB_SortKey :: compare (lhsKey.data (), lhsKey.size (), 
+			rhsKey.data (), rhsKey.size ()) <= 0)) {
+			appendRecordBytes (curPage, returnVal, leftIter, parent);
+			lhsValid = leftIter->advance ();
+			if (lhsValid)
+				sortKey->encode (leftIter->getCurrentPointer (), lhsKey);
+		} else {
+			appendRecordBytes (curPage, returnVal, rightIter, parent);
+			rhsValid = rightIter->advance ();
+			if (rhsValid)
+				sortKey->encode (rightIter->getCurrentPointer (), rhsKey);
+		}
+	}
+	
+	// remember the current page
+	returnVal.push_back (curPage);
+	return returnVal;
+}
+
+MyDB_RecordIteratorAltPtr buildItertorOverSortedRuns (int runSize, MyDB_TableReaderWriter &sortMe, 
+	MyDB_SortKeyPtr sortKey) {
+
+	// a PAX page can't be sorted, so its records are copied onto anonymous pages, which are sorted
+	// when they fill up
+	MyDB_PageReaderWriter tempPage (true, *sortMe.getBufferMgr ());
+	auto getRuns = [&] (int i, vector <MyDB_Run> &pagesToSort) {
+		MyDB_PageReaderWriter page = sortMe.readPage (i);
+		if (page.getType () == MyDB_PageType :: RegularPage) {
+			pagesToSort.push_back (MyDB_Run {*(page.sort (sortKey))});
+		} else if (page.getType () == MyDB_PageType :: PaxPage) {
+			MyDB_RecordIteratorAltPtr temp = page.getIteratorAlt ();
+			while (temp->advance ()) {
+				if (!tempPage.appendBinary (temp->getCurrentPointer ())) {
+					pagesToSort.push_back (MyDB_Run {*(tempPage.sort (sortKey))});
+					tempPage = MyDB_PageReaderWriter (true, *sortMe.getBufferMgr ());	
+					tempPage.appendBinary (temp->getCurrentPointer ());
+				}
+			}
+		}
+
+		if (i == sortMe.getNumPages () - 1 && tempPage.getNumRecords () > 0)
+			pagesToSort.push_back (MyDB_Run {*(tempPage.sort (sortKey))});
+	};
+
+	// the earlier run goes on the left, which wins ties
+	auto mergeRuns = [&] (MyDB_Run &first, MyDB_Run &second) {
+		return mergeIntoList (sortMe.getBufferMgr (), getIteratorAlt (first), getIteratorAlt (second), sortKey);
+	};
+	vector <MyDB_RecordIteratorAltPtr> runIters = buildSortedRuns (runSize, sortMe, getRuns, mergeRuns);
+	
+	// and now, we are ready to merge everything
+	MyDB_KeyedRunQueueIteratorAltPtr temp = make_shared <MyDB_KeyedRunQueueIteratorAlt> (sortKey);
+	for (MyDB_RecordIteratorAltPtr m : runIters) 
+		temp->addRun (m);
+
+	return temp;
+}
+
+void sort (int runSize, MyDB_TableReaderWriter &sortMe, MyDB_TableReaderWriter &sortIntoMe, MyDB_SortKeyPtr sortKey) {
+
+	// get the sorted runs
+	MyDB_RecordIteratorAltPtr myIter = buildItertorOverSortedRuns (runSize, sortMe, sortKey);
+
+	// and copy everyone out
+	while (myIter->advance ()) {
+		short recSize = *((short *) myIter->getCurrentPointer ());
+		void *loc = sortIntoMe.appendBytes (recSize);
+		memcpy (loc, myIter->getCurrentPointer (), recSize);
+	}
+}
 
 #endif
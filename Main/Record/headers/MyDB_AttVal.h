@@ -5,6 +5,8 @@
 #include <memory>
 #include <string>
 #include <cstring>
+#include "MyDB_Dictionary.h"
+#include "MyDB_Value.h"
 
 // create a smart pointer for the catalog
 using namespace std;
@@ -21,6 +23,12 @@ private:
 	// this tells us whether we are using the buffer
 	bool usingBuffer;
 
+protected:
+
+	// the kind of value stored here; set by each subclass, so that getValue () does not need
+	// to make a virtual call
+	MyDB_ValueType valueType;
+
 public:
 
 	virtual int toInt () = 0;
@@ -35,6 +43,15 @@ public:
 	virtual void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) = 0;
 	virtual ~MyDB_AttVal ();
 
+	// gets the current value of this attribute, without any virtual calls or allocation... if the
+	// attribute is a string, the result points at the attribute's own storage (see MyDB_Value.h)
+	inline MyDB_Value getValue ();
+
+	// gets the kind of value stored in this attribute
+	inline MyDB_ValueType getValueType () {
+		return valueType;
+	}
+
 	// this gets a pointer to our data... useful because we can avoid deserializing the record
 	inline void *getDataPointer () {
 		return myData;
@@ -84,6 +101,9 @@ typedef shared_ptr <MyDB_IntAttVal> MyDB_IntAttValPtr;
 
 class MyDB_IntAttVal : public MyDB_AttVal {
 
+	// lets getValue () read the value directly
+	friend class MyDB_AttVal;
+
 public:
 
 	int toInt () override;
@@ -110,6 +130,9 @@ typedef shared_ptr <MyDB_DoubleAttVal> MyDB_DoubleAttValPtr;
 
 class MyDB_DoubleAttVal : public MyDB_AttVal {
 
+	// lets getValue () read the value directly
+	friend class MyDB_AttVal;
+
 public:
 
 	int toInt () override;
@@ -136,6 +159,9 @@ typedef shared_ptr <MyDB_StringAttVal> MyDB_StringAttValPtr;
 
 class MyDB_StringAttVal : public MyDB_AttVal {
 
+	// lets getValue () read the value directly
+	friend class MyDB_AttVal;
+
 public:
 
 	int toInt () override;
@@ -162,6 +188,9 @@ typedef shared_ptr <MyDB_BoolAttVal> MyDB_BoolAttValPtr;
 
 class MyDB_BoolAttVal : public MyDB_AttVal {
 
+	// lets getValue () read the value directly
+	friend class MyDB_AttVal;
+
 public:
 
 	int toInt () override;
@@ -183,6 +212,71 @@ private:
 	bool value;
 };
 
+class MyDB_DictAttVal;
+typedef shared_ptr <MyDB_DictAttVal> MyDB_DictAttValPtr;
+
+// the value of a dictionary-encoded attribute (see MyDB_DictAttType in MyDB_AttType.h).  This is stored
+// just like an int, where the int is the value's code, and getValue () gives the code.  All of the other
+// accessors decode the value, so that toString () gives the actual value.  hash () hashes the code, so
+// it is only good for comparing with values that use the same dictionary (which is all that the
+// distinct value sketches need).  Setting the attribute to a value that is not in the dictionary adds
+// it to the dictionary
+class MyDB_DictAttVal : public MyDB_IntAttVal {
+
+public:
+
+	int toInt () override;
+	double toDouble () override;
+	string toString () override;
+	bool toBool () override;
+	void fromInt (int fromMe) override;
+	void fromString (string &fromMe) override;
+	void set (MyDB_AttValPtr toMe) override;
+	size_t hash () override;
+	MyDB_AttValPtr getCopy () override;
+	void serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) override;
+
+	// get/set the code
+	int getCode ();
+	void setCode (int toMe);
+
+	// gets the value, decoded, without allocating
+	MyDB_Value getDecodedValue ();
+
+	MyDB_DictionaryPtr getDictionary ();
+
+	MyDB_DictAttVal (MyDB_DictionaryPtr dictionary);
+	~MyDB_DictAttVal ();
+
+private:
+
+	MyDB_DictionaryPtr dictionary;
+};
+
+inline MyDB_Value MyDB_AttVal :: getValue () {
+
+	// if the value is in a record buffer, read it from there; a string's length is computed
+	// from the attribute's length prefix (which counts the prefix and the null terminator)
+	if (usingBuffer) {
+		switch (valueType) {
+			case MyDB_ValueType :: IntVal: return MyDB_Value :: fromInt (*((int *) myData));
+			case MyDB_ValueType :: DoubleVal: return MyDB_Value :: fromDouble (*((double *) myData));
+			case MyDB_ValueType :: BoolVal: return MyDB_Value :: fromBool (*((char *) myData) != 0);
+			default: return MyDB_Value :: fromString ((char *) myData, 
+				*((short *) (((char *) myData) - sizeof (short))) - sizeof (short) - 1);
+		}
+	}
 
+	// otherwise, get it from the subclass
+	switch (valueType) {
+		case MyDB_ValueType :: IntVal: return MyDB_Value :: fromInt (((MyDB_IntAttVal *) this)->value);
+		case MyDB_ValueType :: DoubleVal: return MyDB_Value :: fromDouble (((MyDB_DoubleAttVal *) this)->value);
+		case MyDB_ValueType :: BoolVal: return MyDB_Value :: fromBool (((MyDB_BoolAttVal *) this)->value);
+		default: {
+			string &value = ((MyDB_StringAttVal *) this)->value;
+			return MyDB_Value :: fromString (value.c_str (), value.size ());
+		}
+	}
+}
 
 #endif
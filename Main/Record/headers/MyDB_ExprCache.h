@@ -0,0 +1,117 @@
+
+#ifndef EXPR_CACHE_H
+#define EXPR_CACHE_H
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "MyDB_Record.h"
+
+using namespace std;
+
+// create a smart pointer for compiled expressions
+class MyDB_CompiledExpr;
+typedef shared_ptr <MyDB_CompiledExpr> MyDB_CompiledExprPtr;
+
+// this is a computation (or a comparator) that has been compiled from its infix string
+// form into a tree of lambdas.  Unlike the lambdas produced in older versions of the
+// system, the tree is not tied to a particular record: the leaves read the attributes
+// of whatever record is currently bound to the expression.  So an expression that has
+// been compiled once can be re-used over and over again, for many different records
+class MyDB_CompiledExpr {
+
+public:
+
+	// points the expression at new input records... this is just a pointer swap;
+	// nothing is re-parsed or re-allocated.  The rhs is only used by comparators
+	inline void bind (MyDB_Record *lhs, MyDB_Record *rhs) {
+		*lhsRec = lhs;
+		*rhsRec = rhs;
+	}
+
+	// run the computation over the currently-bound record(s)
+	inline MyDB_Value run () {
+		return myFunc ();
+	}
+
+	// get the type of the result of the computation
+	MyDB_AttTypePtr getType ();
+
+private:
+
+	friend class MyDB_Record;
+	friend class MyDB_ExprCache;
+
+	MyDB_CompiledExpr ();
+
+	// the slots that the leaves of the lambda tree read their records from
+	shared_ptr <MyDB_Record *> lhsRec;
+	shared_ptr <MyDB_Record *> rhsRec;
+
+	// the compiled computation, and its type
+	valFunc myFunc;
+	MyDB_AttTypePtr myType;
+};
+
+// this is a cache of compiled expressions, keyed on the schema(s) of the input record(s) and the
+// text of the expression.  Compiling an expression means parsing the string and allocating a new
+// lambda tree; in a typical workload the same few expressions are compiled over and over, so it is
+// much cheaper to hand back an idle copy of an expression that has already been compiled.  The cache
+// can be used from many threads at once
+class MyDB_ExprCache {
+
+public:
+
+	// gets a compiled version of the given computation, bound to the record forMe.  When the last
+	// reference to the returned expression goes away, the expression goes back into the cache
+	static MyDB_CompiledExprPtr getComputation (MyDB_Record &forMe, string computation);
+
+	// gets a compiled version of a comparator that returns a bool attribute that is true if and only
+	// if the given computation over lhs is less than the computation over rhs
+	static MyDB_CompiledExprPtr getComparator (MyDB_Record &lhs, MyDB_Record &rhs, string computation);
+
+private:
+
+	// everything that we know about a particular (schema, schema, expression) triple.  An expression
+	// that is in use holds onto its entry, so the entry stays around until it is checked back in, even
+	// if the cache itself is gone by then
+	struct Entry;
+	typedef shared_ptr <Entry> EntryPtr;
+	struct Entry {
+
+		// the schemas that the expressions were compiled against; once they are gone, so is the entry
+		weak_ptr <MyDB_Schema> lhsSchema;
+		weak_ptr <MyDB_Schema> rhsSchema;
+		bool hasRhs;
+
+		// the compiled expressions that are not currently being used, and the mutex for them
+		vector <MyDB_CompiledExpr *> idle;
+		mutex idleMutex;
+
+		~Entry ();
+	};
+
+	// the key is (lhs schema ID, rhs schema ID, expression); the rhs schema ID is zero for a computation.
+	// Schema IDs are never re-used (see MyDB_Schema.getID), so an entry never has stale expressions
+	typedef tuple <size_t, size_t, string> Key;
+
+	// find the entry for the given key, making one if there is none yet
+	EntryPtr getEntry (MyDB_SchemaPtr &lhsSchema, MyDB_SchemaPtr *rhsSchema, string &computation);
+
+	// takes an idle expression from the entry, or returns nullptr if there is none
+	static MyDB_CompiledExpr *checkOut (EntryPtr fromMe);
+
+	// wraps up an expression so that it is returned to the given entry when it is no longer used
+	static MyDB_CompiledExprPtr wrap (EntryPtr whichEntry, MyDB_CompiledExpr *wrapMe);
+
+	// access the one and only cache
+	static MyDB_ExprCache &getCache ();
+
+	map <Key, EntryPtr> allEntries;
+	mutex entriesMutex;
+};
+
+#endif
@@ -14,10 +14,31 @@ using namespace std;
 // create a smart pointer for records
 class MyDB_Record;
 typedef shared_ptr <MyDB_Record> MyDB_RecordPtr;
+class MyDB_CompiledExpr;
 
 // a lambda function over the record... computes an attribute value
 typedef function <MyDB_AttValPtr ()> func;
 
+// a lambda function over the record that computes a value without allocating anything; compiled
+// computations are built out of these
+typedef function <MyDB_Value ()> valFunc;
+
+// a predicate that is run directly over a record in its serialized form (as written by toBinary)
+typedef function <bool (void *)> binaryPred;
+
+// a comparison of one of a record's attributes with a constant, such as "> ([acctbal], double[4000.0])";
+// see MyDB_Record.parseComparison.  The flags say which outcomes of comparing the attribute with the
+// constant make the comparison true (so "!=" is less or greater)
+struct MyDB_SimpleComparison {
+	int whichAtt;
+	string attType;
+	bool ifLess;
+	bool ifEqual;
+	bool ifGreater;
+	string constType;
+	string constVal;
+};
+
 class MyDB_Record {
 
 public:
@@ -25,8 +46,12 @@ public:
 	// constructs a record that can hold data for the given schema
 	MyDB_Record (MyDB_SchemaPtr mySchema);
 
-	// read the record from the text string
-	void fromText (string fromMe);
+	// parse the contents of this record from the text in [start, end), which has the same
+	// format as the text given to fromString.  This does not allocate anything: each field is
+	// parsed in place and written straight into the record's serialized buffer, and then the
+	// attributes are pointed at the buffer (just as in fromBinary).  The text is not changed.
+	// A field of a numeric attribute that is not a number (or is out of range) is an error
+	void fromText (const char *start, const char *end);
 
 	// get the number of bytes required to store the record as a binary string
 	size_t getBinarySize ();
@@ -98,8 +123,16 @@ public:
 	// the entire file, computing the function after each new record is loaded, without
 	// recompiling the function.
 	//
+	// compiled computations are cached (see MyDB_ExprCache.h), so compiling the same string over
+	// records with the same schema many times is cheap
+	//
 	func compileComputation (string fromMe);
 
+	// like compileComputation, but for a computation that returns a bool... this is preferable when
+	// the function will be run many times (say, as a selection predicate) since it avoids copying
+	// the result into a MyDB_AttVal
+	function <bool ()> compilePredicate (string fromMe);
+
 	// builds a function that returns true if lhs < rhs; the comparison is done by running whatever computation is 
 	// encoded by the string "computation" on both lhs and rhs, and then compariing the results obtained using this
 	// computation over both.  If the result from lhs is < the result from rhs, then the function returned from
@@ -109,12 +142,38 @@ public:
 	// used by the method compileComputation above
 	friend function <bool ()> buildRecordComparator (MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs, string computation);
 
+	// if the given computation is a simple comparison of one of this record's attributes with a
+	// constant (such as "> ([acctbal], double[4000.0])" or "== (string[Supplier#000000007], [name])",
+	// using any of <, >, == or !=), builds a predicate that evaluates the comparison directly over
+	// the bytes of a serialized record, without copying or deserializing it.  This allows a scan
+	// to only materialize (via fromBinary) the records that actually qualify.  If the computation
+	// is not of this simple form, nullptr is returned, and the caller should fall back on
+	// compileComputation
+	binaryPred compileBinaryPredicate (string computation);
+
+	// if the given computation is a simple comparison of one of this record's attributes with a
+	// constant (as described above), fills in intoMe and returns true; otherwise, returns false
+	bool parseComparison (string computation, MyDB_SimpleComparison &intoMe);
+
+	// breaks the given computation up into a list of predicates that are and-ed together (so
+	// "&& (A, && (B, C))" gives A, B, C), and returns the ones that are simple comparisons.  All of
+	// these must be true for the computation to be true
+	vector <MyDB_SimpleComparison> getSimpleConjuncts (string computation);
+
 	// access the schema
 	MyDB_SchemaPtr &getSchema ();
 
-	// access a particular attribute
+	// access a particular attribute; this is the way to change an attribute (or to get at it through
+	// the MyDB_AttVal interface), but to just read it, getValue is faster
 	MyDB_AttValPtr &getAtt (int whichAtt);
 
+	// get the value of a particular attribute, without any allocation (see MyDB_Value.h); for a
+	// dictionary-encoded attribute, this is the value's code
+	MyDB_Value getValue (int whichAtt);
+
+	// like getValue, but a dictionary-encoded attribute gives its actual value
+	MyDB_Value getDecodedValue (int whichAtt);
+
 private:
 
 	// for fast reading from a page; the contents of the record are simply copied into this buffer
@@ -126,26 +185,34 @@ private:
 	// the amount of data in the record buffer
 	size_t recSize;
 
-	// helper function for the compilation
-	pair <func, MyDB_AttTypePtr> compileHelper (char * &vals);
+	// helper function for the compilation; references to attributes are compiled so that they
+	// read from whatever record boundRec points to when the computation is run
+	pair <valFunc, MyDB_AttTypePtr> compileHelper (char * &vals, shared_ptr <MyDB_Record *> &boundRec);
+
+	// actually compiles the given computation over this record's schema (compileComputation goes
+	// to the expression cache first; this is only called when there is a cache miss)
+	MyDB_CompiledExpr *compileExpr (string compileMe);
+
+	// like the above, but compiles a comparator over the two records
+	static MyDB_CompiledExpr *compileComparatorExpr (MyDB_Record &lhs, MyDB_Record &rhs, string computation);
 
 	// helper function for the compilation
 	char *findsymbol (char val, char *input);
 	
 	// these functions are all used to build up computations over the record
-	pair <func, MyDB_AttTypePtr> fromData (string attName);
-	pair <func, MyDB_AttTypePtr> plus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> minus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> times (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> divide (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> gt (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> lt (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> eq (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> neq (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> andd (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> orr (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs);
-	pair <func, MyDB_AttTypePtr> unaryMinus (pair <func, MyDB_AttTypePtr> lhs);
-	pair <func, MyDB_AttTypePtr> nott (pair <func, MyDB_AttTypePtr> lhs);
+	pair <valFunc, MyDB_AttTypePtr> fromData (string attName, shared_ptr <MyDB_Record *> &boundRec);
+	pair <valFunc, MyDB_AttTypePtr> plus (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs);
+	pair <valFunc, MyDB_AttTypePtr> minus (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs);
+	pair <valFunc, MyDB_AttTypePtr> times (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs);
+	pair <valFunc, MyDB_AttTypePtr> divide (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs);
+	pair <valFunc, MyDB_AttTypePtr> gt (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs);
+	pair <valFunc, MyDB_AttTypePtr> lt (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs);
+	pair <valFunc, MyDB_AttTypePtr> eq (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs);
+	pair <valFunc, MyDB_AttTypePtr> neq (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs);
+	pair <valFunc, MyDB_AttTypePtr> andd (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs);
+	pair <valFunc, MyDB_AttTypePtr> orr (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs);
+	pair <valFunc, MyDB_AttTypePtr> unaryMinus (pair <valFunc, MyDB_AttTypePtr> lhs);
+	pair <valFunc, MyDB_AttTypePtr> nott (pair <valFunc, MyDB_AttTypePtr> lhs);
 
 	// write the current attribute values into the buffer
 	void writeAttsToBuffer ();
@@ -153,12 +220,24 @@ private:
 	// true when the set of attributes don't match the attribute buffer
 	bool bufferOld;
 
+	// the type of each attribute, and the dictionary for each dictionary-encoded attribute (nullptr
+	// for the others), used by fromText
+	vector <MyDB_ValueType> attTypes;
+	vector <MyDB_DictionaryPtr> dictionaries;
+
 	// this is a subtype
 	friend class MyDB_INRecord;
 
+	// the expression cache needs to be able to compile expressions
+	friend class MyDB_ExprCache;
+
 	MyDB_SchemaPtr mySchema;
+
+	// the attributes.  These are still MyDB_AttVal objects, since getAtt hands them out to be changed;
+	// but they are made once, when the record is, and read straight from the buffer, so reading a
+	// record's values via getValue (as the compiled computations and comparators do) does not
+	// allocate or make any virtual calls
 	vector <MyDB_AttValPtr> values;	
-	vector <MyDB_AttValPtr> scratch;
 
 };
 
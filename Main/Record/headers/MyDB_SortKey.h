@@ -0,0 +1,99 @@
+
+#ifndef SORT_KEY_H
+#define SORT_KEY_H
+
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "MyDB_Schema.h"
+
+using namespace std;
+
+// create a smart pointer for sort keys
+class MyDB_SortKey;
+typedef shared_ptr <MyDB_SortKey> MyDB_SortKeyPtr;
+
+// A MyDB_SortKey describes a sort order over records (ascending on a list of attributes), and is
+// used to produce "normalized" keys for records.  A normalized key is a byte string with the
+// property that memcmp order over the keys is exactly the sort order over the records.  Ints are
+// stored big-endian with the sign bit flipped, doubles are stored big-endian with the sign bit
+// flipped (and all of the other bits flipped too if the number is negative), bools are a single
+// byte, and strings are stored as their characters followed by a zero byte.  A dictionary-encoded
+// attribute is stored as its code (like an int) if the codes are in order, and as its value if not.  So once the keys have
+// been built, sorting needs no deserialization, no virtual calls, and no lambdas
+class MyDB_SortKey {
+
+public:
+
+	// build a sort key for records with the given schema, sorting on the given attributes, in order
+	MyDB_SortKey (MyDB_SchemaPtr mySchema, vector <string> sortAtts);
+
+	// write the normalized key for the given serialized record (as written by MyDB_Record.toBinary)
+	// into intoMe; the attributes are read right out of the record's bytes
+	void encode (void *serializedRec, string &intoMe);
+
+	// like the above, but appends the key to the end of intoMe
+	void appendKey (void *serializedRec, string &intoMe);
+
+	// three-way comparison of two normalized keys
+	static inline int compare (const char *lhs, size_t lhsLen, const char *rhs, size_t rhsLen) {
+		int res = memcmp (lhs, rhs, lhsLen < rhsLen ? lhsLen : rhsLen);
+		if (res != 0)
+			return res;
+		return (lhsLen > rhsLen) - (lhsLen < rhsLen);
+	}
+
+	// gets the first (up to) eight bytes of a key as a big-endian integer, zero-padded; if two keys
+	// have different prefixes, then the prefixes compare in the same way as the keys do
+	static inline uint64_t getPrefix (const char *key, size_t len) {
+		uint64_t prefix = 0;
+		for (size_t i = 0; i < 8; i++) {
+			prefix <<= 8;
+			if (i < len)
+				prefix |= (unsigned char) key[i];
+		}
+		return prefix;
+	}
+
+private:
+
+	// the position of each of the sort attributes in the record, and its type
+	vector <pair <int, string>> sortAtts;
+
+	// the dictionary for each of the sort attributes that is dictionary-encoded (nullptr for the others)
+	vector <MyDB_DictionaryPtr> dictionaries;
+};
+
+// a record that is being sorted, along with its normalized key.  The keys for a group of records
+// are packed together into one buffer (an "arena"), and the first eight bytes of the key are
+// kept in prefix, so most comparisons never have to look at the arena at all
+struct MyDB_KeyedRec {
+	uint64_t prefix;
+	size_t keyOffset;
+	size_t keyLen;
+	void *rec;
+};
+
+// compares two keyed records, where the keys are all stored in the given arena
+class MyDB_KeyedRecComparator {
+
+public:
+
+	MyDB_KeyedRecComparator (const char *arenaIn) {
+		arena = arenaIn;
+	}
+
+	inline bool operator () (const MyDB_KeyedRec &lhs, const MyDB_KeyedRec &rhs) const {
+		if (lhs.prefix != rhs.prefix)
+			return lhs.prefix < rhs.prefix;
+		return MyDB_SortKey :: compare (arena + lhs.keyOffset, lhs.keyLen, arena + rhs.keyOffset, rhs.keyLen) < 0;
+	}
+
+private:
+
+	const char *arena;
+};
+
+#endif
@@ -0,0 +1,334 @@
+
+#ifndef TYPED_RECORD_H
+#define TYPED_RECORD_H
+
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <tuple>
+#include "MyDB_Schema.h"
+#include "MyDB_Value.h"
+
+using namespace std;
+
+// A MyDB_TypedRecord is a record whose schema is known at compile time.  For example:
+//
+// typedef MyDB_TypedRecord <int, string, string, int, string, double, string> SupplierRec;
+//
+// declares a record type for the supplier table.  A typed record is stored on a page in exactly
+// the same binary format as a MyDB_Record with the corresponding schema (see MyDB_Record.toBinary),
+// so both kinds of record can be used to read and write the same table.  However, the attributes
+// of a typed record are held directly in a tuple, and all of the code to serialize, deserialize,
+// and compare them is generated by the compiler and inlined: there is no virtual dispatch, and
+// no per-attribute heap allocation (strings re-use their capacity from record to record).  The
+// supported attribute types are int, double, bool, and string
+
+// this is how each of the attribute types is encoded; each attribute is stored as a short giving the
+// number of bytes used by the attribute (including the short itself), followed by the data
+template <class T>
+struct MyDB_TypedAtt;
+
+template <>
+struct MyDB_TypedAtt <int> {
+
+	static const char *typeName () {return "int";}
+
+	static size_t binarySize (const int &) {
+		return sizeof (short) + sizeof (int);
+	}
+
+	static char *toBinary (char *toHere, const int &val) {
+		*((short *) toHere) = (short) (sizeof (short) + sizeof (int));
+		*((int *) (toHere + sizeof (short))) = val;
+		return toHere + sizeof (short) + sizeof (int);
+	}
+
+	static char *fromBinary (char *fromHere, int &val) {
+		val = *((int *) (fromHere + sizeof (short)));
+		return fromHere + *((short *) fromHere);
+	}
+
+	static void fromString (const string &fromMe, int &val) {
+		val = stoi (fromMe);
+	}
+
+	static string toString (const int &val) {
+		return to_string (val);
+	}
+
+	// these all hash in the same way as the corresponding MyDB_AttVal
+	static size_t hash (const int &val) {
+		return std :: hash <int> () (val);
+	}
+};
+
+template <>
+struct MyDB_TypedAtt <double> {
+
+	static const char *typeName () {return "double";}
+
+	static size_t binarySize (const double &) {
+		return sizeof (short) + sizeof (double);
+	}
+
+	static char *toBinary (char *toHere, const double &val) {
+		*((short *) toHere) = (short) (sizeof (short) + sizeof (double));
+		*((double *) (toHere + sizeof (short))) = val;
+		return toHere + sizeof (short) + sizeof (double);
+	}
+
+	static char *fromBinary (char *fromHere, double &val) {
+		val = *((double *) (fromHere + sizeof (short)));
+		return fromHere + *((short *) fromHere);
+	}
+
+	static void fromString (const string &fromMe, double &val) {
+		val = stod (fromMe);
+	}
+
+	static string toString (const double &val) {
+		return to_string (val);
+	}
+
+	static size_t hash (const double &val) {
+		return std :: hash <int> () ((int) val);
+	}
+};
+
+template <>
+struct MyDB_TypedAtt <bool> {
+
+	static const char *typeName () {return "bool";}
+
+	static size_t binarySize (const bool &) {
+		return sizeof (short) + sizeof (char);
+	}
+
+	static char *toBinary (char *toHere, const bool &val) {
+		*((short *) toHere) = (short) (sizeof (short) + sizeof (char));
+		*(toHere + sizeof (short)) = val ? 1 : 0;
+		return toHere + sizeof (short) + sizeof (char);
+	}
+
+	static char *fromBinary (char *fromHere, bool &val) {
+		val = *(fromHere + sizeof (short)) != 0;
+		return fromHere + *((short *) fromHere);
+	}
+
+	static void fromString (const string &fromMe, bool &val) {
+		if (fromMe == "false") {
+			val = false;
+		} else if (fromMe == "true") {
+			val = true;
+		} else {
+			cout << "Oops!  Bad string for boolean\n";
+			exit (1);
+		}
+	}
+
+	static string toString (const bool &val) {
+		return val ? "true" : "false";
+	}
+
+	static size_t hash (const bool &val) {
+		return std :: hash <int> () (val);
+	}
+};
+
+template <>
+struct MyDB_TypedAtt <string> {
+
+	static const char *typeName () {return "string";}
+
+	// strings are stored null-terminated
+	static size_t binarySize (const string &val) {
+		return sizeof (short) + val.size () + 1;
+	}
+
+	static char *toBinary (char *toHere, const string &val) {
+		*((short *) toHere) = (short) (sizeof (short) + val.size () + 1);
+		memcpy (toHere + sizeof (short), val.c_str (), val.size () + 1);
+		return toHere + sizeof (short) + val.size () + 1;
+	}
+
+	static char *fromBinary (char *fromHere, string &val) {
+		short len = *((short *) fromHere);
+		val.assign (fromHere + sizeof (short), len - sizeof (short) - 1);
+		return fromHere + len;
+	}
+
+	static void fromString (const string &fromMe, string &val) {
+		val = fromMe;
+	}
+
+	static string toString (const string &val) {
+		return val;
+	}
+
+	static size_t hash (const string &val) {
+		return MyDB_Value :: fromString (val.c_str (), val.size ()).hashString ();
+	}
+};
+
+// this recursively generates the code to process attributes whichAtt, whichAtt + 1, ..., numAtts - 1
+template <size_t whichAtt, size_t numAtts>
+struct MyDB_TypedRecHelper {
+
+	template <class Tuple>
+	using Att = MyDB_TypedAtt <typename tuple_element <whichAtt, Tuple>::type>;
+
+	template <class Tuple>
+	static size_t binarySize (const Tuple &atts) {
+		return Att <Tuple> :: binarySize (get <whichAtt> (atts)) +
+			MyDB_TypedRecHelper <whichAtt + 1, numAtts> :: binarySize (atts);
+	}
+
+	template <class Tuple>
+	static char *toBinary (char *toHere, const Tuple &atts) {
+		toHere = Att <Tuple> :: toBinary (toHere, get <whichAtt> (atts));
+		return MyDB_TypedRecHelper <whichAtt + 1, numAtts> :: toBinary (toHere, atts);
+	}
+
+	template <class Tuple>
+	static char *fromBinary (char *fromHere, Tuple &atts) {
+		fromHere = Att <Tuple> :: fromBinary (fromHere, get <whichAtt> (atts));
+		return MyDB_TypedRecHelper <whichAtt + 1, numAtts> :: fromBinary (fromHere, atts);
+	}
+
+	// the attributes in the string are separated (and terminated) by a '|'
+	template <class Tuple>
+	static void fromString (const string &fromMe, size_t pos, Tuple &atts) {
+		size_t end = fromMe.find ('|', pos);
+		Att <Tuple> :: fromString (fromMe.substr (pos, end - pos), get <whichAtt> (atts));
+		MyDB_TypedRecHelper <whichAtt + 1, numAtts> :: fromString (fromMe, end + 1, atts);
+	}
+
+	template <class Tuple>
+	static void print (std::ostream &os, const Tuple &atts) {
+		os << Att <Tuple> :: toString (get <whichAtt> (atts)) << "|";
+		MyDB_TypedRecHelper <whichAtt + 1, numAtts> :: print (os, atts);
+	}
+
+	template <class Tuple>
+	static void getHashes (size_t *intoMe, const Tuple &atts) {
+		intoMe[whichAtt] = Att <Tuple> :: hash (get <whichAtt> (atts));
+		MyDB_TypedRecHelper <whichAtt + 1, numAtts> :: getHashes (intoMe, atts);
+	}
+
+	template <class Tuple>
+	static bool matches (vector <pair <string, MyDB_AttTypePtr>> &atts) {
+		return atts[whichAtt].second->toString () == Att <Tuple> :: typeName () &&
+			MyDB_TypedRecHelper <whichAtt + 1, numAtts> :: template matches <Tuple> (atts);
+	}
+};
+
+// the end of the recursion
+template <size_t numAtts>
+struct MyDB_TypedRecHelper <numAtts, numAtts> {
+
+	template <class Tuple>
+	static size_t binarySize (const Tuple &) {
+		return 0;
+	}
+
+	template <class Tuple>
+	static char *toBinary (char *toHere, const Tuple &) {
+		return toHere;
+	}
+
+	template <class Tuple>
+	static char *fromBinary (char *fromHere, Tuple &) {
+		return fromHere;
+	}
+
+	template <class Tuple>
+	static void fromString (const string &, size_t, Tuple &) {}
+
+	template <class Tuple>
+	static void print (std::ostream &, const Tuple &) {}
+
+	template <class Tuple>
+	static void getHashes (size_t *, const Tuple &) {}
+
+	template <class Tuple>
+	static bool matches (vector <pair <string, MyDB_AttTypePtr>> &) {
+		return true;
+	}
+};
+
+template <class... Atts>
+class MyDB_TypedRecord {
+
+public:
+
+	typedef tuple <Atts...> AttTuple;
+	typedef MyDB_TypedRecHelper <0, sizeof... (Atts)> Helper;
+
+	// access a particular attribute
+	template <size_t whichAtt>
+	typename tuple_element <whichAtt, AttTuple>::type &getAtt () {
+		return get <whichAtt> (atts);
+	}
+
+	template <size_t whichAtt>
+	const typename tuple_element <whichAtt, AttTuple>::type &getAtt () const {
+		return get <whichAtt> (atts);
+	}
+
+	// get the number of bytes required to store the record as a binary string
+	size_t getBinarySize () const {
+		return sizeof (short) + Helper :: binarySize (atts);
+	}
+
+	// write the contents of the record in binary to the specifed location; return
+	// the location of the next byte that was not writen (see MyDB_Record.toBinary)
+	void *toBinary (void *toHere) const {
+		char *loc = Helper :: toBinary (((char *) toHere) + sizeof (short), atts);
+		*((short *) toHere) = (short) (loc - (char *) toHere);
+		return loc;
+	}
+
+	// reverse of the above; returns the location of the byte just past the record
+	void *fromBinary (void *fromHere) {
+		Helper :: fromBinary (((char *) fromHere) + sizeof (short), atts);
+		return ((char *) fromHere) + *((short *) fromHere);
+	}
+
+	// write the hash of each attribute (as computed by MyDB_AttVal.hash) into intoMe
+	void getHashes (size_t *intoMe) const {
+		Helper :: getHashes (intoMe, atts);
+	}
+
+	// parse the contents of this record from the given string, as in MyDB_Record.fromString
+	void fromString (const string &fromMe) {
+		Helper :: fromString (fromMe, 0, atts);
+	}
+
+	// returns true if the given schema has exactly the attribute types of this record type, so that
+	// a table with that schema can be read and written using this record type
+	static bool matches (MyDB_SchemaPtr checkMe) {
+		return checkMe->getAtts ().size () == sizeof... (Atts) &&
+			Helper :: template matches <AttTuple> (checkMe->getAtts ());
+	}
+
+	// a comparator that can be used to sort typed records on a particular attribute
+	template <size_t whichAtt>
+	struct LessThan {
+		bool operator () (const MyDB_TypedRecord &lhs, const MyDB_TypedRecord &rhs) const {
+			return get <whichAtt> (lhs.atts) < get <whichAtt> (rhs.atts);
+		}
+	};
+
+	// write the record to an output stream, in the same format as a MyDB_Record
+	friend std::ostream& operator<< (std::ostream& os, const MyDB_TypedRecord &printMe) {
+		Helper :: print (os, printMe.atts);
+		return os;
+	}
+
+private:
+
+	AttTuple atts;
+};
+
+#endif
@@ -0,0 +1,159 @@
+
+#ifndef VALUE_H
+#define VALUE_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+// the kinds of values that a MyDB_Value can hold
+enum class MyDB_ValueType : char {IntVal, DoubleVal, BoolVal, StringVal};
+
+// A MyDB_Value is a small, trivially-copyable tagged value.  Unlike a MyDB_AttVal, it is not
+// heap-allocated and it has no virtual methods, so it can be passed around by value at almost no
+// cost.  Numeric and boolean values are stored directly.  A string value is just a pointer and a
+// length; it does not own its characters, which usually live in the buffer of the record that the
+// value was read from (see MyDB_AttVal.getValue).  So a string value is only good until the
+// storage it points to is changed---for a value read out of a record, that is until the next
+// time that the record is loaded
+class MyDB_Value {
+
+public:
+
+	MyDB_Value () {
+		type = MyDB_ValueType :: IntVal;
+		intVal = 0;
+	}
+
+	static inline MyDB_Value fromInt (int val) {
+		MyDB_Value returnVal;
+		returnVal.intVal = val;
+		return returnVal;
+	}
+
+	static inline MyDB_Value fromDouble (double val) {
+		MyDB_Value returnVal;
+		returnVal.type = MyDB_ValueType :: DoubleVal;
+		returnVal.doubleVal = val;
+		return returnVal;
+	}
+
+	static inline MyDB_Value fromBool (bool val) {
+		MyDB_Value returnVal;
+		returnVal.type = MyDB_ValueType :: BoolVal;
+		returnVal.boolVal = val;
+		return returnVal;
+	}
+
+	// the characters are not copied; len does not include any null terminator
+	static inline MyDB_Value fromString (const char *chars, size_t len) {
+		MyDB_Value returnVal;
+		returnVal.type = MyDB_ValueType :: StringVal;
+		returnVal.stringVal.chars = chars;
+		returnVal.stringVal.len = len;
+		return returnVal;
+	}
+
+	inline MyDB_ValueType getType () const {
+		return type;
+	}
+
+	// numeric accessors; as with MyDB_AttVal, an int can be read as a double and vice-versa, but
+	// reading a string or a bool as a number (or a number or a string as a bool) is an error
+	inline int toInt () const {
+		switch (type) {
+			case MyDB_ValueType :: IntVal: return intVal;
+			case MyDB_ValueType :: DoubleVal: return (int) doubleVal;
+			default: badConversion ("int");
+		}
+	}
+
+	inline double toDouble () const {
+		switch (type) {
+			case MyDB_ValueType :: IntVal: return (double) intVal;
+			case MyDB_ValueType :: DoubleVal: return doubleVal;
+			default: badConversion ("double");
+		}
+	}
+
+	inline bool toBool () const {
+		if (type != MyDB_ValueType :: BoolVal)
+			badConversion ("bool");
+		return boolVal;
+	}
+
+	// string accessors... these do not copy or allocate
+	inline const char *getChars () const {
+		return stringVal.chars;
+	}
+
+	inline size_t getLength () const {
+		return stringVal.len;
+	}
+
+	// three-way comparison of two string values; this orders strings in exactly the same way as
+	// std::string does (byte-by-byte, as unsigned chars)
+	inline int compareStrings (const MyDB_Value &toMe) const {
+		size_t len = stringVal.len < toMe.stringVal.len ? stringVal.len : toMe.stringVal.len;
+		int res = memcmp (stringVal.chars, toMe.stringVal.chars, len);
+		if (res != 0)
+			return res;
+		return (stringVal.len > toMe.stringVal.len) - (stringVal.len < toMe.stringVal.len);
+	}
+
+	// three-way comparison of two values as strings, which is how strings are compared by computations
+	// and by the B+-Tree; a number (or a bool) is first converted to a string, which allocates, but
+	// two string values are compared without any copying
+	inline int compareAsStrings (const MyDB_Value &toMe) const {
+		if (type == MyDB_ValueType :: StringVal && toMe.type == MyDB_ValueType :: StringVal)
+			return compareStrings (toMe);
+		return toString ().compare (toMe.toString ());
+	}
+
+	// a 64-bit FNV-1a hash of the characters in a string value
+	inline size_t hashString () const {
+		uint64_t hash = 14695981039346656037ULL;
+		for (size_t i = 0; i < stringVal.len; i++) {
+			hash ^= (unsigned char) stringVal.chars[i];
+			hash *= 1099511628211ULL;
+		}
+		return (size_t) hash;
+	}
+
+	// converts any value to a string, in the same format as MyDB_AttVal.toString... this allocates,
+	// so it should be avoided in performance-critical code
+	string toString () const {
+		switch (type) {
+			case MyDB_ValueType :: IntVal: return to_string (intVal);
+			case MyDB_ValueType :: DoubleVal: return to_string (doubleVal);
+			case MyDB_ValueType :: BoolVal: return boolVal ? "true" : "false";
+			default: return string (stringVal.chars, stringVal.len);
+		}
+	}
+
+private:
+
+	[[noreturn]] void badConversion (const char *toType) const {
+		const char *names[] = {"int", "double", "bool", "string"};
+		cout << "Oops!  Can't convert " << names[(int) type] << " to " << toType << "\n";
+		exit (1);
+	}
+
+	MyDB_ValueType type;
+
+	union {
+		int intVal;
+		double doubleVal;
+		bool boolVal;
+		struct {
+			const char *chars;
+			size_t len;
+		} stringVal;
+	};
+};
+
+#endif
@@ -51,7 +51,13 @@ void MyDB_BoolAttVal :: set (MyDB_AttValPtr fromMe) {
 }
 
 void MyDB_StringAttVal :: set (MyDB_AttValPtr fromMe) {
-	value = fromMe->toString ();
+
+	// copy the characters directly out of the other attribute if we can
+	MyDB_Value fromVal = fromMe->getValue ();
+	if (fromVal.getType () == MyDB_ValueType :: StringVal)
+		value.assign (fromVal.getChars (), fromVal.getLength ());
+	else
+		value = fromMe->toString ();
 	setNotBuffered ();
 }
 
@@ -78,7 +84,7 @@ size_t MyDB_BoolAttVal :: hash () {
 }
 
 size_t MyDB_StringAttVal :: hash () {
-	return std :: hash <string> () (toString ());
+	return getValue ().hashString ();
 }
 
 bool MyDB_IntAttVal :: toBool () {
@@ -102,6 +108,7 @@ void MyDB_IntAttVal :: set (int val) {
 }
 
 MyDB_IntAttVal :: MyDB_IntAttVal () {
+	valueType = MyDB_ValueType :: IntVal;
 	value = 0;
 	setNotBuffered ();
 }
@@ -163,6 +170,7 @@ void MyDB_DoubleAttVal :: set (double val) {
 }
 
 MyDB_DoubleAttVal :: MyDB_DoubleAttVal () {
+	valueType = MyDB_ValueType :: DoubleVal;
 	value = 0;
 	setNotBuffered ();
 }
@@ -207,14 +215,17 @@ bool MyDB_StringAttVal :: toBool () {
 
 void MyDB_StringAttVal :: serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) {
 
-	string value = toString ();
+	// get the characters (and their length) without copying them
+	MyDB_Value myVal = getValue ();
+	size_t len = myVal.getLength ();
 
-	extendBuffer (buffer, allocatedSize, totSize, strlen (value.c_str ()) + 1 + sizeof (short));
+	extendBuffer (buffer, allocatedSize, totSize, len + 1 + sizeof (short));
 
-	*((short *) (buffer + totSize)) = (short) (sizeof (short) + strlen (value.c_str ()) + 1);
+	*((short *) (buffer + totSize)) = (short) (sizeof (short) + len + 1);
 	totSize += sizeof (short);
-	memcpy (buffer + totSize, value.c_str (), strlen (value.c_str ()) + 1);
-	totSize += strlen (value.c_str ()) + 1;
+	memcpy (buffer + totSize, myVal.getChars (), len);
+	buffer[totSize + len] = 0;
+	totSize += len + 1;
 }
 
 void MyDB_StringAttVal :: set (string val) {
@@ -223,6 +234,7 @@ void MyDB_StringAttVal :: set (string val) {
 }
 
 MyDB_StringAttVal :: MyDB_StringAttVal () {
+	valueType = MyDB_ValueType :: StringVal;
         value = "";
 	setNotBuffered ();
 }
@@ -311,7 +323,8 @@ MyDB_AttValPtr MyDB_DoubleAttVal :: getCopy () {
 
 MyDB_AttValPtr MyDB_StringAttVal :: getCopy () {
 	MyDB_StringAttValPtr retVal = make_shared <MyDB_StringAttVal> ();
-	retVal->set (toString ());
+	MyDB_Value myVal = getValue ();
+	retVal->value.assign (myVal.getChars (), myVal.getLength ());
 	return retVal;	
 }
 
@@ -322,10 +335,104 @@ MyDB_AttValPtr MyDB_BoolAttVal :: getCopy () {
 }
 
 MyDB_BoolAttVal :: MyDB_BoolAttVal () {
+	valueType = MyDB_ValueType :: BoolVal;
 	value = false;
 	setNotBuffered ();
 }
 
 MyDB_BoolAttVal :: ~MyDB_BoolAttVal () {}
 
+int MyDB_DictAttVal :: getCode () {
+	return MyDB_IntAttVal :: toInt ();
+}
+
+void MyDB_DictAttVal :: setCode (int toMe) {
+	MyDB_IntAttVal :: set (toMe);
+}
+
+MyDB_Value MyDB_DictAttVal :: getDecodedValue () {
+	return dictionary->getValue (getCode ());
+}
+
+MyDB_DictionaryPtr MyDB_DictAttVal :: getDictionary () {
+	return dictionary;
+}
+
+int MyDB_DictAttVal :: toInt () {
+	if (!dictionary->isNumeric ()) {
+		cout << "Oops!  Can't convert string to int";
+		exit (1);
+	}
+	return getDecodedValue ().toInt ();
+}
+
+double MyDB_DictAttVal :: toDouble () {
+	if (!dictionary->isNumeric ()) {
+		cout << "Oops!  Can't convert string to double";
+		exit (1);
+	}
+	return getDecodedValue ().toDouble ();
+}
+
+string MyDB_DictAttVal :: toString () {
+	return getDecodedValue ().toString ();
+}
+
+bool MyDB_DictAttVal :: toBool () {
+	cout << "Oops!  Can't convert dictionary value to bool";
+	exit (1);
+}
+
+void MyDB_DictAttVal :: fromInt (int fromMe) {
+	setCode (dictionary->addValue (MyDB_Value :: fromInt (fromMe)));
+}
+
+void MyDB_DictAttVal :: fromString (string &fromMe) {
+	setCode (dictionary->addValue (MyDB_Value :: fromString (fromMe.c_str (), fromMe.size ())));
+}
+
+void MyDB_DictAttVal :: set (MyDB_AttValPtr fromMe) {
+
+	// if the other attribute uses the same dictionary, just copy the code
+	MyDB_DictAttVal *other = dynamic_cast <MyDB_DictAttVal *> (fromMe.get ());
+	if (other != nullptr && other->dictionary == dictionary) {
+		setCode (other->getCode ());
+		return;
+	}
+
+	MyDB_Value fromVal = (other != nullptr) ? other->getDecodedValue () : fromMe->getValue ();
+	if (dictionary->isNumeric () && fromVal.getType () != MyDB_ValueType :: StringVal)
+		fromInt (fromVal.toInt ());
+	else
+		setCode (dictionary->addValue (fromVal));
+}
+
+// two values in the same dictionary are equal exactly when their codes are, so the code is hashed
+// rather than the (possibly long) value
+size_t MyDB_DictAttVal :: hash () {
+	return std :: hash <int> () (getCode ());
+}
+
+MyDB_AttValPtr MyDB_DictAttVal :: getCopy () {
+	MyDB_DictAttValPtr retVal = make_shared <MyDB_DictAttVal> (dictionary);
+	retVal->setCode (getCode ());
+	return retVal;
+}
+
+void MyDB_DictAttVal :: serialize (char *&buffer, size_t &allocatedSize, size_t &totSize) {
+
+	extendBuffer (buffer, allocatedSize, totSize, sizeof (int) + sizeof (short));
+
+	*((short *) (buffer + totSize)) = (short) (sizeof (short) + sizeof (int));
+	totSize += sizeof (short);
+	*((int *) (buffer + totSize)) = getCode ();
+	totSize += sizeof (int);
+}
+
+MyDB_DictAttVal :: MyDB_DictAttVal (MyDB_DictionaryPtr dictionaryIn) {
+	dictionary = dictionaryIn;
+}
+
+MyDB_DictAttVal :: ~MyDB_DictAttVal () {}
+
 #endif
@@ -0,0 +1,113 @@
+
+#ifndef EXPR_CACHE_C
+#define EXPR_CACHE_C
+
+#include "MyDB_ExprCache.h"
+
+using namespace std;
+
+// the maximum number of idle copies of any one expression that we will hold onto
+#define MAX_IDLE 16
+
+MyDB_CompiledExpr :: MyDB_CompiledExpr () {
+	lhsRec = make_shared <MyDB_Record *> (nullptr);
+	rhsRec = make_shared <MyDB_Record *> (nullptr);
+}
+
+MyDB_AttTypePtr MyDB_CompiledExpr :: getType () {
+	return myType;
+}
+
+MyDB_ExprCache &MyDB_ExprCache :: getCache () {
+	static MyDB_ExprCache theCache;
+	return theCache;
+}
+
+MyDB_CompiledExprPtr MyDB_ExprCache :: getComputation (MyDB_Record &forMe, string computation) {
+
+	// records with no schema (such as B+-Tree internal records) cannot share compiled expressions
+	if (forMe.getSchema () == nullptr)
+		return MyDB_CompiledExprPtr (forMe.compileExpr (computation));
+
+	EntryPtr myEntry = getCache ().getEntry (forMe.getSchema (), nullptr, computation);
+
+	// if there is nothing idle, then we need to compile; otherwise, just re-point an idle one at
+	// this record
+	MyDB_CompiledExpr *returnVal = checkOut (myEntry);
+	if (returnVal == nullptr)
+		returnVal = forMe.compileExpr (computation);
+	else
+		returnVal->bind (&forMe, nullptr);
+
+	return wrap (myEntry, returnVal);
+}
+
+MyDB_CompiledExprPtr MyDB_ExprCache :: getComparator (MyDB_Record &lhs, MyDB_Record &rhs, string computation) {
+
+	if (lhs.getSchema () == nullptr || rhs.getSchema () == nullptr)
+		return MyDB_CompiledExprPtr (MyDB_Record :: compileComparatorExpr (lhs, rhs, computation));
+
+	EntryPtr myEntry = getCache ().getEntry (lhs.getSchema (), &rhs.getSchema (), computation);
+	MyDB_CompiledExpr *returnVal = checkOut (myEntry);
+	if (returnVal == nullptr)
+		returnVal = MyDB_Record :: compileComparatorExpr (lhs, rhs, computation);
+	else
+		returnVal->bind (&lhs, &rhs);
+
+	return wrap (myEntry, returnVal);
+}
+
+MyDB_ExprCache :: EntryPtr MyDB_ExprCache :: getEntry (MyDB_SchemaPtr &lhsSchema, MyDB_SchemaPtr *rhsSchema, 
+	string &computation) {
+
+	Key myKey (lhsSchema->getID (), rhsSchema == nullptr ? 0 : (*rhsSchema)->getID (), computation);
+	lock_guard <mutex> lock (entriesMutex);
+	auto pos = allEntries.find (myKey);
+	if (pos != allEntries.end ())
+		return pos->second;
+
+	// before adding a new entry, get rid of the ones for schemas that are gone
+	for (auto i = allEntries.begin (); i != allEntries.end ();) {
+		if (i->second->lhsSchema.expired () || (i->second->hasRhs && i->second->rhsSchema.expired ()))
+			i = allEntries.erase (i);
+		else
+			i++;
+	}
+
+	EntryPtr myEntry = make_shared <Entry> ();
+	myEntry->lhsSchema = lhsSchema;
+	myEntry->hasRhs = (rhsSchema != nullptr);
+	if (rhsSchema != nullptr)
+		myEntry->rhsSchema = *rhsSchema;
+	allEntries[myKey] = myEntry;
+	return myEntry;
+}
+
+MyDB_CompiledExpr *MyDB_ExprCache :: checkOut (EntryPtr fromMe) {
+	lock_guard <mutex> lock (fromMe->idleMutex);
+	if (fromMe->idle.empty ())
+		return nullptr;
+	MyDB_CompiledExpr *returnVal = fromMe->idle.back ();
+	fromMe->idle.pop_back ();
+	return returnVal;
+}
+
+MyDB_CompiledExprPtr MyDB_ExprCache :: wrap (EntryPtr whichEntry, MyDB_CompiledExpr *wrapMe) {
+	return MyDB_CompiledExprPtr (wrapMe, [whichEntry] (MyDB_CompiledExpr *checkMeIn) {
+
+		// make sure that the expression does not point at a record that is going away
+		checkMeIn->bind (nullptr, nullptr);
+		lock_guard <mutex> lock (whichEntry->idleMutex);
+		if (whichEntry->idle.size () >= MAX_IDLE)
+			delete checkMeIn;
+		else
+			whichEntry->idle.push_back (checkMeIn);
+	});
+}
+
+MyDB_ExprCache :: Entry :: ~Entry () {
+	for (MyDB_CompiledExpr *expr : idle)
+		delete expr;
+}
+
+#endif
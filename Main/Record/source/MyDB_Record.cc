@@ -2,8 +2,12 @@
 #ifndef RECORD_CC
 #define RECORD_CC
 
+#include "MyDB_ExprCache.h"
 #include "MyDB_Record.h"
 #include "MyDB_Schema.h"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
 #include <iostream>
 #include <string.h>
 
@@ -16,12 +20,339 @@ char *MyDB_Record :: findsymbol (char val, char *input) {
 	return input + 1;
 }
 
+// a dictionary-encoded attribute (see MyDB_DictAttType in MyDB_AttType.h) computes its code; this changes
+// such a computation so that it computes the attribute's value instead.  Anything else is left alone
+static void decode (pair <valFunc, MyDB_AttTypePtr> &decodeMe) {
+	MyDB_DictionaryPtr dictionary = decodeMe.second->getDictionary ();
+	if (dictionary == nullptr)
+		return;
+	valFunc getCode = decodeMe.first;
+	decodeMe.first = [dictionary, getCode] {return dictionary->getValue (getCode ().toInt ());};
+	if (dictionary->isNumeric ())
+		decodeMe.second = make_shared <MyDB_IntAttType> ();
+	else
+		decodeMe.second = make_shared <MyDB_StringAttType> ();
+}
+
+// if both computations are attributes that are encoded using the same dictionary, returns that
+// dictionary; otherwise, returns nullptr
+static MyDB_DictionaryPtr getSharedDictionary (pair <valFunc, MyDB_AttTypePtr> &lhs, pair <valFunc, MyDB_AttTypePtr> &rhs) {
+	MyDB_DictionaryPtr dictionary = lhs.second->getDictionary ();
+	return (dictionary == rhs.second->getDictionary ()) ? dictionary : nullptr;
+}
+
 func MyDB_Record :: compileComputation (string compileMe) {
+
+	// the compiled computation produces a MyDB_Value; for compatibility, we copy the value into 
+	// an attribute of the right type (the same attribute is re-used every time it is run)
+	MyDB_CompiledExprPtr myExpr = MyDB_ExprCache :: getComputation (*this, compileMe);
+	string type = myExpr->getType ()->toString ();
+	if (type == "int") {
+		MyDB_IntAttValPtr res = make_shared <MyDB_IntAttVal> ();
+		return [myExpr, res] () -> MyDB_AttValPtr {res->set (myExpr->run ().toInt ()); return res;};
+	} else if (type == "double") {
+		MyDB_DoubleAttValPtr res = make_shared <MyDB_DoubleAttVal> ();
+		return [myExpr, res] () -> MyDB_AttValPtr {res->set (myExpr->run ().toDouble ()); return res;};
+	} else if (type == "bool") {
+		MyDB_BoolAttValPtr res = make_shared <MyDB_BoolAttVal> ();
+		return [myExpr, res] () -> MyDB_AttValPtr {res->set (myExpr->run ().toBool ()); return res;};
+	} else {
+		MyDB_StringAttValPtr res = make_shared <MyDB_StringAttVal> ();
+		return [myExpr, res] () -> MyDB_AttValPtr {res->set (myExpr->run ().toString ()); return res;};
+	}
+}
+
+function <bool ()> MyDB_Record :: compilePredicate (string compileMe) {
+	MyDB_CompiledExprPtr myExpr = MyDB_ExprCache :: getComputation (*this, compileMe);
+	return [myExpr] {return myExpr->run ().toBool ();};
+}
+
+MyDB_Value MyDB_Record :: getValue (int whichAtt) {
+	return values[whichAtt]->getValue ();
+}
+
+MyDB_Value MyDB_Record :: getDecodedValue (int whichAtt) {
+	if (dictionaries[whichAtt] == nullptr)
+		return values[whichAtt]->getValue ();
+	return dictionaries[whichAtt]->getValue (values[whichAtt]->getValue ().toInt ());
+}
+
+MyDB_CompiledExpr *MyDB_Record :: compileExpr (string compileMe) {
+
+	MyDB_CompiledExpr *returnVal = new MyDB_CompiledExpr ();
+	returnVal->bind (this, nullptr);
+
+	// compile the computation; the attributes are read from the expression's lhs slot
 	char *str = (char *) compileMe.c_str ();
-	return compileHelper (str).first;
+	auto res = compileHelper (str, returnVal->lhsRec);
+	decode (res);
+	returnVal->myFunc = res.first;
+	returnVal->myType = res.second;
+	return returnVal;
+}
+
+MyDB_CompiledExpr *MyDB_Record :: compileComparatorExpr (MyDB_Record &lhs, MyDB_Record &rhs, string computation) {
+
+	MyDB_CompiledExpr *returnVal = new MyDB_CompiledExpr ();
+	returnVal->bind (&lhs, &rhs);
+
+	// compile a computation over the LHS and over the RHS
+	char *str = (char *) computation.c_str ();
+	pair <valFunc, MyDB_AttTypePtr> lhsFunc = lhs.compileHelper (str, returnVal->lhsRec);
+
+	str = (char *) computation.c_str ();
+	pair <valFunc, MyDB_AttTypePtr> rhsFunc = rhs.compileHelper (str, returnVal->rhsRec);
+
+	// and then build a lambda that performs the comparison
+	auto res = lhs.lt (lhsFunc, rhsFunc);
+	returnVal->myFunc = res.first;
+	returnVal->myType = res.second;
+	return returnVal;
+}
+
+// skips over any white space in a computation
+static char *skipSpaces (char *vals) {
+	while (*vals == ' ' || *vals == '\t' || *vals == '\n')
+		vals++;
+	return vals;
+}
+
+// parses one operand of a simple comparison; this is either an attribute "[name]" (in which case
+// attName is set) or a constant such as "int[5]" (in which case constType and constVal are set).
+// Returns the position just past the operand, or nullptr if the operand is anything else
+static char *parseOperand (char *vals, string &attName, string &constType, string &constVal) {
+
+	vals = skipSpaces (vals);
+	if (vals[0] == '[') {
+		char *end = strchr (vals, ']');
+		if (end == nullptr)
+			return nullptr;
+		attName = string (vals + 1, end - vals - 1);
+		return end + 1;
+	}
+
+	for (string type : {"int", "double", "string"}) {
+		if (strncmp (vals, type.c_str (), type.size ()) == 0) {
+			char *start = skipSpaces (vals + type.size ());
+			char *end = strchr (start, ']');
+			if (start[0] != '[' || end == nullptr)
+				return nullptr;
+			constType = type;
+			constVal = string (start + 1, end - start - 1);
+			return end + 1;
+		}
+	}
+	return nullptr;
+}
+
+// turns a three-way comparison over the serialized bytes of one attribute (cmp returns a value that is
+// < 0, 0, or > 0) into a predicate over an entire serialized record.  If fixedOffset is not -1, the
+// attribute always starts at that offset in the record; otherwise, we find the attribute by hopping
+// over the length prefixes of the whichAtt attributes that come before it
+template <class Compare>
+static binaryPred buildBinaryPred (int whichAtt, int fixedOffset, bool ifLess, bool ifEqual, bool ifGreater, Compare cmp) {
+
+	bool accept[3] = {ifLess, ifEqual, ifGreater};
+	if (fixedOffset != -1) {
+		return [=] (void *rec) {
+			int res = cmp (((char *) rec) + fixedOffset);
+			return accept[(res > 0) - (res < 0) + 1];
+		};
+	}
+
+	return [=] (void *rec) {
+		char *loc = ((char *) rec) + sizeof (short);
+		for (int i = 0; i < whichAtt; i++)
+			loc += *((short *) loc);
+		int res = cmp (loc + sizeof (short));
+		return accept[(res > 0) - (res < 0) + 1];
+	};
+}
+
+bool MyDB_Record :: parseComparison (string computation, MyDB_SimpleComparison &intoMe) {
+
+	// figure out which comparison this is
+	char *vals = skipSpaces ((char *) computation.c_str ());
+	bool ifLess = false, ifEqual = false, ifGreater = false;
+	if (vals[0] == '=' && vals[1] == '=') {
+		ifEqual = true;
+		vals += 2;
+	} else if (vals[0] == '!' && vals[1] == '=') {
+		ifLess = ifGreater = true;
+		vals += 2;
+	} else if (vals[0] == '<') {
+		ifLess = true;
+		vals++;
+	} else if (vals[0] == '>') {
+		ifGreater = true;
+		vals++;
+	} else {
+		return false;
+	}
+
+	// now get the two operands; we need exactly one attribute and one constant
+	string attName, constType, constVal;
+	vals = skipSpaces (vals);
+	if (*vals != '(')
+		return false;
+	vals = parseOperand (vals + 1, attName, constType, constVal);
+	if (vals == nullptr)
+		return false;
+	bool constFirst = (constType != "");
+	vals = skipSpaces (vals);
+	if (*vals != ',')
+		return false;
+	vals = parseOperand (vals + 1, attName, constType, constVal);
+	if (vals == nullptr || attName == "" || constType == "")
+		return false;
+	vals = skipSpaces (vals);
+	if (*vals != ')' || *skipSpaces (vals + 1) != 0)
+		return false;
+
+	// if the constant came first, then the sense of the comparison is reversed
+	if (constFirst)
+		swap (ifLess, ifGreater);
+
+	auto whichAtt = mySchema->getAttByName (attName);
+	if (whichAtt.first == -1)
+		return false;
+
+	intoMe.whichAtt = whichAtt.first;
+	intoMe.attType = whichAtt.second->toString ();
+	intoMe.ifLess = ifLess;
+	intoMe.ifEqual = ifEqual;
+	intoMe.ifGreater = ifGreater;
+	intoMe.constType = constType;
+	intoMe.constVal = constVal;
+	return true;
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
+// finds the comma that separates the two operands of a binary operation, starting just after the
+// operation's l-paren; nested parens and the contents of constants (which can hold anything) are skipped
+static char *findOperandComma (char *vals) {
+	int depth = 0;
+	for (; *vals != 0; vals++) {
+		if (*vals == '[') {
+			vals = strchr (vals, ']');
+			if (vals == nullptr)
+				return nullptr;
+		} else if (*vals == '(') {
+			depth++;
+		} else if (*vals == ')') {
+			if (depth-- == 0)
+				return nullptr;
+		} else if (*vals == ',' && depth == 0) {
+			return vals;
+		}
+	}
+	return nullptr;
+}
+
+vector <MyDB_SimpleComparison> MyDB_Record :: getSimpleConjuncts (string computation) {
+
+	vector <MyDB_SimpleComparison> returnVal;
+	char *vals = skipSpaces ((char *) computation.c_str ());
+
+	// if this is an and, then do each side
+	if (vals[0] == '&' && vals[1] == '&') {
+		vals = skipSpaces (vals + 2);
+		if (*vals != '(')
+			return returnVal;
+		char *comma = findOperandComma (vals + 1);
+		if (comma == nullptr)
+			return returnVal;
+
+		// the second operand runs up to the r-paren that closes the and
+		char *end = (char *) computation.c_str () + computation.size ();
+		while (end > comma && *(end - 1) != ')')
+			end--;
+		if (end == comma)
+			return returnVal;
+		returnVal = getSimpleConjuncts (string (vals + 1, comma));
+		for (auto &c : getSimpleConjuncts (string (comma + 1, end - 1)))
+			returnVal.push_back (c);
+		return returnVal;
+	}
+
+	MyDB_SimpleComparison comp;
+	if (parseComparison (computation, comp))
+		returnVal.push_back (comp);
+	return returnVal;
+}
+
+binaryPred MyDB_Record :: compileBinaryPredicate (string computation) {
+
+	MyDB_SimpleComparison comp;
+	if (!parseComparison (computation, comp))
+		return nullptr;
+	bool ifLess = comp.ifLess, ifEqual = comp.ifEqual, ifGreater = comp.ifGreater;
+	string &attType = comp.attType, &constType = comp.constType, &constVal = comp.constVal;
+
+	// if all of the attributes before this one have a fixed size, then the attribute is always
+	// at the same offset in the record, and we don't need to walk the length prefixes
+	int fixedOffset = sizeof (short);
+	for (int i = 0; i < comp.whichAtt && fixedOffset != -1; i++) {
+		string type = mySchema->getAtts ()[i].second->toString ();
+		if (type == "int" || type == "dict")
+			fixedOffset += sizeof (short) + sizeof (int);
+		else if (type == "double")
+			fixedOffset += sizeof (short) + sizeof (double);
+		else
+			fixedOffset = -1;
+	}
+	if (fixedOffset != -1)
+		fixedOffset += sizeof (short);
+
+	// a dictionary-encoded attribute is compared by turning the constant into a code; this only
+	// works for == and != if the codes are not in order
+	if (attType == "dict") {
+		MyDB_DictionaryPtr dictionary = mySchema->getAtts ()[comp.whichAtt].second->getDictionary ();
+		if (dictionary->isNumeric () == (constType == "string"))
+			return nullptr;
+		MyDB_Value val = dictionary->isNumeric () ? MyDB_Value :: fromDouble (stod (constVal)) :
+			MyDB_Value :: fromString (constVal.c_str (), constVal.size ());
+		int code;
+		if (!dictionary->translateComparison (val, ifLess, ifEqual, ifGreater, code))
+			return nullptr;
+		return buildBinaryPred (comp.whichAtt, fixedOffset, ifLess, ifEqual, ifGreater, [code] (char *data) {
+			int myCode = *((int *) data);
+			return (myCode > code) - (myCode < code);
+		});
+	}
+
+	// now build the comparison, using the same type promotion rules as compileComputation
+	if (attType == "int" && constType == "int") {
+		int val = stoi (constVal);
+		return buildBinaryPred (comp.whichAtt, fixedOffset, ifLess, ifEqual, ifGreater, [val] (char *data) {
+			int myVal = *((int *) data);
+			return (myVal > val) - (myVal < val);
+		});
+
+	} else if (attType == "int" && constType == "double") {
+		double val = stod (constVal);
+		return buildBinaryPred (comp.whichAtt, fixedOffset, ifLess, ifEqual, ifGreater, [val] (char *data) {
+			double myVal = *((int *) data);
+			return (myVal > val) - (myVal < val);
+		});
+
+	} else if (attType == "double" && constType != "string") {
+		double val = stod (constVal);
+		return buildBinaryPred (comp.whichAtt, fixedOffset, ifLess, ifEqual, ifGreater, [val] (char *data) {
+			double myVal = *((double *) data);
+			return (myVal > val) - (myVal < val);
+		});
+
+	} else if (attType == "string" && constType == "string") {
+		return buildBinaryPred (comp.whichAtt, fixedOffset, ifLess, ifEqual, ifGreater, [constVal] (char *data) {
+			return strcmp (data, constVal.c_str ());
+		});
+	}
+
+	// anything else (for example, bools, or mixing strings with numbers) is not handled
+	return nullptr;
+}
+
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: compileHelper (char * &vals, shared_ptr <MyDB_Record *> &boundRec) {
 	
 	// search for one of the infix symbols
 	while (true) {
@@ -38,13 +369,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, boundRec);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -59,7 +390,7 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the result
-			auto res = compileHelper (vals);
+			auto res = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -74,13 +405,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, boundRec);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -95,13 +426,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, boundRec);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -116,13 +447,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, boundRec);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -137,13 +468,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, boundRec);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -158,13 +489,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, boundRec);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -179,13 +510,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, boundRec);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -200,13 +531,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, boundRec);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -221,13 +552,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, boundRec);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -242,13 +573,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, boundRec);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -263,7 +594,7 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the result
-			auto res = compileHelper (vals);
+			auto res = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -278,13 +609,13 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol ('(', vals);
 
 			// find the left result
-			auto lres = compileHelper (vals);
+			auto lres = compileHelper (vals, boundRec);
 			
 			// and the comma
 			vals = findsymbol (',', vals);
 
 			// find the right result
-			auto rres = compileHelper (vals);
+			auto rres = compileHelper (vals, boundRec);
 			
 			// find the r-paren
 			vals = findsymbol (')', vals);
@@ -310,7 +641,7 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			vals = findsymbol (']', vals);
 	
 			// and get that attribute
-			return fromData (name);		
+			return fromData (name, boundRec);		
 
 		} else if (strncmp (vals, "int", 3) == 0) {
 
@@ -318,12 +649,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			int val = stoi (vals);
 			vals = findsymbol (']', vals);
 
-			// remember this value
-			MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-			scratch.push_back (temp);
-			temp->set (val);
-
 			// returns a lambda that computes the result
+			MyDB_Value temp = MyDB_Value :: fromInt (val);
 			return make_pair ([temp] {return temp;}, make_shared <MyDB_IntAttType> ());
 
 		} else if (strncmp (vals, "double", 6) == 0) {
@@ -332,12 +659,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			double val = stod (vals);
 			vals = findsymbol (']', vals);
 
-			// remember this value
-			MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-			scratch.push_back (temp);
-			temp->set (val);
-
 			// returns a lambda that computes the result
+			MyDB_Value temp = MyDB_Value :: fromDouble (val);
 			return make_pair ([temp] {return temp;}, make_shared <MyDB_DoubleAttType> ());
 
 		} else if (strncmp (vals, "bool", 4) == 0) {
@@ -349,12 +672,8 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			}
 			vals = findsymbol (']', vals);
 
-			// remember this value
-			MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-			scratch.push_back (temp);
-			temp->set (val);
-
 			// returns a lambda that computes the result
+			MyDB_Value temp = MyDB_Value :: fromBool (val);
 			return make_pair ([temp] {return temp;}, make_shared <MyDB_BoolAttType> ());
 
 		} else if (strncmp (vals, "string", 6) == 0) {
@@ -365,23 +684,15 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 			int cnt = 0;
 			for (; vals[cnt] != ']'; cnt++);
 
-			// copy the string over
-			char name[cnt];
-			for (cnt = 0; vals[cnt] != ']'; cnt++) {
-				name[cnt] = vals[cnt];
-			}	
-			name[cnt] = 0;
+			// remember this value; the lambda owns the characters that the value points to
+			shared_ptr <string> temp = make_shared <string> (vals, cnt);
 
 			// find the ]
 			vals = findsymbol (']', vals);
-	
-			// remember this value
-			MyDB_StringAttValPtr temp = make_shared <MyDB_StringAttVal> ();
-			scratch.push_back (temp);
-			temp->set (name);
 
 			// returns a lambda that computes the result
-			return make_pair ([temp] {return temp;}, make_shared <MyDB_StringAttType> ());
+			return make_pair ([temp] {return MyDB_Value :: fromString (temp->c_str (), temp->size ());}, 
+				make_shared <MyDB_StringAttType> ());
 			
 		} else {
 			vals++;
@@ -389,41 +700,39 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: compileHelper(char * &vals) {
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: fromData (string attName) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: fromData (string attName, shared_ptr <MyDB_Record *> &boundRec) {
 
-	// just return a particular attribute
+	// just return a particular attribute of whatever record is bound to the computation
 	auto whichAtt = mySchema->getAttByName (attName);
-	return make_pair ([this, whichAtt] {return values[whichAtt.first];}, whichAtt.second);		
+	return make_pair ([boundRec, whichAtt] {return (*boundRec)->values[whichAtt.first]->getValue ();}, whichAtt.second);		
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: plus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: plus (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs) {
+
+	decode (lhs);
+	decode (rhs);
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () + rhs.first ()->toInt ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromInt (lhs.first ().toInt () + rhs.first ().toInt ());},
 			make_shared <MyDB_IntAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () + rhs.first ()->toDouble ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromDouble (lhs.first ().toDouble () + rhs.first ().toDouble ());},
 			make_shared <MyDB_DoubleAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be strings, then do so
 	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_StringAttValPtr temp = make_shared <MyDB_StringAttVal> ();
-		scratch.push_back (temp);
+		shared_ptr <string> temp = make_shared <string> ();
 
-		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () + rhs.first ()->toString ()); return temp;},
-			make_shared <MyDB_StringAttType> ());
+		// returns a lambda that computes the result; the result points into temp
+		return make_pair ([temp, lhs, rhs] {
+				*temp = lhs.first ().toString () + rhs.first ().toString (); 
+				return MyDB_Value :: fromString (temp->c_str (), temp->size ());
+			}, make_shared <MyDB_StringAttType> ());
 
 	} else {
 		cout << "This is bad... cannot do anything with the plus.\n";
@@ -431,24 +740,21 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: plus (pair <func, MyDB_AttTypePtr> l
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: minus (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: minus (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs) {
+
+	decode (lhs);
+	decode (rhs);
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () - rhs.first ()->toInt ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromInt (lhs.first ().toInt () - rhs.first ().toInt ());},
 			make_shared <MyDB_IntAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () - rhs.first ()->toDouble ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromDouble (lhs.first ().toDouble () - rhs.first ().toDouble ());},
 			make_shared <MyDB_DoubleAttType> ());
 	
 	} else {
@@ -457,24 +763,20 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: minus (pair <func, MyDB_AttTypePtr>
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: unaryMinus (pair <func, MyDB_AttTypePtr> lhs) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: unaryMinus (pair <valFunc, MyDB_AttTypePtr> lhs) {
+
+	decode (lhs);
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs] {temp->set (-lhs.first ()->toInt ()); return temp;},
+		return make_pair ([lhs] {return MyDB_Value :: fromInt (-lhs.first ().toInt ());},
 			make_shared <MyDB_IntAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs] {temp->set (-lhs.first ()->toDouble ()); return temp;},
+		return make_pair ([lhs] {return MyDB_Value :: fromDouble (-lhs.first ().toDouble ());},
 			make_shared <MyDB_DoubleAttType> ());
 	
 	} else {
@@ -483,24 +785,21 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: unaryMinus (pair <func, MyDB_AttType
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: times (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: times (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs) {
+
+	decode (lhs);
+	decode (rhs);
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () * rhs.first ()->toInt ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromInt (lhs.first ().toInt () * rhs.first ().toInt ());},
 			make_shared <MyDB_IntAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () * rhs.first ()->toDouble ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromDouble (lhs.first ().toDouble () * rhs.first ().toDouble ());},
 			make_shared <MyDB_DoubleAttType> ());
 
 	} else {
@@ -509,24 +808,21 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: times (pair <func, MyDB_AttTypePtr>
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: divide (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: divide (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs) {
+
+	decode (lhs);
+	decode (rhs);
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_IntAttValPtr temp = make_shared <MyDB_IntAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () / rhs.first ()->toInt ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromInt (lhs.first ().toInt () / rhs.first ().toInt ());},
 			make_shared <MyDB_IntAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_DoubleAttValPtr temp = make_shared <MyDB_DoubleAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () / rhs.first ()->toDouble ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromDouble (lhs.first ().toDouble () / rhs.first ().toDouble ());},
 			make_shared <MyDB_DoubleAttType> ());
 
 	} else {
@@ -535,33 +831,32 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: divide (pair <func, MyDB_AttTypePtr>
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: gt (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: gt (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs) {
+
+	// two attributes with the same dictionary can be compared using their codes
+	MyDB_DictionaryPtr dictionary = getSharedDictionary (lhs, rhs);
+	if (dictionary != nullptr)
+		return make_pair ([lhs, rhs, dictionary] {return MyDB_Value :: fromBool (dictionary->compare (lhs.first ().toInt (), rhs.first ().toInt ()) > 0);},
+			make_shared <MyDB_BoolAttType> ());
+	decode (lhs);
+	decode (rhs);
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () > rhs.first ()->toInt ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().toInt () > rhs.first ().toInt ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () > rhs.first ()->toDouble ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().toDouble () > rhs.first ().toDouble ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be strings, then do so
 	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () > rhs.first ()->toString ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().compareAsStrings (rhs.first ()) > 0);},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else {
@@ -570,33 +865,31 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: gt (pair <func, MyDB_AttTypePtr> lhs
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: lt (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: lt (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs) {
+
+	MyDB_DictionaryPtr dictionary = getSharedDictionary (lhs, rhs);
+	if (dictionary != nullptr)
+		return make_pair ([lhs, rhs, dictionary] {return MyDB_Value :: fromBool (dictionary->compare (lhs.first ().toInt (), rhs.first ().toInt ()) < 0);},
+			make_shared <MyDB_BoolAttType> ());
+	decode (lhs);
+	decode (rhs);
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () < rhs.first ()->toInt ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().toInt () < rhs.first ().toInt ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () < rhs.first ()->toDouble ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().toDouble () < rhs.first ().toDouble ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be strings, then do so
 	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () < rhs.first ()->toString ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().compareAsStrings (rhs.first ()) < 0);},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else {
@@ -605,41 +898,36 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: lt (pair <func, MyDB_AttTypePtr> lhs
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: eq (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: eq (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs) {
+
+	MyDB_DictionaryPtr dictionary = getSharedDictionary (lhs, rhs);
+	if (dictionary != nullptr)
+		return make_pair ([lhs, rhs, dictionary] {return MyDB_Value :: fromBool (lhs.first ().toInt () == rhs.first ().toInt ());},
+			make_shared <MyDB_BoolAttType> ());
+	decode (lhs);
+	decode (rhs);
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () == rhs.first ()->toInt ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().toInt () == rhs.first ().toInt ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () == rhs.first ()->toDouble ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().toDouble () == rhs.first ().toDouble ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () == rhs.first ()->toBool ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().toBool () == rhs.first ().toBool ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be strings, then do so
 	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () == rhs.first ()->toString ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().compareAsStrings (rhs.first ()) == 0);},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else {
@@ -648,41 +936,36 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: eq (pair <func, MyDB_AttTypePtr> lhs
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: neq (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: neq (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs) {
+
+	MyDB_DictionaryPtr dictionary = getSharedDictionary (lhs, rhs);
+	if (dictionary != nullptr)
+		return make_pair ([lhs, rhs, dictionary] {return MyDB_Value :: fromBool (lhs.first ().toInt () != rhs.first ().toInt ());},
+			make_shared <MyDB_BoolAttType> ());
+	decode (lhs);
+	decode (rhs);
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->promotableToInt () && rhs.second->promotableToInt ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toInt () != rhs.first ()->toInt ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().toInt () != rhs.first ().toInt ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () != rhs.first ()->toBool ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().toBool () != rhs.first ().toBool ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be doubles, then do so
 	} else if (lhs.second->promotableToDouble () && rhs.second->promotableToDouble ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toDouble () != rhs.first ()->toDouble ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().toDouble () != rhs.first ().toDouble ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	// otherwise, if both sides can be cast upwards to be strings, then do so
 	} else if (lhs.second->promotableToString () && rhs.second->promotableToString ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toString () != rhs.first ()->toString ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().compareAsStrings (rhs.first ()) != 0);},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else {
@@ -691,15 +974,15 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: neq (pair <func, MyDB_AttTypePtr> lh
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: orr (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: orr (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs) {
+
+	decode (lhs);
+	decode (rhs);
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () || rhs.first ()->toBool ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().toBool () || rhs.first ().toBool ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else {
@@ -708,15 +991,15 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: orr (pair <func, MyDB_AttTypePtr> lh
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: andd (pair <func, MyDB_AttTypePtr> lhs, pair <func, MyDB_AttTypePtr> rhs) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: andd (pair <valFunc, MyDB_AttTypePtr> lhs, pair <valFunc, MyDB_AttTypePtr> rhs) {
+
+	decode (lhs);
+	decode (rhs);
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->isBool () && rhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs, rhs] {temp->set (lhs.first ()->toBool () && rhs.first ()->toBool ()); return temp;},
+		return make_pair ([lhs, rhs] {return MyDB_Value :: fromBool (lhs.first ().toBool () && rhs.first ().toBool ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else {
@@ -725,15 +1008,14 @@ pair <func, MyDB_AttTypePtr> MyDB_Record :: andd (pair <func, MyDB_AttTypePtr> l
 	}
 }
 
-pair <func, MyDB_AttTypePtr> MyDB_Record :: nott (pair <func, MyDB_AttTypePtr> lhs) {
+pair <valFunc, MyDB_AttTypePtr> MyDB_Record :: nott (pair <valFunc, MyDB_AttTypePtr> lhs) {
+
+	decode (lhs);
 
 	// if both sides can be cast upwards to be ints, then do so
 	if (lhs.second->isBool ()) {
-		MyDB_BoolAttValPtr temp = make_shared <MyDB_BoolAttVal> ();
-		scratch.push_back (temp);
-
 		// returns a lambda that computes the result
-		return make_pair ([temp, lhs] {temp->set (!lhs.first ()->toBool ()); return temp;},
+		return make_pair ([lhs] {return MyDB_Value :: fromBool (!lhs.first ().toBool ());},
 			make_shared <MyDB_BoolAttType> ());
 
 	} else {
@@ -755,6 +1037,15 @@ void MyDB_Record :: recordContentHasChanged () {
 }
 
 void MyDB_Record :: writeAttsToBuffer () {
+
+	// any attribute that still points into our buffer (because it was loaded with fromBinary) 
+	// needs to copy its value out first, since we are about to overwrite the buffer
+	for (MyDB_AttValPtr &temp : values) {
+		char *data = (char *) temp->getDataPointer ();
+		if (data >= buffer && data < buffer + allocatedSize)
+			temp->set (temp);
+	}
+
 	recSize = sizeof (short);
 	for (MyDB_AttValPtr temp : values) {
 		temp->serialize (buffer, allocatedSize, recSize);
@@ -809,6 +1100,111 @@ void MyDB_Record :: fromString (string res) {
 	bufferOld = true;
 }
 
+// these parse a numeric field for fromText, which has been copied into number (or, if it was too long
+// to be a number, cut off there); a field that is not a number is reported, along with the attribute
+static void badNumber (const char *number, const string &attName) {
+	cout << "Oops!  Bad number \"" << number << "\" for attribute " << attName << "\n";
+	exit (1);
+}
+
+static int parseInt (const char *number, size_t len, const string &attName) {
+	char *numberEnd;
+	errno = 0;
+	long val = strtol (number, &numberEnd, 10);
+	if (len == 0 || *numberEnd != 0 || errno == ERANGE || val < INT_MIN || val > INT_MAX)
+		badNumber (number, attName);
+	return (int) val;
+}
+
+static double parseDouble (const char *number, size_t len, const string &attName) {
+	char *numberEnd;
+	errno = 0;
+	double val = strtod (number, &numberEnd);
+	if (len == 0 || *numberEnd != 0 || errno == ERANGE)
+		badNumber (number, attName);
+	return val;
+}
+
+void MyDB_Record :: fromText (const char *start, const char *end) {
+
+	// make sure there is enough room in the buffer; the serialized record can't be bigger than
+	// the text plus a short, a null, and at most eight bytes of binary number per attribute
+	size_t maxSize = sizeof (short) + (end - start) + values.size () * (sizeof (short) + sizeof (double) + 1);
+	if (maxSize > allocatedSize) {
+		delete [] buffer;
+		buffer = new char[maxSize * 2];
+		allocatedSize = maxSize * 2;
+	}
+
+	char *loc = buffer + sizeof (short);
+	const char *pos = start;
+	for (size_t i = 0; i < attTypes.size (); i++) {
+		MyDB_ValueType type = attTypes[i];
+
+		// find the end of the field
+		const char *fieldEnd = (const char *) memchr (pos, '|', end - pos);
+		if (fieldEnd == nullptr)
+			fieldEnd = end;
+		size_t len = fieldEnd - pos;
+
+		// numbers are copied out so that strtol and strtod see a null-terminated field
+		char number[64];
+		bool isNumber = (dictionaries[i] == nullptr) ? (type != MyDB_ValueType :: StringVal && type != MyDB_ValueType :: BoolVal) :
+			dictionaries[i]->isNumeric ();
+		const string &attName = mySchema->getAtts ()[i].first;
+		if (isNumber) {
+			size_t numberLen = len < sizeof (number) ? len : sizeof (number) - 1;
+			memcpy (number, pos, numberLen);
+			number[numberLen] = 0;
+			if (numberLen != len)
+				badNumber (number, attName);
+		}
+
+		// a dictionary-encoded attribute holds the code of the value (which is added if it is new)
+		if (dictionaries[i] != nullptr) {
+			MyDB_Value val = dictionaries[i]->isNumeric () ? MyDB_Value :: fromInt (parseInt (number, len, attName)) :
+				MyDB_Value :: fromString (pos, len);
+			int code = dictionaries[i]->getCode (val);
+			if (code == -1)
+				code = dictionaries[i]->addValue (val);
+			*((short *) loc) = (short) (sizeof (short) + sizeof (int));
+			*((int *) (loc + sizeof (short))) = code;
+		} else if (type == MyDB_ValueType :: IntVal) {
+			*((short *) loc) = (short) (sizeof (short) + sizeof (int));
+			*((int *) (loc + sizeof (short))) = parseInt (number, len, attName);
+		} else if (type == MyDB_ValueType :: DoubleVal) {
+			*((short *) loc) = (short) (sizeof (short) + sizeof (double));
+			*((double *) (loc + sizeof (short))) = parseDouble (number, len, attName);
+		} else if (type == MyDB_ValueType :: BoolVal) {
+			if (len == 4 && memcmp (pos, "true", 4) == 0) {
+				*(loc + sizeof (short)) = 1;
+			} else if (len == 5 && memcmp (pos, "false", 5) == 0) {
+				*(loc + sizeof (short)) = 0;
+			} else {
+				cout << "Oops!  Bad string for boolean\n";
+				exit (1);
+			}
+			*((short *) loc) = (short) (sizeof (short) + sizeof (char));
+		} else {
+			*((short *) loc) = (short) (sizeof (short) + len + 1);
+			memcpy (loc + sizeof (short), pos, len);
+			*(loc + sizeof (short) + len) = 0;
+		}
+		loc += *((short *) loc);
+		pos = (fieldEnd == end) ? end : fieldEnd + 1;
+	}
+
+	recSize = loc - buffer;
+	*((short *) buffer) = (short) recSize;
+
+	// and set up the attributes
+	char *recLoc = buffer + sizeof (short);
+	for (MyDB_AttValPtr &temp : values) {
+		recLoc = temp->fromBinary (recLoc);
+	}		
+	bufferOld = false;
+}
+
 std::ostream& operator<<(std::ostream& os, const MyDB_Record printMe) {
 	for (MyDB_AttValPtr temp : printMe.values) {
 		os << temp->toString () << "|";
@@ -827,17 +1223,9 @@ std::ostream& operator<<(std::ostream& os, const MyDB_RecordPtr printMe) {
 
 function <bool ()> buildRecordComparator (MyDB_RecordPtr lhs,  MyDB_RecordPtr rhs, string computation) {
 
-	// compile a computation over the LHS and over the RHS
-	char *str = (char *) computation.c_str ();
-	pair <func, MyDB_AttTypePtr> lhsFunc = lhs->compileHelper (str);
-
-	str = (char *) computation.c_str ();
-	pair <func, MyDB_AttTypePtr> rhsFunc = rhs->compileHelper (str);
-
-	// and then build a lambda that performs the computatation
-	auto res = lhs->lt (lhsFunc, rhsFunc);
-	func temp = res.first;
-	return [=] {return temp ()->toBool ();};
+	// get a compiled comparator over the two records; this is usually a cache hit
+	MyDB_CompiledExprPtr myExpr = MyDB_ExprCache :: getComparator (*lhs, *rhs, computation);
+	return [myExpr] {return myExpr->run ().toBool ();};
 	
 }
 
@@ -854,6 +1242,8 @@ MyDB_Record :: MyDB_Record (MyDB_SchemaPtr mySchemaIn) {
 
 	for (auto &val : mySchema->getAtts ()) {
 		values.push_back (val.second->createAtt ());	
+		attTypes.push_back (values.back ()->getValueType ());
+		dictionaries.push_back (val.second->getDictionary ());
 	}
 }
 
@@ -874,6 +1264,10 @@ void MyDB_Record :: buildFrom (MyDB_RecordPtr left, MyDB_RecordPtr right) {
                 newValues.push_back (v);
         }
         values = newValues;
+	attTypes = left->attTypes;
+	attTypes.insert (attTypes.end (), right->attTypes.begin (), right->attTypes.end ());
+	dictionaries = left->dictionaries;
+	dictionaries.insert (dictionaries.end (), right->dictionaries.begin (), right->dictionaries.end ());
 }
 
 MyDB_Record :: ~MyDB_Record () {
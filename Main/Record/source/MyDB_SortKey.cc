@@ -0,0 +1,88 @@
+
+#ifndef SORT_KEY_C
+#define SORT_KEY_C
+
+#include <iostream>
+#include "MyDB_SortKey.h"
+
+using namespace std;
+
+MyDB_SortKey :: MyDB_SortKey (MyDB_SchemaPtr mySchema, vector <string> sortAttsIn) {
+	for (string &att : sortAttsIn) {
+		auto whichAtt = mySchema->getAttByName (att);
+		sortAtts.push_back (make_pair (whichAtt.first, whichAtt.second->toString ()));
+		dictionaries.push_back (whichAtt.second->getDictionary ());
+	}
+}
+
+// flip the sign bit so that negative numbers come first, and write big-endian
+static void appendInt (int val, string &intoMe) {
+	char bytes[4];
+	uint32_t bits = ((uint32_t) val) ^ 0x80000000u;
+	for (int i = 3; i >= 0; i--, bits >>= 8)
+		bytes[i] = (char) (bits & 0xff);
+	intoMe.append (bytes, 4);
+}
+
+void MyDB_SortKey :: encode (void *serializedRec, string &intoMe) {
+	intoMe.clear ();
+	appendKey (serializedRec, intoMe);
+}
+
+void MyDB_SortKey :: appendKey (void *serializedRec, string &intoMe) {
+
+	for (size_t which = 0; which < sortAtts.size (); which++) {
+		auto &att = sortAtts[which];
+
+		// find the attribute by hopping over the length prefixes of the ones before it
+		char *loc = ((char *) serializedRec) + sizeof (short);
+		for (int i = 0; i < att.first; i++)
+			loc += *((short *) loc);
+		short len = *((short *) loc);
+		loc += sizeof (short);
+
+		char bytes[8];
+		if (att.second == "int") {
+			appendInt (*((int *) loc), intoMe);
+
+		// if the codes are in order, they sort just like the values do
+		} else if (att.second == "dict") {
+			MyDB_DictionaryPtr &dictionary = dictionaries[which];
+			int code = *((int *) loc);
+			if (dictionary->isOrdered ()) {
+				appendInt (code, intoMe);
+			} else if (dictionary->isNumeric ()) {
+				appendInt (dictionary->getValue (code).toInt (), intoMe);
+			} else {
+				MyDB_Value val = dictionary->getValue (code);
+				intoMe.append (val.getChars (), val.getLength () + 1);
+			}
+
+		} else if (att.second == "double") {
+
+			// for a positive number, flip the sign bit; for a negative one, flip all of the bits, so that
+			// more negative numbers come first.  -0.0 is treated as 0.0, since the two are equal
+			double val = *((double *) loc);
+			uint64_t bits = 0;
+			if (val != 0.0)
+				memcpy (&bits, &val, sizeof (double));
+			if (bits & 0x8000000000000000ull)
+				bits = ~bits;
+			else
+				bits ^= 0x8000000000000000ull;
+			for (int i = 7; i >= 0; i--, bits >>= 8)
+				bytes[i] = (char) (bits & 0xff);
+			intoMe.append (bytes, 8);
+
+		} else if (att.second == "bool") {
+			intoMe.push_back (*loc != 0 ? 1 : 0);
+
+		// a string is already stored with a zero byte at the end, and can't contain a zero byte,
+		// so a string that is a prefix of another one comes first
+		} else {
+			intoMe.append (loc, len - sizeof (short));
+		}
+	}
+}
+
+#endif
@@ -5,6 +5,8 @@
 #include "MyDB_AttType.h"  
 #include "MyDB_BufferManager.h"
 #include "MyDB_Catalog.h"  
+#include "MyDB_ColumnIterator.h"
+#include "MyDB_CompressedFile.h"
 #include "MyDB_Page.h"
 #include "MyDB_PageReaderWriter.h"
 #include "MyDB_Record.h"
@@ -12,8 +14,13 @@
 #include "MyDB_TableReaderWriter.h"
 #include "MyDB_Schema.h"
 #include "QUnit.h"
+#include "Sorting.h"
 #include <cstring>
+#include <fcntl.h>
+#include <fstream>
 #include <iostream>
+#include <sstream>
+#include <thread>
 #include <time.h>
 #include <unistd.h>
 #include <vector>
@@ -463,6 +470,1156 @@ int main(int argc, char *argv[]) {
 		QUNIT_IS_FALSE(result);
 	}
 	FALLTHROUGH_INTENDED;
+	case 10:
+	{
+		// compiled computations are cached and re-bound to new records
+		cout << "TEST 10..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+
+			cout << "create TableReaderWriter..." << flush;
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+
+			cout << "compile repeatedly..." << flush;
+			for (int i = 0; i < 100; i++) {
+				MyDB_RecordPtr lhs = supplierTable.getEmptyRecord();
+				MyDB_RecordPtr rhs = supplierTable.getEmptyRecord();
+				lhs->fromString(to_string(i) + "|a|b|1|c|2.5|d|");
+				rhs->fromString(to_string(i + 1) + "|a|b|1|c|2.5|d|");
+				function <bool ()> comp = buildRecordComparator(lhs, rhs, "[suppkey]");
+				function <bool ()> revComp = buildRecordComparator(rhs, lhs, "[suppkey]");
+				func plusOne = lhs->compileComputation("+ ([suppkey], int[1])");
+				if (!comp() || revComp() || plusOne()->toInt() != i + 1)
+					result = false;
+			}
+
+			// the cache can be used from many threads at once
+			cout << "compile in threads..." << flush;
+			vector <thread> workers;
+			vector <int> failures(4, 0);
+			for (int t = 0; t < 4; t++) {
+				workers.push_back(thread([&supplierTable, &failures, t] {
+					for (int i = 0; i < 200; i++) {
+						MyDB_RecordPtr lhs = supplierTable.getEmptyRecord();
+						MyDB_RecordPtr rhs = supplierTable.getEmptyRecord();
+						lhs->fromString(to_string(i) + "|a|b|1|c|2.5|d|");
+						rhs->fromString(to_string(i + t) + "|a|b|1|c|2.5|d|");
+						func plusT = lhs->compileComputation("+ ([suppkey], int[" + to_string(t) + "])");
+						function <bool ()> comp = buildRecordComparator(rhs, lhs, "[suppkey]");
+						if (plusT()->toInt() != i + t || comp())
+							failures[t]++;
+					}
+				}));
+			}
+			for (thread &worker : workers)
+				worker.join();
+			for (int failed : failures)
+				result = result && (failed == 0);
+
+			// a schema that changes gets a new ID, so its expressions are compiled again
+			cout << "change schema..." << flush;
+			MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema>();
+			mySchema->appendAtt(make_pair("a", make_shared <MyDB_IntAttType>()));
+			size_t oldID = mySchema->getID();
+			MyDB_RecordPtr rec = make_shared <MyDB_Record>(mySchema);
+			rec->fromString("7|");
+			result = result && (rec->compileComputation("[a]")()->toInt() == 7);
+			mySchema->getAtts().insert(mySchema->getAtts().begin(), make_pair("b", make_shared <MyDB_IntAttType>()));
+			mySchema->appendAtt(make_pair("c", make_shared <MyDB_IntAttType>()));
+			rec = make_shared <MyDB_Record>(mySchema);
+			rec->fromString("1|8|2|");
+			result = result && (mySchema->getID() != oldID) && (rec->compileComputation("[a]")()->toInt() == 8);
+
+			cout << "shutdown manager..." << flush;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 11:
+	{
+		// predicates evaluated over the serialized records agree with compiled computations
+		cout << "TEST 11..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+
+			cout << "create TableReaderWriter..." << flush;
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+
+			vector <string> preds = {"< ([suppkey], int[100])", "> ([acctbal], double[4000.0])",
+				"== (string[Supplier#000000007], [name])", "!= ([nationkey], int[3])",
+				"> (int[50], [suppkey])", "< ([acctbal], int[0])",
+				"&& (> ([suppkey], int[10]), < ([suppkey], int[20]))"};
+
+			cout << "check predicates..." << flush;
+			for (string &pred : preds) {
+
+				// count the hard way
+				int expected = 0;
+				func f = temp->compileComputation(pred);
+				MyDB_RecordIteratorPtr myIter = supplierTable.getIterator(temp);
+				while (myIter->hasNext()) {
+					myIter->getNext();
+					if (f()->toBool())
+						expected++;
+				}
+
+				// and with the filtered iterator
+				int counter = 0;
+				MyDB_RecordIteratorAltPtr filtered = supplierTable.getIteratorAlt(pred);
+				while (filtered->advance()) {
+					filtered->getCurrent(temp);
+					if (!f()->toBool())
+						result = false;
+					counter++;
+				}
+
+				if (counter != expected || expected == 0)
+					result = false;
+			}
+
+			// only the simple comparisons have a fast path
+			if (temp->compileBinaryPredicate(preds[0]) == nullptr || 
+				temp->compileBinaryPredicate(preds[6]) != nullptr)
+				result = false;
+
+			cout << "shutdown manager..." << flush;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 12:
+	{
+		// typed records read and write the same format as ordinary records
+		cout << "TEST 12..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+
+			cout << "create TableReaderWriter..." << flush;
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+
+			typedef MyDB_TypedRecord <int, string, string, int, string, double, string> SupplierRec;
+			SupplierRec typed;
+			if (!SupplierRec::matches(allTables["supplier"]->getSchema()))
+				result = false;
+
+			cout << "append typed record..." << flush;
+			typed.fromString("10001|Supplier#000010001|00000000|999|12-345-678-9012|1234.56|the special record|");
+			supplierTable.append(typed);
+
+			cout << "compare records..." << flush;
+			int counter = 0;
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt();
+			while (myIter->advance()) {
+				myIter->getCurrent(temp);
+				myIter->getCurrent(typed);
+				stringstream lhs, rhs;
+				lhs << temp;
+				rhs << typed;
+				if (lhs.str() != rhs.str() || temp->getBinarySize() != typed.getBinarySize() ||
+					typed.getAtt <0> () != temp->getAtt(0)->toInt() ||
+					typed.getAtt <5> () != temp->getAtt(5)->toDouble())
+					result = false;
+				counter++;
+			}
+			if (counter != 10001 || typed.getAtt <6> () != "the special record")
+				result = false;
+
+			cout << "shutdown manager..." << flush;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 13:
+	{
+		// attribute values can be read without allocation, both from pages and from parsed records
+		cout << "TEST 13..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+
+			cout << "create TableReaderWriter..." << flush;
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			MyDB_RecordPtr parsed = supplierTable.getEmptyRecord();
+			function <bool ()> isFirst = temp->compilePredicate("== ([name], string[Supplier#000000001])");
+			func renamed = temp->compileComputation("+ ([name], string[!])");
+
+			cout << "compare values..." << flush;
+			int matches = 0;
+			MyDB_RecordIteratorPtr myIter = supplierTable.getIterator(temp);
+			while (myIter->hasNext()) {
+				myIter->getNext();
+				stringstream ss;
+				ss << temp;
+				parsed->fromString(ss.str());
+				for (int i = 0; i < 7; i++) {
+					if (temp->getValue(i).toString() != temp->getAtt(i)->toString() ||
+						parsed->getValue(i).toString() != temp->getAtt(i)->toString())
+						result = false;
+				}
+				if (isFirst())
+					matches++;
+				if (renamed()->toString() != temp->getAtt(1)->toString() + "!")
+					result = false;
+			}
+			if (matches != 1)
+				result = false;
+
+			// each kind of value converts as an attribute of that type does
+			cout << "conversions..." << flush;
+			MyDB_Value intVal = MyDB_Value::fromInt(-7), doubleVal = MyDB_Value::fromDouble(2.5), boolVal = MyDB_Value::fromBool(true);
+			if (intVal.toDouble() != -7.0 || doubleVal.toInt() != 2 || doubleVal.toDouble() != 2.5 || !boolVal.toBool() ||
+				boolVal.toString() != "true")
+				result = false;
+
+			cout << "shutdown manager..." << flush;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 14:
+	{
+		// string attributes hash, copy, and re-serialize correctly without going through std::string
+		cout << "TEST 14..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+
+			cout << "create TableReaderWriter..." << flush;
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			MyDB_RecordPtr other = supplierTable.getEmptyRecord();
+
+			cout << "check strings..." << flush;
+			MyDB_RecordIteratorPtr myIter = supplierTable.getIterator(temp);
+			while (myIter->hasNext()) {
+				myIter->getNext();
+
+				// a parsed copy of the string must hash the same as the one in the page
+				MyDB_StringAttValPtr parsed = make_shared <MyDB_StringAttVal>();
+				parsed->set(temp->getAtt(6)->toString());
+				MyDB_AttValPtr copy = temp->getAtt(6)->getCopy();
+				if (parsed->hash() != temp->getAtt(6)->hash() || copy->toString() != parsed->toString())
+					result = false;
+
+				// serialize the record after changing the name, and read it back
+				char bytes[1024];
+				string expected = "changed " + temp->getAtt(1)->toString();
+				temp->getAtt(1)->set(make_shared <MyDB_StringAttVal>());
+				static_pointer_cast <MyDB_StringAttVal>(temp->getAtt(1))->set(expected);
+				temp->recordContentHasChanged();
+				temp->toBinary(bytes);
+				other->fromBinary(bytes);
+				if (other->getAtt(1)->toString() != expected || other->getAtt(6)->toString() != parsed->toString())
+					result = false;
+			}
+
+			cout << "shutdown manager..." << flush;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 15:
+	{
+		// the multi-threaded loader gives exactly the same table as the one-threaded one
+		cout << "TEST 15..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "create manager..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+
+			cout << "create TableReaderWriter..." << flush;
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_TablePtr parTable = make_shared <MyDB_Table>("supplierPar", "supplierPar.bin", 
+				allTables["supplier"]->getSchema());
+			MyDB_TableReaderWriter parallelTable(parTable, myMgr);
+
+			cout << "load in parallel..." << flush;
+			auto seqResult = supplierTable.loadFromTextFile("supplier.tbl");
+			auto parResult = parallelTable.loadFromTextFile("supplier.tbl", 3);
+			if (seqResult != parResult || supplierTable.getNumPages() != parallelTable.getNumPages())
+				result = false;
+
+			cout << "compare records..." << flush;
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			MyDB_RecordPtr other = parallelTable.getEmptyRecord();
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt();
+			MyDB_RecordIteratorAltPtr otherIter = parallelTable.getIteratorAlt();
+			int counter = 0;
+			while (myIter->advance()) {
+				if (!otherIter->advance()) {
+					result = false;
+					break;
+				}
+				myIter->getCurrent(temp);
+				otherIter->getCurrent(other);
+				ostringstream lhs, rhs;
+				lhs << temp;
+				rhs << other;
+				if (lhs.str() != rhs.str())
+					result = false;
+				counter++;
+			}
+			if (otherIter->advance() || counter != 10000)
+				result = false;
+
+			cout << "shutdown manager..." << flush;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 16:
+	{
+		// fromText parses to exactly the same bytes as fromString
+		cout << "TEST 16..." << flush;
+		bool result = true;
+		{
+			MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema>();
+			mySchema->appendAtt(make_pair("suppkey", make_shared <MyDB_IntAttType>()));
+			mySchema->appendAtt(make_pair("name", make_shared <MyDB_StringAttType>()));
+			mySchema->appendAtt(make_pair("address", make_shared <MyDB_StringAttType>()));
+			mySchema->appendAtt(make_pair("nationkey", make_shared <MyDB_IntAttType>()));
+			mySchema->appendAtt(make_pair("phone", make_shared <MyDB_StringAttType>()));
+			mySchema->appendAtt(make_pair("acctbal", make_shared <MyDB_DoubleAttType>()));
+			mySchema->appendAtt(make_pair("comment", make_shared <MyDB_StringAttType>()));
+			MyDB_RecordPtr parsed = make_shared <MyDB_Record>(mySchema);
+			MyDB_RecordPtr expected = make_shared <MyDB_Record>(mySchema);
+
+			cout << "parse lines..." << flush;
+			ifstream myfile("supplier.tbl");
+			string line;
+			char lhs[1024], rhs[1024];
+			int counter = 0;
+			while (getline(myfile, line)) {
+				parsed->fromText(line.data(), line.data() + line.size());
+				expected->fromString(line);
+				parsed->toBinary(lhs);
+				expected->toBinary(rhs);
+				if (parsed->getBinarySize() != expected->getBinarySize() ||
+					memcmp(lhs, rhs, expected->getBinarySize()) != 0)
+					result = false;
+				counter++;
+			}
+			if (counter != 10000)
+				result = false;
+
+			cout << "parse odd values..." << flush;
+			MyDB_SchemaPtr otherSchema = make_shared <MyDB_Schema>();
+			otherSchema->appendAtt(make_pair("a", make_shared <MyDB_IntAttType>()));
+			otherSchema->appendAtt(make_pair("b", make_shared <MyDB_BoolAttType>()));
+			otherSchema->appendAtt(make_pair("c", make_shared <MyDB_StringAttType>()));
+			otherSchema->appendAtt(make_pair("d", make_shared <MyDB_DoubleAttType>()));
+			MyDB_RecordPtr other = make_shared <MyDB_Record>(otherSchema);
+
+			// no trailing bar, and the last field is immediately followed by more digits
+			string text = "-17|true||-2.5e3|99";
+			other->fromText(text.data(), text.data() + text.size() - 3);
+			if (other->getAtt(0)->toInt() != -17 || !other->getAtt(1)->toBool() ||
+				other->getAtt(2)->toString() != "" || other->getAtt(3)->toDouble() != -2500.0)
+				result = false;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 17:
+	{
+		// distinct value sketches are built on load, kept up to date on append, and saved in the catalog
+		cout << "TEST 17..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "check load estimates..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TablePtr table = allTables["supplier"];
+			MyDB_TableReaderWriter supplierTable(table, myMgr);
+			auto res = supplierTable.loadFromTextFile("supplier.tbl", 2);
+			if (res.second != 10000 || table->getTupleCount() != 10000 || res.first.size() != 7)
+				result = false;
+			else if (res.first[0] < 9500 || res.first[0] > 10500 || res.first[3] != 25)
+				result = false;
+			if (table->getDistinctValues("suppkey") != res.first[0])
+				result = false;
+
+			cout << "append more..." << flush;
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt();
+			vector <MyDB_RecordPtr> toAppend;
+			for (int i = 0; i < 10000 && myIter->advance(); i++) {
+				MyDB_RecordPtr rec = supplierTable.getEmptyRecord();
+				myIter->getCurrent(rec);
+				rec->getAtt(0)->fromInt(rec->getAtt(0)->toInt() + 10000);
+				rec->recordContentHasChanged();
+				toAppend.push_back(rec);
+			}
+			for (auto &rec : toAppend)
+				supplierTable.append(rec);
+			table->putInCatalog(myCatalog);
+		}
+		{
+			cout << "reload from catalog..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_TablePtr table = allTables["supplier"];
+			size_t est = table->getDistinctValues("suppkey");
+			if (table->getTupleCount() != 20000 || est < 19000 || est > 21000 || table->getDistinctValues("nationkey") != 25)
+				result = false;
+
+			// the sketches came back too, so they can keep being updated
+			table->changeSketches()[3].add(std::hash <int>()(1000));
+			if (table->getDistinctValues("nationkey") != 26)
+				result = false;
+
+			// just looking at the sketches leaves the counts alone
+			vector <size_t> counts(table->getSchema()->getAtts().size(), 1);
+			table->setDistinctValues(counts);
+			if (table->getSketches().size() != counts.size() || table->getDistinctValues("nationkey") != 1)
+				result = false;
+
+			// and sketches can be merged
+			MyDB_HyperLogLog lhs, rhs;
+			for (int i = 0; i < 5000; i++) {
+				lhs.add(std::hash <int>()(i));
+				rhs.add(std::hash <int>()(i + 2500));
+			}
+			lhs.merge(rhs);
+			if (lhs.estimate() < 7000 || lhs.estimate() > 8000)
+				result = false;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 18:
+	{
+		// histograms, min/max, and most common values are built on load and by analyze, and are saved in the catalog
+		cout << "TEST 18..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "load..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TablePtr table = allTables["supplier"];
+			MyDB_TableReaderWriter supplierTable(table, myMgr);
+			supplierTable.loadFromTextFile("supplier.tbl", 2);
+			table->putInCatalog(myCatalog);
+		}
+		{
+			cout << "check estimates..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_TablePtr table = allTables["supplier"];
+			vector <MyDB_AttStats> &stats = table->getAttStats();
+			if (stats.size() != 7 || stats[0].getMin() != "1" || stats[0].getMax() != "10000" ||
+				stats[1].getMin() != "Supplier#000000001" || stats[1].getMax() != "Supplier#000010000")
+				result = false;
+
+			// suppkey is uniform, so a tenth of the range has about a tenth of the tuples
+			double sel = table->estimateSelectivity("suppkey", "1", "1000");
+			if (sel < 0.08 || sel > 0.12)
+				result = false;
+			if (table->estimateSelectivity("suppkey", "20000", "30000") != 0.0)
+				result = false;
+
+			// each of the 25 nations is a most common value
+			sel = table->estimateSelectivity("nationkey", "3", "3");
+			if (stats[3].getMostCommon().size() != 10 || sel < 0.03 || sel > 0.05)
+				result = false;
+
+			// strings are handled too
+			sel = table->estimateSelectivity("name", "Supplier#000000001", "Supplier#000005000");
+			if (sel < 0.4 || sel > 0.6)
+				result = false;
+
+			if (!table->preferRangeScan("suppkey", "1", "100") || table->preferRangeScan("suppkey", "1", "9000"))
+				result = false;
+		}
+		{
+			cout << "analyze..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TablePtr table = allTables["supplier"];
+			MyDB_TableReaderWriter supplierTable(table, myMgr);
+
+			// add some records as raw bytes, which does not update the statistics, then analyze
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			string line = "20000|Supplier#000020000|address|3|phone|100.0|comment|";
+			temp->fromText(line.data(), line.data() + line.size());
+			for (int i = 0; i < 100; i++)
+				temp->toBinary(supplierTable.appendBytes(temp->getBinarySize()));
+			if (table->getTupleCount() != 10000 || table->getAttStats()[0].getMax() != "10000")
+				result = false;
+			supplierTable.analyze();
+			if (table->getTupleCount() != 10100 || table->getAttStats()[0].getMax() != "20000" ||
+				table->getDistinctValues("suppkey") < 9500 || table->getDistinctValues("suppkey") > 10500)
+				result = false;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 19:
+	{
+		// pages are slotted: records can be found by position, and sorting a page only moves the slots
+		cout << "TEST 19..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "fill page..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(allTables["supplier"], myMgr);
+			MyDB_PageReaderWriter page(true, *myMgr);
+
+			// write the records in decreasing suppkey order, until the page fills up
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			int numRecs = 0;
+			for (int i = 1000; i > 0; i--, numRecs++) {
+				temp->fromString(to_string(i) + "|Supplier#" + to_string(i) + "|a|3|p|1.5|c|");
+				if (!page.append(temp))
+					break;
+			}
+			if (numRecs < 5 || page.getNumRecords() != (size_t) numRecs)
+				result = false;
+
+			cout << "random access..." << flush;
+			for (int i = 0; i < numRecs; i++) {
+				page.getRecord(i, temp);
+				if (temp->getAtt(0)->toInt() != 1000 - i)
+					result = false;
+			}
+
+			cout << "sort..." << flush;
+			MyDB_RecordPtr lhs = supplierTable.getEmptyRecord();
+			MyDB_RecordPtr rhs = supplierTable.getEmptyRecord();
+			function <bool ()> comp = buildRecordComparator(lhs, rhs, "[suppkey]");
+			void *firstRec = page.getRecordPointer(0);
+			page.sortInPlace(comp, lhs, rhs);
+
+			// the record bytes did not move; the record that was first is now last
+			if (page.getRecordPointer(numRecs - 1) != firstRec)
+				result = false;
+			int expected = 1000 - numRecs + 1;
+			MyDB_RecordIteratorAltPtr myIter = page.getIteratorAlt();
+			while (myIter->advance()) {
+				myIter->getCurrent(temp);
+				if (temp->getAtt(0)->toInt() != expected++)
+					result = false;
+			}
+			if (expected != 1001)
+				result = false;
+
+			cout << "binary search..." << flush;
+			for (int i = 1000 - numRecs - 1; i <= 1001; i++) {
+				rhs->fromString(to_string(i) + "|a|b|1|c|2.5|d|");
+				size_t pos = page.lowerBound(comp, lhs);
+				int low = 1000 - numRecs + 1;
+				size_t correct = i < low ? 0 : (i > 1000 ? numRecs : i - low);
+				if (pos != correct)
+					result = false;
+			}
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 20:
+	{
+		// zone maps let predicated scans skip pages, and are saved next to the table
+		cout << "TEST 20..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "check zones..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TablePtr table = allTables["supplier"];
+			MyDB_TableReaderWriter supplierTable(table, myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+
+			// the file is sorted on suppkey, so only the first 1% or so of the pages can have a suppkey under 100
+			MyDB_ZoneMap &zones = table->getZoneMap();
+			int numPages = supplierTable.getNumPages(), mightHave = 0;
+			for (int i = 0; i < numPages; i++) {
+				if (zones.mightMatch(i, 0, true, false, false, 100.0))
+					mightHave++;
+			}
+			if (numPages < 100 || mightHave == 0 || mightHave > numPages / 50)
+				result = false;
+			if (zones.mightMatch(0, 1, false, true, false, string("Supplier#000009999")) ||
+				!zones.mightMatch(0, 1, false, true, false, string("Supplier#000000001")))
+				result = false;
+
+			cout << "conjuncts..." << flush;
+			vector <MyDB_SimpleComparison> conjuncts = temp->getSimpleConjuncts(
+				"&& (> ([suppkey], int[10]), && (< (double[20], [suppkey]), == ([name], string[a, (b)])))");
+			if (conjuncts.size() != 3 || !conjuncts[1].ifGreater || conjuncts[2].constVal != "a, (b)")
+				result = false;
+
+			cout << "filtered scans..." << flush;
+			vector <pair <string, int>> preds = {make_pair("< ([suppkey], int[100])", 99),
+				make_pair("&& (> ([suppkey], int[5000]), < ([suppkey], double[5010.5]))", 10),
+				make_pair("== ([name], string[Supplier#000000007])", 1)};
+			for (auto &pred : preds) {
+				int counter = 0;
+				MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt(pred.first);
+				while (myIter->advance())
+					counter++;
+				if (counter != pred.second)
+					result = false;
+			}
+
+			// records written as raw bytes are not seen, so that page can no longer be skipped
+			cout << "append bytes..." << flush;
+			temp->fromString("1|Supplier#000000001|a|3|p|1.5|c|");
+			temp->toBinary(supplierTable.appendBytes(temp->getBinarySize()));
+			int counter = 0;
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt("< ([suppkey], int[100])");
+			while (myIter->advance())
+				counter++;
+			if (counter != 100)
+				result = false;
+
+			// and neither are records written to a page from operator []
+			cout << "rewrite page..." << flush;
+			MyDB_PageReaderWriter page = supplierTable[numPages / 2];
+			page.clear();
+			temp->fromString("2|Supplier#000000002|a|3|p|1.5|c|");
+			page.append(temp);
+			counter = 0;
+			myIter = supplierTable.getIteratorAlt("< ([suppkey], int[100])");
+			while (myIter->advance())
+				counter++;
+			if (counter != 101)
+				result = false;
+			table->putInCatalog(myCatalog);
+		}
+		{
+			cout << "reload..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TablePtr table = allTables["supplier"];
+			MyDB_TableReaderWriter supplierTable(table, myMgr);
+			int last = supplierTable.getNumPages() - 1;
+			if (!table->getZoneMap().mightMatch(last, 0, true, false, false, 100.0) ||
+				table->getZoneMap().mightMatch(last - 1, 0, true, false, false, 100.0))
+				result = false;
+
+			// analyze sees everything
+			supplierTable.analyze();
+			if (table->getZoneMap().mightMatch(last, 0, false, false, true, 10000.0))
+				result = false;
+			table->putInCatalog(myCatalog);
+		}
+		{
+			// a record appended after the zone map was saved (which the buffer manager still writes out)
+			cout << "append without saving..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(MyDB_Table::getAllTables(myCatalog)["supplier"], myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			temp->fromString("20000|Supplier#000020000|a|3|p|1.5|c|");
+			supplierTable.append(temp);
+		}
+		{
+			// is still found later on, since the saved zone map is out of date
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(MyDB_Table::getAllTables(myCatalog)["supplier"], myMgr);
+			int counter = 0;
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt("> ([suppkey], int[15000])");
+			while (myIter->advance())
+				counter++;
+			if (counter != 1)
+				result = false;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 21:
+	{
+		// PAX tables hold the same records as regular tables, and can be scanned a column at a time
+		cout << "TEST 21..." << flush;
+		initialize();
+		bool result = true;
+		{
+			cout << "load PAX table..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TablePtr table = allTables["supplier"];
+			MyDB_TablePtr paxTable = make_shared <MyDB_Table>("supplierPax", "supplierPax.bin", table->getSchema(), "pax", "none");
+			MyDB_TableReaderWriter supplierTable(table, myMgr);
+			MyDB_TableReaderWriter paxSupplierTable(paxTable, myMgr);
+			paxSupplierTable.loadFromTextFile("supplier.tbl", 2);
+
+			// the minipage directory takes up a good part of these tiny pages, so a few more are needed
+			if (paxSupplierTable[0].getType() != MyDB_PageType::PaxPage || 
+				paxSupplierTable.getNumPages() > supplierTable.getNumPages() * 5 / 4)
+				result = false;
+
+			cout << "compare records..." << flush;
+			MyDB_RecordPtr rec = supplierTable.getEmptyRecord();
+			MyDB_RecordPtr paxRec = paxSupplierTable.getEmptyRecord();
+			MyDB_RecordIteratorAltPtr myIter = supplierTable.getIteratorAlt();
+			MyDB_RecordIteratorAltPtr paxIter = paxSupplierTable.getIteratorAlt();
+			int counter = 0;
+			while (myIter->advance()) {
+				myIter->getCurrent(rec);
+				if (!paxIter->advance())
+					result = false;
+				paxIter->getCurrent(paxRec);
+				ostringstream lhs, rhs;
+				lhs << rec;
+				rhs << paxRec;
+				if (lhs.str() != rhs.str())
+					result = false;
+				counter++;
+			}
+			if (counter != 10000 || paxIter->advance())
+				result = false;
+
+			// the fast path for predicates works on the rebuilt records
+			counter = 0;
+			paxIter = paxSupplierTable.getIteratorAlt("< ([suppkey], int[100])");
+			while (paxIter->advance())
+				counter++;
+			if (counter != 99)
+				result = false;
+
+			cout << "column scans..." << flush;
+			for (MyDB_TableReaderWriter *scanMe : {&supplierTable, &paxSupplierTable}) {
+				MyDB_ColumnIteratorPtr cols = scanMe->getColumnIterator({"acctbal", "nationkey", "name"});
+				double total = 0.0;
+				int numRows = 0, nationThree = 0;
+				while (cols->advance()) {
+					MyDB_ColumnBatch &batch = cols->getCurrent();
+					double *acctbal = batch.getDoubles(0);
+					int *nationkey = batch.getInts(1);
+					for (size_t i = 0; i < batch.getNumRows(); i++) {
+						total += acctbal[i];
+						nationThree += (nationkey[i] == 3);
+						if (batch.getValue(1, i).toInt() != nationkey[i])
+							result = false;
+					}
+					numRows += batch.getNumRows();
+					if (string(batch.getValue(2, 0).getChars()).find("Supplier#") != 0)
+						result = false;
+				}
+				if (numRows != 10000 || nationThree != 412 || total < 44000000 || total > 46000000)
+					result = false;
+			}
+			paxTable->putInCatalog(myCatalog);
+		}
+		{
+			cout << "append..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter paxSupplierTable(allTables["supplierPax"], myMgr);
+			MyDB_RecordPtr temp = paxSupplierTable.getEmptyRecord();
+			for (int i = 0; i < 1000; i++) {
+				temp->fromString(to_string(10001 + i) + "|Supplier#" + to_string(10001 + i) + "|a|3|p|1.5|c|");
+				paxSupplierTable.append(temp);
+			}
+			MyDB_TypedRecord <int, string, string, int, string, double, string> typed;
+			typed.fromString("20000|Supplier#20000|address|3|phone|2.5|comment|");
+			paxSupplierTable.append(typed);
+
+			int counter = 0, lastKey = 0;
+			MyDB_RecordIteratorPtr myIter = paxSupplierTable.getIterator(temp);
+			while (myIter->hasNext()) {
+				myIter->getNext();
+				if (temp->getAtt(0)->toInt() <= lastKey)
+					result = false;
+				lastKey = temp->getAtt(0)->toInt();
+				counter++;
+			}
+			if (counter != 11001 || lastKey != 20000 || temp->getAtt(5)->toDouble() != 2.5)
+				result = false;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 22:
+	{
+		// a compressed table holds the same records as a regular one, but reads and writes fewer bytes
+		cout << "TEST 22..." << flush;
+		initialize();
+		bool result = true;
+		unlink("supplierPlain.bin");
+		unlink("supplierLZ.bin");
+		unlink("supplierLZ.bin.pagemap");
+		vector <string> names = {"supplierPlain", "supplierLZ"};
+		size_t bytesWritten[2], bytesRead[2];
+		{
+			cout << "load tables..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			MyDB_SchemaPtr mySchema = MyDB_Table::getAllTables(myCatalog)["supplier"]->getSchema();
+			for (int i = 0; i < 2; i++) {
+				MyDB_TablePtr table = make_shared <MyDB_Table>(names[i], names[i] + ".bin", mySchema);
+				table->setCompressed(i == 1);
+				MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(8192, 16, "tempFile");
+				MyDB_TableReaderWriter loadMe(table, myMgr);
+				loadMe.loadFromTextFile("supplier.tbl");
+				bytesWritten[i] = myMgr->getBytesWritten();
+				table->putInCatalog(myCatalog);
+			}
+		}
+		{
+			cout << "compare records..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			if (allTables["supplierPlain"]->isCompressed() || !allTables["supplierLZ"]->isCompressed())
+				result = false;
+			vector <string> allRecs;
+			for (int i = 0; i < 2; i++) {
+				MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(8192, 16, "tempFile");
+				MyDB_TableReaderWriter scanMe(allTables[names[i]], myMgr);
+				MyDB_RecordPtr rec = scanMe.getEmptyRecord();
+				MyDB_RecordIteratorAltPtr myIter = scanMe.getIteratorAlt();
+				size_t counter = 0;
+				while (myIter->advance()) {
+					myIter->getCurrent(rec);
+					ostringstream out;
+					out << rec;
+					if (i == 0)
+						allRecs.push_back(out.str());
+					else if (counter >= allRecs.size() || allRecs[counter] != out.str())
+						result = false;
+					counter++;
+				}
+				if (counter != 10000)
+					result = false;
+				bytesRead[i] = myMgr->getBytesRead();
+			}
+			if (bytesWritten[1] > bytesWritten[0] * 3 / 4 || bytesRead[1] > bytesRead[0] * 3 / 4)
+				result = false;
+		}
+		{
+			// pages that grow get moved to a bigger spot in the file
+			cout << "append..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			MyDB_TablePtr table = MyDB_Table::getAllTables(myCatalog)["supplierLZ"];
+			{
+				MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(8192, 16, "tempFile");
+				MyDB_TableReaderWriter appendMe(table, myMgr);
+				MyDB_RecordPtr temp = appendMe.getEmptyRecord();
+				for (int i = 0; i < 1000; i++) {
+					temp->fromString(to_string(10001 + i) + "|Supplier#" + to_string(10001 + i) + "|a|3|p|1.5|c|");
+					appendMe.append(temp);
+				}
+				table->putInCatalog(myCatalog);
+			}
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(8192, 16, "tempFile");
+			MyDB_TableReaderWriter scanMe(table, myMgr);
+			MyDB_RecordPtr temp = scanMe.getEmptyRecord();
+			MyDB_RecordIteratorPtr myIter = scanMe.getIterator(temp);
+			int counter = 0, lastKey = 0;
+			while (myIter->hasNext()) {
+				myIter->getNext();
+				if (temp->getAtt(0)->toInt() <= lastKey)
+					result = false;
+				lastKey = temp->getAtt(0)->toInt();
+				counter++;
+			}
+			if (counter != 11000 || lastKey != 11000)
+				result = false;
+		}
+		{
+			// the list of extents is kept up to date as pages move, so the file can be opened again
+			// without the first compressed file ever saving it
+			cout << "reopen..." << flush;
+			unlink("extents.bin");
+			unlink("extents.bin.pagemap");
+			int fd = open("extents.bin", O_CREAT | O_RDWR, 0666);
+			vector <vector <char>> pages(8, vector <char>(1024, 0));
+			MyDB_CompressedFile writeMe(fd, "extents.bin.pagemap", 1024);
+			unsigned int seed = 1;
+			for (int round = 0; round < 3; round++) {
+				for (size_t i = 0; i < pages.size(); i++) {
+					// bytes that don't compress, so that each round the pages grow and move around
+					size_t numBytes = 100 + round * 300 + ((i * 37) % 5) * 20;
+					for (size_t j = 0; j < numBytes; j++) {
+						seed = seed * 1103515245 + 12345;
+						pages[i][j] = (char) (seed >> 16);
+					}
+					writeMe.writePage(i, pages[i].data());
+				}
+			}
+			pages[3].assign(1024, 0);
+			writeMe.writePage(3, pages[3].data());
+			MyDB_CompressedFile readMe(fd, "extents.bin.pagemap", 1024);
+			vector <char> bytes(1024);
+			for (size_t i = 0; i < pages.size(); i++) {
+				readMe.readPage(i, bytes.data());
+				if (bytes != pages[i])
+					result = false;
+			}
+			close(fd);
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
+	case 23:
+	{
+		// a dictionary-encoded table holds the same records as a regular one, in less space
+		cout << "TEST 23..." << flush;
+		initialize();
+		bool result = true;
+		unlink("nationsPlain.bin");
+		unlink("nationsDict.bin");
+		unlink("nationsSorted.bin");
+		{
+			// write out the supplier's nation along with its key
+			vector <string> nations = {"ALGERIA", "ARGENTINA", "BRAZIL", "CANADA", "EGYPT", "ETHIOPIA", "FRANCE",
+				"GERMANY", "INDIA", "INDONESIA", "IRAN", "IRAQ", "JAPAN", "JORDAN", "KENYA", "MOROCCO", "MOZAMBIQUE",
+				"PERU", "CHINA", "ROMANIA", "SAUDI ARABIA", "VIETNAM", "RUSSIA", "UNITED KINGDOM", "UNITED STATES"};
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(1024, 16, "tempFile");
+			MyDB_TableReaderWriter supplierTable(MyDB_Table::getAllTables(myCatalog)["supplier"], myMgr);
+			MyDB_RecordPtr temp = supplierTable.getEmptyRecord();
+			MyDB_RecordIteratorPtr myIter = supplierTable.getIterator(temp);
+			ofstream out("supplierNations.tbl");
+			while (myIter->hasNext()) {
+				myIter->getNext();
+				int nationKey = temp->getAtt(3)->toInt();
+				out << temp->getAtt(0)->toInt() << "|" << nations[nationKey] << "|" << nationKey << "|" <<
+					temp->getAtt(5)->toString() << "|\n";
+			}
+		}
+		vector <string> names = {"nationsPlain", "nationsDict"};
+		{
+			cout << "load tables..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			for (int i = 0; i < 2; i++) {
+				MyDB_SchemaPtr mySchema = make_shared <MyDB_Schema>();
+				mySchema->appendAtt(make_pair("suppkey", make_shared <MyDB_IntAttType>()));
+				if (i == 0) {
+					mySchema->appendAtt(make_pair("nation", make_shared <MyDB_StringAttType>()));
+					mySchema->appendAtt(make_pair("nationkey", make_shared <MyDB_IntAttType>()));
+				} else {
+					mySchema->appendAtt(make_pair("nation", make_shared <MyDB_DictAttType>(false)));
+					mySchema->appendAtt(make_pair("nationkey", make_shared <MyDB_DictAttType>(true)));
+				}
+				mySchema->appendAtt(make_pair("acctbal", make_shared <MyDB_DoubleAttType>()));
+				MyDB_TablePtr table = make_shared <MyDB_Table>(names[i], names[i] + ".bin", mySchema);
+				MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(8192, 16, "tempFile");
+				MyDB_TableReaderWriter loadMe(table, myMgr);
+				loadMe.loadFromTextFile("supplierNations.tbl", 4);
+				table->putInCatalog(myCatalog);
+			}
+		}
+		{
+			cout << "compare records..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			map <string, MyDB_TablePtr> allTables = MyDB_Table::getAllTables(myCatalog);
+			if (allTables["nationsDict"]->lastPage() >= allTables["nationsPlain"]->lastPage())
+				result = false;
+			MyDB_DictionaryPtr nationDict = allTables["nationsDict"]->getSchema()->getAtts()[1].second->getDictionary();
+			if (nationDict == nullptr || nationDict->size() != 25 || !nationDict->isOrdered())
+				result = false;
+			for (string att : {"nation", "nationkey"})
+				if (allTables["nationsDict"]->getDistinctValues(att) != allTables["nationsPlain"]->getDistinctValues(att))
+					result = false;
+
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(8192, 16, "tempFile");
+			MyDB_TableReaderWriter plainTable(allTables["nationsPlain"], myMgr);
+			MyDB_TableReaderWriter dictTable(allTables["nationsDict"], myMgr);
+			vector <string> allRecs;
+			MyDB_RecordPtr rec = plainTable.getEmptyRecord();
+			MyDB_RecordIteratorAltPtr myIter = plainTable.getIteratorAlt();
+			while (myIter->advance()) {
+				myIter->getCurrent(rec);
+				ostringstream out;
+				out << rec;
+				allRecs.push_back(out.str());
+			}
+			rec = dictTable.getEmptyRecord();
+			myIter = dictTable.getIteratorAlt();
+			size_t counter = 0;
+			while (myIter->advance()) {
+				myIter->getCurrent(rec);
+				ostringstream out;
+				out << rec;
+				if (counter >= allRecs.size() || allRecs[counter] != out.str())
+					result = false;
+				counter++;
+			}
+			if (counter != 10000 || allRecs.size() != 10000)
+				result = false;
+
+			// the predicates are checked on the codes
+			if (rec->compileBinaryPredicate("< ([nation], string[CHINA])") == nullptr)
+				result = false;
+			vector <string> preds = {"== ([nation], string[FRANCE])", "< ([nation], string[CHINA])",
+				"> (string[JAPAN], [nation])", "== ([nation], string[ATLANTIS])", "!= ([nation], string[ATLANTIS])",
+				"&& (> ([nationkey], int[5]), < ([nationkey], double[9.5]))", "== ([nation], [nation])"};
+			for (string &pred : preds) {
+				size_t counts[2] = {0, 0};
+				MyDB_TableReaderWriter *tables[2] = {&plainTable, &dictTable};
+				for (int i = 0; i < 2; i++) {
+					myIter = tables[i]->getIteratorAlt(pred);
+					while (myIter->advance())
+						counts[i]++;
+				}
+				if (counts[0] != counts[1] || (pred.find("ATLANTIS") == string::npos && counts[0] == 0))
+					result = false;
+			}
+
+			// the column iterator gives the codes
+			long plainSum = 0, dictSum = 0;
+			MyDB_ColumnIteratorPtr plainCols = plainTable.getColumnIterator({"nationkey"});
+			while (plainCols->advance())
+				for (size_t i = 0; i < plainCols->getCurrent().getNumRows(); i++)
+					plainSum += plainCols->getCurrent().getInts(0)[i];
+			MyDB_ColumnIteratorPtr dictCols = dictTable.getColumnIterator({"nationkey"});
+			while (dictCols->advance()) {
+				MyDB_ColumnBatch &batch = dictCols->getCurrent();
+				for (size_t i = 0; i < batch.getNumRows(); i++)
+					dictSum += batch.getDictionary(0)->getValue(batch.getInts(0)[i]).toInt();
+			}
+			if (plainSum != dictSum || plainSum == 0)
+				result = false;
+		}
+		{
+			// a value added after the load gets the next code, so the codes are no longer in order
+			cout << "append..." << flush;
+			MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog>("catFile");
+			MyDB_TablePtr table = MyDB_Table::getAllTables(myCatalog)["nationsDict"];
+			MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager>(8192, 16, "tempFile");
+			MyDB_TableReaderWriter dictTable(table, myMgr);
+			MyDB_RecordPtr temp = dictTable.getEmptyRecord();
+			temp->fromString("10001|ATLANTIS|30|1.5|");
+			dictTable.append(temp);
+			MyDB_DictionaryPtr nationDict = table->getSchema()->getAtts()[1].second->getDictionary();
+			if (nationDict->size() != 26 || nationDict->isOrdered())
+				result = false;
+
+			// the largest value (which is the last key in a B+-Tree) decodes, and comes after all of the others
+			vector <pair <string, MyDB_AttTypePtr>> &atts = table->getSchema()->getAtts();
+			MyDB_DictAttValPtr maxNation = dynamic_pointer_cast <MyDB_DictAttVal>(atts[1].second->createAttMax());
+			if (maxNation->toString() != "~~~~~~~~~" || atts[2].second->createAttMax()->toInt() != INT_MAX)
+				result = false;
+			if (nationDict->compare(maxNation->getCode(), nationDict->getCode(MyDB_Value::fromString("ATLANTIS", 8))) <= 0)
+				result = false;
+
+			// values can be added by many threads at once
+			vector <thread> threads;
+			vector <bool> threadOK(4, true);
+			for (int i = 0; i < 4; i++) {
+				threads.push_back(thread([&, i] {
+					MyDB_AttValPtr val = atts[1].second->createAtt();
+					for (int j = 0; j < 100; j++) {
+						string name = "T" + to_string(i) + "_" + to_string(j);
+						val->fromString(name);
+						if (val->toString() != name)
+							threadOK[i] = false;
+					}
+				}));
+			}
+			for (thread &t : threads)
+				t.join();
+			if (nationDict->size() != 426 || threadOK != vector <bool>(4, true))
+				result = false;
+
+			size_t counts[3] = {0, 0, 0};
+			vector <string> preds = {"== ([nation], string[ATLANTIS])", "< ([nation], string[BRAZIL])", "> ([nationkey], int[24])"};
+			for (int i = 0; i < 3; i++) {
+				MyDB_RecordIteratorAltPtr myIter = dictTable.getIteratorAlt(preds[i]);
+				while (myIter->advance())
+					counts[i]++;
+			}
+			myCatalog = make_shared <MyDB_Catalog>("catFile");
+			MyDB_BufferManagerPtr plainMgr = make_shared <MyDB_BufferManager>(8192, 16, "tempFile");
+			MyDB_TableReaderWriter plainTable(MyDB_Table::getAllTables(myCatalog)["nationsPlain"], plainMgr);
+			size_t plainCount = 0;
+			MyDB_RecordIteratorAltPtr myIter = plainTable.getIteratorAlt("< ([nation], string[BRAZIL])");
+			while (myIter->advance())
+				plainCount++;
+			if (counts[0] != 1 || counts[1] != plainCount + 1 || counts[2] != 1)
+				result = false;
+
+			// and sorting on the attribute still gives the values in order
+			MyDB_TablePtr sortedTable = make_shared <MyDB_Table>("nationsSorted", "nationsSorted.bin", table->getSchema());
+			MyDB_TableReaderWriter sortIntoMe(sortedTable, myMgr);
+			sort(8, dictTable, sortIntoMe, make_shared <MyDB_SortKey>(table->getSchema(), vector <string> {"nation", "suppkey"}));
+			string lastNation;
+			size_t counter = 0;
+			myIter = sortIntoMe.getIteratorAlt();
+			while (myIter->advance()) {
+				myIter->getCurrent(temp);
+				if (temp->getAtt(1)->toString() < lastNation)
+					result = false;
+				lastNation = temp->getAtt(1)->toString();
+				counter++;
+			}
+			if (counter != 10001)
+				result = false;
+		}
+		if (result) cout << "CORRECT" << endl << flush;
+		else cout << "***FAIL***" << endl << flush;
+		QUNIT_IS_TRUE(result);
+	}
+	FALLTHROUGH_INTENDED;
 	default:
 		break;
 	}
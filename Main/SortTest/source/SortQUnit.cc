@@ -81,6 +81,33 @@ int main () {
 
 	}
 
+	{
+		// load the same file using four threads; we get the same records, though not in the same order
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+		MyDB_TablePtr threadedTable = make_shared <MyDB_Table> ("supplierThreaded", "supplierThreaded.bin", 
+			allTables["supplier"]->getSchema ());
+		MyDB_TableReaderWriter threadedSupplierTable (threadedTable, myMgr);
+		threadedSupplierTable.loadFromTextFile ("supplierBig.tbl", 4);
+
+		// the sum of the keys is the same
+		MyDB_RecordPtr temp = supplierTable.getEmptyRecord ();
+		long long sums[2] = {0, 0};
+		int counts[2] = {0, 0};
+		MyDB_RecordIteratorAltPtr iters[2] = {supplierTable.getIteratorAlt (), threadedSupplierTable.getIteratorAlt ()};
+		for (int i = 0; i < 2; i++) {
+			while (iters[i]->advance ()) {
+				iters[i]->getCurrent (temp);
+				sums[i] += temp->getAtt (0)->toInt ();
+				counts[i]++;
+			}
+		}
+		QUNIT_IS_EQUAL (counts[1], 320000);
+		QUNIT_IS_EQUAL (sums[0], sums[1]);
+	}
+
 	{
 
 		// load up the table supplier table from the catalog
@@ -148,6 +175,44 @@ int main () {
 		outTable->putInCatalog (myCatalog);
 	}
 
+	{
+		// now sort again, using normalized keys, and make sure we get the same order as above
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+		MyDB_TableReaderWriter supplierTable (allTables["supplier"], myMgr);
+		MyDB_TableReaderWriter sortedTable (allTables["supplierSorted"], myMgr);
+
+		MyDB_TablePtr outTable = make_shared <MyDB_Table> ("supplierKeySorted", 
+			"supplierKeySorted.bin", allTables["supplier"]->getSchema ());
+		MyDB_TableReaderWriter outputTable (outTable, myMgr);
+
+		MyDB_SortKeyPtr sortKey = make_shared <MyDB_SortKey> (supplierTable.getEmptyRecord ()->getSchema (), 
+			vector <string> {"acctbal"});
+		system ("date");
+		sort (64, supplierTable, outputTable, sortKey);
+		system ("date");
+
+		MyDB_RecordPtr rec1 = outputTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = sortedTable.getEmptyRecord ();
+		function <bool ()> myComp = buildRecordComparator (rec1, rec2, "[acctbal]");
+                MyDB_RecordIteratorAltPtr myIterOne = outputTable.getIteratorAlt ();
+                MyDB_RecordIteratorAltPtr myIterTwo = sortedTable.getIteratorAlt ();
+		int matches = 0;
+                while (myIterOne->advance ()) {
+			myIterTwo->advance ();
+                        myIterOne->getCurrent (rec1);
+                        myIterTwo->getCurrent (rec2);
+			if (!myComp ()) {
+                        	myIterOne->getCurrent (rec2);
+                        	myIterTwo->getCurrent (rec1);
+				if (!myComp ())
+					matches++;
+			}
+                }
+                QUNIT_IS_EQUAL (matches, 320000);
+	}
+
 	{
 
 		// load up the two tables from the catalog
@@ -192,6 +257,41 @@ int main () {
 
                 QUNIT_IS_EQUAL (matches, 320000);
 	}
+
+	{
+		// a PAX table can be sorted too, both ways, and with a predicate
+		MyDB_CatalogPtr myCatalog = make_shared <MyDB_Catalog> ("catFile");
+		map <string, MyDB_TablePtr> allTables = MyDB_Table :: getAllTables (myCatalog);
+		MyDB_BufferManagerPtr myMgr = make_shared <MyDB_BufferManager> (131072, 128, "tempFile");
+		MyDB_SchemaPtr mySchema = allTables["supplier"]->getSchema ();
+		MyDB_TablePtr paxTable = make_shared <MyDB_Table> ("supplierPax", "supplierPax.bin", mySchema, "pax", "none");
+		MyDB_TableReaderWriter paxSupplierTable (paxTable, myMgr);
+		paxSupplierTable.loadFromTextFile ("supplier.tbl");
+
+		MyDB_RecordPtr rec1 = paxSupplierTable.getEmptyRecord ();
+		MyDB_RecordPtr rec2 = paxSupplierTable.getEmptyRecord ();
+		function <bool ()> myComp = buildRecordComparator (rec1, rec2, "[acctbal]");
+		MyDB_SortKeyPtr sortKey = make_shared <MyDB_SortKey> (mySchema, vector <string> {"acctbal"});
+		vector <MyDB_RecordIteratorAltPtr> iters {buildItertorOverSortedRuns (4, paxSupplierTable, myComp, rec1, rec2),
+			buildItertorOverSortedRuns (4, paxSupplierTable, myComp, rec1, rec2, "< ([acctbal], double[0.0])"),
+			buildItertorOverSortedRuns (4, paxSupplierTable, sortKey)};
+		vector <int> counts;
+		for (MyDB_RecordIteratorAltPtr myIter : iters) {
+			int counter = 0;
+			double last = -1e10;
+			while (myIter->advance ()) {
+				myIter->getCurrent (rec1);
+				if (rec1->getAtt (5)->toDouble () < last)
+					break;
+				last = rec1->getAtt (5)->toDouble ();
+				counter++;
+			}
+			counts.push_back (counter);
+		}
+		QUNIT_IS_EQUAL (counts[0], 10000);
+		QUNIT_IS_EQUAL (counts[1], 886);
+		QUNIT_IS_EQUAL (counts[2], 10000);
+	}
 }
 
 #endif